@@ -0,0 +1,91 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file bench.h
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Timing of host benchmarks. Each benchmark is run several times and
+ *        the fastest run is reported, to leave out the time the host spent
+ *        elsewhere. Host times show relative costs and regressions, the
+ *        Cortex-M3 has no FPU and no cache so absolute times differ.
+ */
+
+#ifndef TC_BENCH_H
+#define TC_BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_RUNS 5
+
+/**
+ * A piece of code to time, called iterations times per run.
+ */
+typedef struct {
+  const char *name;
+  void (*run)(void *context, uint32_t iterations);
+  void *context;
+  uint32_t iterations;
+} bench_t;
+
+/**
+* @return Host monotonic time (nanoseconds).
+*/
+static inline uint64_t bench_now_ns(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/**
+* @brief Time a benchmark.
+* @param [in] bench Benchmark to run.
+* @return Fastest time per iteration (nanoseconds).
+*/
+static inline double bench_time(const bench_t *bench) {
+  uint64_t start, elapsed, best = 0;
+  int i;
+
+  // Warm the cache and branch predictors first
+  bench->run(bench->context, bench->iterations / 10 + 1);
+  for (i = 0; i < BENCH_RUNS; i++) {
+    start = bench_now_ns();
+    bench->run(bench->context, bench->iterations);
+    elapsed = bench_now_ns() - start;
+    if (i == 0 || elapsed < best) {
+      best = elapsed;
+    }
+  }
+  return (double) best / bench->iterations;
+}
+
+/**
+* @brief Time a benchmark and print its time per iteration.
+* @param [in] bench Benchmark to run.
+* @return Fastest time per iteration (nanoseconds).
+*/
+static inline double bench_report(const bench_t *bench) {
+  double ns = bench_time(bench);
+
+  printf("  %-44s %10.1f ns/call\n", bench->name, ns);
+  return ns;
+}
+
+#endif  // TC_BENCH_H
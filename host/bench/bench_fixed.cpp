@@ -0,0 +1,184 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file bench_fixed.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Float and Q16.16 versions of the maths in the control path, side
+ *        by side. The whole control path is timed in both number formats
+ *        by bench_pipeline, which is built once per format.
+ *
+ * The host has a floating point unit, so float is far cheaper here than on
+ * the Cortex-M3, where every float operation is a soft-float library call
+ * of tens of cycles and the Q16 versions are a few integer instructions.
+ * Read the float/fixed ratio on the host as a lower bound.
+ */
+
+#include <math.h>
+#include "bench.h"
+#include "fixed.h"
+#include "tmath.h"
+
+#define INPUTS 256
+
+static float float_in[INPUTS];
+static q16_t fixed_in[INPUTS];
+static volatile float float_sink;
+static volatile q16_t fixed_sink;
+
+static void float_map(void *context, uint32_t iterations) {
+  float sum = 0;
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    sum += map(float_in[i % INPUTS], 1069.0f, 1895.0f, 0.0f, 100.0f);
+  }
+  float_sink = sum;
+}
+
+static void fixed_map(void *context, uint32_t iterations) {
+  q16_t sum = 0;
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    sum += q16_map(fixed_in[i % INPUTS], Q16(1069), Q16(1895), 0, Q16(100));
+  }
+  fixed_sink = sum;
+}
+
+static void float_clamp(void *context, uint32_t iterations) {
+  float sum = 0;
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    sum += clamp(float_in[i % INPUTS], 1100.0f, 1800.0f);
+  }
+  float_sink = sum;
+}
+
+static void fixed_clamp(void *context, uint32_t iterations) {
+  q16_t sum = 0;
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    sum += q16_clamp(fixed_in[i % INPUTS], Q16(1100), Q16(1800));
+  }
+  fixed_sink = sum;
+}
+
+static void float_normalize(void *context, uint32_t iterations) {
+  float sum = 0;
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    sum += normalize(float_in[i % INPUTS] - 1500.0f);
+  }
+  float_sink = sum;
+}
+
+static void fixed_normalize(void *context, uint32_t iterations) {
+  q16_t sum = 0;
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    sum += q16_normalize(fixed_in[i % INPUTS] - Q16(1500));
+  }
+  fixed_sink = sum;
+}
+
+/* One wheel of a mixing matrix row, three multiplies and adds */
+static void float_mix(void *context, uint32_t iterations) {
+  float sum = 0;
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    sum += 0.8660254f * float_in[i % INPUTS] + 0.5f * float_in[(i + 1) % INPUTS] +
+      float_in[(i + 2) % INPUTS];
+  }
+  float_sink = sum;
+}
+
+static void fixed_mix(void *context, uint32_t iterations) {
+  q16_t sum = 0;
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    sum += q16_add(q16_add(q16_mul(Q16(0.8660254), fixed_in[i % INPUTS]),
+      q16_mul(Q16(0.5), fixed_in[(i + 1) % INPUTS])), fixed_in[(i + 2) % INPUTS]);
+  }
+  fixed_sink = sum;
+}
+
+/* What the 3-wheel holonomic mode did before the mixing matrix: polar
+   coordinates in double precision, then back again */
+static void float_polar(void *context, uint32_t iterations) {
+  float sum = 0;
+  double x, y, angle, magnitude;
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    x = float_in[i % INPUTS] - 1500.0;
+    y = float_in[(i + 1) % INPUTS] - 1500.0;
+    angle = atan2(y, x);
+    magnitude = sqrt(x * x + y * y);
+    sum += (float) (magnitude * cos(angle) + magnitude * sin(angle));
+  }
+  float_sink = sum;
+}
+
+int main(void) {
+  static const struct {
+    const char *name;
+    void (*run)(void *context, uint32_t iterations);
+  } benches[] = {
+    {"map, float", float_map},
+    {"map, Q16", fixed_map},
+    {"clamp, float", float_clamp},
+    {"clamp, Q16", fixed_clamp},
+    {"normalize, float", float_normalize},
+    {"normalize, Q16", fixed_normalize},
+    {"mixing matrix row, float", float_mix},
+    {"mixing matrix row, Q16", fixed_mix},
+    {"polar round trip, double (old holonomic)", float_polar}
+  };
+  bench_t bench;
+  unsigned i;
+
+  for (i = 0; i < INPUTS; i++) {
+    float_in[i] = 1000.0f + (float) ((i * 37) % 1000);
+    fixed_in[i] = Q16(1000) + q16_from_int((int32_t) ((i * 37) % 1000));
+  }
+
+  bench.context = NULL;
+  bench.iterations = 1000000;
+  for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+    bench.name = benches[i].name;
+    bench.run = benches[i].run;
+    bench_report(&bench);
+  }
+  return 0;
+}
@@ -0,0 +1,119 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file bench_input_filter.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Cost of filtering and converting one frame of receiver widths, with
+ *        all 12 channels fresh, for each set of filter stages.
+ *
+ * Fails if a frame takes longer than FRAME_BUDGET_NS with every stage
+ * enabled, so a slower kernel shows up as a failed "make bench".
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "bench.h"
+#include "config.h"
+#include "rc_input.h"
+#include "types.h"
+
+/* Host budget per frame, about ten times the current cost, so a kernel that
+   has become an order of magnitude slower fails without host noise doing so */
+#define FRAME_BUDGET_NS 2000.0
+
+/* Number of different frames cycled through, one in 16 has a glitch */
+#define FRAMES 64
+
+static rc_raw_frame_t frames[FRAMES];
+static channel_limits_t limits[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS];
+static volatile int sink;
+
+typedef struct {
+  uint32_t stages;
+  bool convert;
+} filter_bench_t;
+
+static void run_frames(void *context, uint32_t iterations) {
+  const filter_bench_t *config = (const filter_bench_t *) context;
+  input_filter_t filter;
+  rc_raw_frame_t raw;
+  rc_frame_t controls;
+  uint32_t i;
+
+  input_filter_init(&filter, config->stages);
+  memset(&controls, 0x00, sizeof(controls));
+  for (i = 0; i < iterations; i++) {
+    if (config->convert) {
+      rc_input_update(&filter, &frames[i % FRAMES], limits, &controls);
+    } else {
+      raw = frames[i % FRAMES];
+      input_filter_run(&filter, &raw);
+      sink += raw.width_us[0][0];
+    }
+  }
+  sink += (int) controls.controller[1].channel[0];
+}
+
+int main(void) {
+  static const struct {
+    const char *name;
+    filter_bench_t config;
+  } benches[] = {
+    {"filter, no stages", {0, false}},
+    {"filter, range + step", {RC_FILTER_RANGE | RC_FILTER_STEP, false}},
+    {"filter, range + step + median", {RC_FILTER_RANGE | RC_FILTER_STEP | RC_FILTER_MEDIAN, false}},
+    {"filter, all stages", {RC_FILTER_RANGE | RC_FILTER_STEP | RC_FILTER_MEDIAN | RC_FILTER_IIR, false}},
+    {"filter + convert, RC_FILTER_STAGES", {RC_FILTER_STAGES, true}},
+    {"filter + convert, all stages", {RC_FILTER_RANGE | RC_FILTER_STEP | RC_FILTER_MEDIAN | RC_FILTER_IIR, true}}
+  };
+  bench_t bench;
+  double ns = 0;
+  unsigned i;
+  int controller, channel;
+
+  for (i = 0; i < FRAMES; i++) {
+    for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
+      frames[i].fresh[controller] = (1U << RC_NUMBER_CHANNELS) - 1;
+      for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
+        frames[i].width_us[controller][channel] =
+          (uint16_t) (1500 + ((i * 7 + channel * 13) % 40) - 20);
+        limits[controller][channel].min = 1000;
+        limits[controller][channel].max = 2000;
+      }
+    }
+    if (i % 16 == 5) {
+      frames[i].width_us[i % RC_NUMBER_CONTROLLERS][i % RC_NUMBER_CHANNELS] = 2900;
+    }
+  }
+
+  printf("  (per frame of %d channels)\n", RC_NUMBER_CONTROLLERS * RC_NUMBER_CHANNELS);
+  bench.iterations = 1000000;
+  for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+    bench.name = benches[i].name;
+    bench.run = run_frames;
+    bench.context = (void *) &benches[i].config;
+    ns = bench_report(&bench);
+  }
+
+  if (ns > FRAME_BUDGET_NS) {
+    printf("FAIL: %.1f ns per frame is over the %.1f ns budget\n", ns, FRAME_BUDGET_NS);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,122 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file bench_parser.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Command parser throughput: how long a burst of lines from the
+ *        ESP8266 takes to parse, and name lookup by perfect hash against the
+ *        prefix scan it replaced.
+ */
+
+#include <string.h>
+#include "bench.h"
+#include "command_parser.h"
+#include "return_codes.h"
+#include "tele_params.h"
+
+/* A mix of the lines the ESP8266 and USB console send, including a miss.
+   An unknown parameter is left out, command_generate() prints it. */
+static const char *burst[] = {
+  "status",
+  "get arm_status",
+  "set drive_rpm_1 1234.5",
+  "set drive_voltage_1 11.1",
+  "get cpu_idle",
+  "set failsafe_latency 100",
+  "arm",
+  "meta",
+  "unknown_command"
+};
+
+#define BURST_LEN (sizeof(burst) / sizeof(burst[0]))
+
+static volatile int sink;
+
+static void run_burst(void *context, uint32_t iterations) {
+  command_t command;
+  uint32_t i;
+  unsigned n;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    for (n = 0; n < BURST_LEN; n++) {
+      sink += command_generate(&command, burst[n]);
+    }
+  }
+}
+
+static void run_hash_lookup(void *context, uint32_t iterations) {
+  command_token_t token;
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    token.text = tele_commands[i % NUM_TELE_COMMANDS].name;
+    token.length = strlen(token.text);
+    sink += tele_param_find(&token);
+  }
+}
+
+/* How parameters were found before the name index, a strncmp over the
+   table, without the "Checking ..." print for each entry */
+static void run_scan_lookup(void *context, uint32_t iterations) {
+  const char *name;
+  uint32_t i, length;
+  unsigned n;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    name = tele_commands[i % NUM_TELE_COMMANDS].name;
+    length = strlen(name);
+    for (n = 0; n < NUM_TELE_COMMANDS; n++) {
+      if (strncmp(tele_commands[n].name, name, length) == 0) {
+        sink += n;
+        break;
+      }
+    }
+  }
+}
+
+int main(void) {
+  bench_t bench;
+  double ns;
+
+  if (command_parser_init() != RET_OK) {
+    printf("No perfect hash for command names\n");
+    return 1;
+  }
+
+  bench.context = NULL;
+  bench.name = "burst of lines, per line";
+  bench.run = run_burst;
+  bench.iterations = 20000;
+  ns = bench_time(&bench) / BURST_LEN;
+  printf("  %-44s %10.1f ns/call\n", bench.name, ns);
+  printf("  %-44s %10.1f us\n", "full command queue (COMMAND_QUEUE_LEN lines)",
+    ns * COMMAND_QUEUE_LEN / 1000.0);
+
+  bench.iterations = 1000000;
+  bench.name = "parameter lookup, perfect hash";
+  bench.run = run_hash_lookup;
+  bench_report(&bench);
+  bench.name = "parameter lookup, prefix scan";
+  bench.run = run_scan_lookup;
+  bench_report(&bench);
+  return 0;
+}
@@ -0,0 +1,171 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file bench_pipeline.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Time per call of each stage of the motor drive loop and of the
+ *        command parser, run against the host stand-ins.
+ */
+
+#include <string.h>
+#include "bench.h"
+#include "host_robot.h"
+#include "task_utils.h"
+#include "mixer.h"
+#include "drive_modes.h"
+#include "command_parser.h"
+#include "return_codes.h"
+#include "tmath.h"
+
+static thread_args_t targs;
+static rc_frame_t frame;
+static struct rc_outputs_t outputs;
+
+/* Sticks moving through their range, so the filters have work to do */
+static void bench_pulses(uint32_t i) {
+  uint16_t widths[RC_NUMBER_CHANNELS];
+  int controller, channel;
+
+  for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
+    for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
+      widths[channel] = (uint16_t) (1100 + ((i * 7 + channel * 97) % 800));
+    }
+    host_robot_pulses(&targs, controller, widths, (uint64_t) i * RC_FRAME_PERIOD_US);
+  }
+}
+
+static void bench_read_recv_pw(void *context, uint32_t iterations) {
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    read_recv_pw(&targs, &frame);
+  }
+}
+
+static void bench_read_recv_pw_fresh(void *context, uint32_t iterations) {
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    bench_pulses(i);
+    read_recv_pw(&targs, &frame);
+  }
+}
+
+static void bench_drive_mode(void *context, uint32_t iterations) {
+  const drive_mode_t *mode = (const drive_mode_t *) context;
+  uint32_t i;
+
+  for (i = 0; i < iterations; i++) {
+    frame.controller[1].channel[RC_1_ELEVATION] = RC_CHANNEL(i % 100);
+    mixer_drive(mode, &frame, &outputs);
+  }
+}
+
+static void bench_weapon_mode(void *context, uint32_t iterations) {
+  const weapon_mode_t *mode = (const weapon_mode_t *) context;
+  uint32_t i;
+
+  for (i = 0; i < iterations; i++) {
+    frame.controller[0].channel[RC_0_THROTTLE] = RC_CHANNEL(i % 100);
+    mode->weapon(&frame, &outputs);
+  }
+}
+
+static void bench_set_output_escs(void *context, uint32_t iterations) {
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    outputs.wheel[0] = (int) (i % 100);
+    set_output_escs(&targs, &outputs);
+  }
+}
+
+static void bench_command_generate(void *context, uint32_t iterations) {
+  const char *line = (const char *) context;
+  command_t command;
+  uint32_t i;
+
+  for (i = 0; i < iterations; i++) {
+    command_generate(&command, line);
+  }
+}
+
+int main(void) {
+  bench_t bench;
+  unsigned i;
+
+  host_robot_init(&targs);
+  if (command_parser_init() != RET_OK) {
+    printf("No perfect hash for command names\n");
+    return 1;
+  }
+
+  printf("Motor drive loop\n");
+  bench.name = "read_recv_pw, no new pulses";
+  bench.run = bench_read_recv_pw;
+  bench.context = NULL;
+  bench.iterations = 200000;
+  bench_report(&bench);
+
+  bench.name = "read_recv_pw, 12 new pulses (incl. capture)";
+  bench.run = bench_read_recv_pw_fresh;
+  bench_report(&bench);
+
+  for (i = 0; i < sizeof(drive_modes) / sizeof(drive_mode_t); i++) {
+    bench.name = (const char *) drive_modes[i].name;
+    bench.run = bench_drive_mode;
+    bench.context = (void *) &drive_modes[i];
+    bench_report(&bench);
+  }
+
+  for (i = 0; i < sizeof(weapon_modes) / sizeof(weapon_mode_t); i++) {
+    bench.name = (const char *) weapon_modes[i].name;
+    bench.run = bench_weapon_mode;
+    bench.context = (void *) &weapon_modes[i];
+    bench_report(&bench);
+  }
+
+  targs.state = STATE_FULLY_ARMED;
+  bench.name = "set_output_escs, fully armed";
+  bench.run = bench_set_output_escs;
+  bench.context = NULL;
+  bench_report(&bench);
+
+  targs.state = STATE_DISARMED;
+  bench.name = "set_output_escs, disarmed";
+  bench_report(&bench);
+
+  printf("Command parser\n");
+  bench.run = bench_command_generate;
+  bench.name = "command_generate \"arm\"";
+  bench.context = (void *) "arm";
+  bench_report(&bench);
+
+  bench.name = "command_generate \"get drive_rx_age\"";
+  bench.context = (void *) "get drive_rx_age";
+  bench_report(&bench);
+
+  bench.name = "command_generate \"set arm_status 3\"";
+  bench.context = (void *) "set arm_status 3";
+  bench_report(&bench);
+  return 0;
+}
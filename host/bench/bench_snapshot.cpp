@@ -0,0 +1,213 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file bench_snapshot.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Cost of sharing the controls and outputs of one motor drive loop
+ *        cycle, with a mutex around every field access as the loop used to
+ *        and with Snapshot (snapshot.h).
+ *
+ * The mutex version takes the locks the 3-wheel holonomic cycle took:
+ * 12 in read_recv_pw, 4 in the drive function, 2 in the weapon function
+ * and 2 in set_output_escs. Uncontended host mutexes are a few atomic
+ * operations, RTX mutexes are a supervisor call each, so the host
+ * understates the difference.
+ */
+
+#include <string.h>
+#include "bench.h"
+#include "mbed.h"
+#include "rtos.h"
+#include "snapshot.h"
+#include "types.h"
+
+static struct {
+  Mutex controls_mutex;
+  Mutex outputs_mutex;
+  rc_frame_t controls;
+  struct rc_outputs_t outputs;
+} locked;
+
+static struct {
+  Snapshot<rc_frame_t> controls;
+  Snapshot<struct rc_outputs_t> outputs;
+} published;
+
+static volatile bool reader_running;
+
+static void cycle_mutex(void *context, uint32_t iterations) {
+  control_t throttle, strafe, rotate, weapon;
+  uint32_t i;
+  int controller, channel;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    // read_recv_pw
+    for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
+      for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
+        locked.controls_mutex.lock();
+        locked.controls.controller[controller].channel[channel] = RC_CHANNEL(i % 100);
+        locked.controls_mutex.unlock();
+      }
+    }
+
+    // Drive function
+    locked.controls_mutex.lock();
+    throttle = locked.controls.controller[1].channel[RC_1_ELEVATION];
+    strafe = locked.controls.controller[1].channel[RC_1_AILERON];
+    rotate = locked.controls.controller[1].channel[RC_1_RUDDER];
+    locked.controls_mutex.unlock();
+    locked.outputs_mutex.lock();
+    locked.outputs.wheel[0] = (int) (throttle + strafe);
+    locked.outputs.wheel[1] = (int) (throttle - strafe);
+    locked.outputs.wheel[2] = (int) (throttle + rotate);
+    locked.outputs_mutex.unlock();
+    locked.controls_mutex.lock();
+    rotate = locked.controls.controller[1].channel[RC_1_RUDDER];
+    locked.controls_mutex.unlock();
+    locked.outputs_mutex.lock();
+    locked.outputs.wheel[0] += (int) rotate;
+    locked.outputs_mutex.unlock();
+
+    // Weapon function
+    locked.controls_mutex.lock();
+    weapon = locked.controls.controller[0].channel[RC_0_THROTTLE];
+    locked.controls_mutex.unlock();
+    locked.outputs_mutex.lock();
+    locked.outputs.weapon_motor_1 = (int) weapon;
+    locked.outputs_mutex.unlock();
+
+    // set_output_escs clamps, then sets the ESCs
+    locked.outputs_mutex.lock();
+    locked.outputs.wheel[0] = (locked.outputs.wheel[0] > 100) ? 100 : locked.outputs.wheel[0];
+    locked.outputs_mutex.unlock();
+    locked.outputs_mutex.lock();
+    locked.outputs.weapon_motor_2 = locked.outputs.weapon_motor_1;
+    locked.outputs_mutex.unlock();
+  }
+}
+
+static void cycle_snapshot(void *context, uint32_t iterations) {
+  rc_frame_t frame;
+  struct rc_outputs_t outputs;
+  uint32_t i;
+  int controller, channel;
+  (void) context;
+
+  memset(&outputs, 0x00, sizeof(outputs));
+  for (i = 0; i < iterations; i++) {
+    // read_recv_pw fills a local frame and publishes it once
+    for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
+      for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
+        frame.controller[controller].channel[channel] = RC_CHANNEL(i % 100);
+      }
+    }
+    published.controls.publish(frame);
+
+    // The drive and weapon functions use the same local frame
+    outputs.wheel[0] = (int) (frame.controller[1].channel[RC_1_ELEVATION] +
+      frame.controller[1].channel[RC_1_AILERON] + frame.controller[1].channel[RC_1_RUDDER]);
+    outputs.wheel[1] = (int) (frame.controller[1].channel[RC_1_ELEVATION] -
+      frame.controller[1].channel[RC_1_AILERON]);
+    outputs.wheel[2] = (int) (frame.controller[1].channel[RC_1_ELEVATION] +
+      frame.controller[1].channel[RC_1_RUDDER]);
+    outputs.weapon_motor_1 = (int) frame.controller[0].channel[RC_0_THROTTLE];
+
+    // set_output_escs clamps and publishes once
+    outputs.wheel[0] = (outputs.wheel[0] > 100) ? 100 : outputs.wheel[0];
+    outputs.weapon_motor_2 = outputs.weapon_motor_1;
+    published.outputs.publish(outputs);
+  }
+}
+
+static void read_mutex(void *context, uint32_t iterations) {
+  rc_frame_t frame;
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    locked.controls_mutex.lock();
+    frame = locked.controls;
+    locked.controls_mutex.unlock();
+  }
+  (void) frame;
+}
+
+static void read_snapshot(void *context, uint32_t iterations) {
+  rc_frame_t frame;
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    published.controls.read(&frame);
+  }
+}
+
+/* Another task copying the controls as fast as it can */
+static void reader(bench_t *bench) {
+  while (reader_running) {
+    bench->run(bench->context, 100);
+  }
+}
+
+static void run_with_reader(bench_t *bench, bench_t *background) {
+  Thread thread;
+
+  reader_running = true;
+  thread.start(callback(reader, background));
+  bench_report(bench);
+  reader_running = false;
+  Thread::wait(10);
+}
+
+int main(void) {
+  bench_t bench, background;
+
+  bench.context = NULL;
+  bench.iterations = 200000;
+  background.context = NULL;
+  background.iterations = 100;
+
+  printf("One motor drive cycle, uncontended\n");
+  bench.name = "mutex per field access (20 lock/unlock)";
+  bench.run = cycle_mutex;
+  bench_report(&bench);
+  bench.name = "Snapshot publish of controls and outputs";
+  bench.run = cycle_snapshot;
+  bench_report(&bench);
+
+  printf("One motor drive cycle, another thread reading the controls\n");
+  bench.name = "mutex per field access (20 lock/unlock)";
+  bench.run = cycle_mutex;
+  background.run = read_mutex;
+  run_with_reader(&bench, &background);
+  bench.name = "Snapshot publish of controls and outputs";
+  bench.run = cycle_snapshot;
+  background.run = read_snapshot;
+  run_with_reader(&bench, &background);
+
+  printf("Copy of the controls by a reader\n");
+  bench.name = "under the controls mutex";
+  bench.run = read_mutex;
+  bench_report(&bench);
+  bench.name = "Snapshot read";
+  bench.run = read_snapshot;
+  bench_report(&bench);
+  return 0;
+}
@@ -0,0 +1,187 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file bench_telemetry.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Bytes and time to send the telemetry table as binary frames, and as
+ *        the JSON message per parameter that task_stream_telemetry used to
+ *        print.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+#include "tele_codec.h"
+#include "tele_params.h"
+
+/* Bytes per second on the 115200 baud link to the ESP8266 */
+#define LINK_BYTES_PER_S 11520
+
+static tele_command_t params[NUM_TELE_COMMANDS];
+static tele_command_type_t types[NUM_TELE_COMMANDS];
+static tele_header_t header;
+static uint8_t encoded[TELE_ENCODED_MAX_LEN];
+static uint32_t encoded_len;
+static volatile uint32_t sink;
+
+/* One JSON message, as printed before the binary frames */
+static int json_message(char *buffer, uint32_t size, const tele_command_t *param) {
+  switch (param->type) {
+    case CT_FLOAT:
+      return snprintf(buffer, size,
+        "{\"id\": \"%d\", \"name\": \"%s\", \"type\": \"%s\", \"unit\": \"%s\", \"value\": \"%.2f\"}\r",
+        param->id, param->name, tele_command_type_to_string(param->type),
+        tele_command_unit_to_string(param->unit), param->param.f);
+    case CT_INT:
+      return snprintf(buffer, size,
+        "{\"id\": \"%d\", \"name\": \"%s\", \"type\": \"%s\", \"unit\": \"%s\", \"value\": \"%d\"}\r",
+        param->id, param->name, tele_command_type_to_string(param->type),
+        tele_command_unit_to_string(param->unit), param->param.i);
+    case CT_BOOLEAN:
+      return snprintf(buffer, size,
+        "{\"id\": \"%d\", \"name\": \"%s\", \"type\": \"%s\", \"unit\": \"%s\", \"value\": \"%s\"}\r",
+        param->id, param->name, tele_command_type_to_string(param->type),
+        tele_command_unit_to_string(param->unit), param->param.b ? "ON" : "OFF");
+    default:
+      return 0;
+  }
+}
+
+static uint32_t json_table(void) {
+  char buffer[128];
+  uint32_t bytes = 0;
+  unsigned i;
+
+  for (i = 0; i < NUM_TELE_COMMANDS; i++) {
+    bytes += json_message(buffer, sizeof(buffer), &params[i]);
+  }
+  return bytes;
+}
+
+static uint32_t binary_table(void) {
+  tele_frame_t frame;
+
+  tele_encode_values(&frame, header, params, NUM_TELE_COMMANDS);
+  return tele_frame_encode(&frame, encoded);
+}
+
+static void run_json(void *context, uint32_t iterations) {
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    sink += json_table();
+  }
+}
+
+static void run_binary(void *context, uint32_t iterations) {
+  uint32_t i;
+  (void) context;
+
+  for (i = 0; i < iterations; i++) {
+    sink += binary_table();
+  }
+}
+
+/* A delta frame with a single value past its deadband */
+static void run_delta(void *context, uint32_t iterations) {
+  tele_delta_t delta;
+  tele_frame_t frame;
+  uint32_t i;
+  (void) context;
+
+  tele_delta_init(&delta, 0xFFFFFFFF);
+  tele_encode_delta(&frame, header, &delta, params, NUM_TELE_COMMANDS);
+  for (i = 0; i < iterations; i++) {
+    params[CID_ARM_STATUS].param.i ^= 1;
+    tele_encode_delta(&frame, header, &delta, params, NUM_TELE_COMMANDS);
+    sink += tele_frame_encode(&frame, encoded);
+  }
+}
+
+static void run_decode(void *context, uint32_t iterations) {
+  tele_decoder_t decoder;
+  tele_frame_t frame;
+  tele_value_t values[NUM_TELE_COMMANDS];
+  uint32_t i, n;
+  (void) context;
+
+  tele_decoder_init(&decoder);
+  for (i = 0; i < iterations; i++) {
+    for (n = 0; n < encoded_len; n++) {
+      if (tele_decode_byte(&decoder, encoded[n], &frame)) {
+        sink += tele_decode_values(&frame, types, values, NUM_TELE_COMMANDS);
+      }
+    }
+  }
+}
+
+int main(void) {
+  static const struct {
+    const char *name;
+    void (*run)(void *context, uint32_t iterations);
+  } benches[] = {
+    {"every parameter, JSON", run_json},
+    {"every parameter, binary keyframe", run_binary},
+    {"one changed parameter, binary delta", run_delta},
+    {"decode binary keyframe", run_decode}
+  };
+  bench_t bench;
+  uint32_t json_bytes, binary_bytes;
+  unsigned i;
+
+  /* Values with a realistic number of digits rather than zeros, which
+     would flatter the varint encoding */
+  memcpy(params, tele_commands, sizeof(params));
+  for (i = 0; i < NUM_TELE_COMMANDS; i++) {
+    types[i] = params[i].type;
+    switch (params[i].type) {
+      case CT_FLOAT:
+        params[i].param.f = 1234.56f;
+        break;
+      case CT_INT:
+        params[i].param.i = 12345;
+        break;
+      case CT_BOOLEAN:
+        params[i].param.b = true;
+        break;
+      default:
+        break;
+    }
+  }
+  header.schema = tele_schema_id(params, NUM_TELE_COMMANDS);
+  header.sequence = 0;
+
+  json_bytes = json_table();
+  binary_bytes = binary_table();
+  encoded_len = binary_bytes;
+  printf("  %d parameters: %d bytes as JSON, %d bytes binary\n",
+    (int) NUM_TELE_COMMANDS, (int) json_bytes, (int) binary_bytes);
+  printf("  tables per second at 115200 baud: %d JSON, %d binary\n",
+    (int) (LINK_BYTES_PER_S / json_bytes), (int) (LINK_BYTES_PER_S / binary_bytes));
+
+  bench.context = NULL;
+  bench.iterations = 100000;
+  for (i = 0; i < sizeof(benches) / sizeof(benches[0]); i++) {
+    bench.name = benches[i].name;
+    bench.run = benches[i].run;
+    bench_report(&bench);
+  }
+  return 0;
+}
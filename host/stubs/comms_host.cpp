@@ -0,0 +1,55 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file comms_host.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Host ESC comms implementation.
+ */
+
+#include <string.h>
+#include "comms_host.h"
+
+comms_host_state_t comms_host_state;
+
+comms_impl_t comms_impl_host = {
+  .impl_id = COMMS_IMPL_HOST,
+  .str = "Host",
+  .init_comms = comms_impl_host_init_comms,
+  .init_esc = comms_init_esc,
+  .set_speed = comms_impl_host_set_speed,
+  .get_speed = NULL,
+  .get_status = NULL,
+  .stop = comms_impl_host_stop
+};
+
+void comms_impl_host_init_comms(void) {
+  memset(&comms_host_state, 0, sizeof(comms_host_state));
+}
+
+void comms_impl_host_set_speed(comms_esc_t *esc, uint32_t speed) {
+  comms_host_state.speed[esc->id] = speed;
+  comms_host_state.stopped[esc->id] = false;
+  comms_host_state.commands++;
+}
+
+void comms_impl_host_stop(comms_esc_t *esc) {
+  comms_host_state.speed[esc->id] = 0;
+  comms_host_state.stopped[esc->id] = true;
+  comms_host_state.commands++;
+}
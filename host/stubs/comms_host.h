@@ -0,0 +1,63 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file comms_host.h
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Host ESC comms implementation, records what the firmware would
+ *        have sent to each ESC.
+ */
+
+#ifndef TC_COMMS_HOST_H
+#define TC_COMMS_HOST_H
+
+#include "comms.h"
+
+//Make sure that IDs are unique when adding new comms implememnations!
+#define COMMS_IMPL_HOST 100
+
+#define COMMS_HOST_NUM_ESCS 6
+
+/**
+ * Last command sent to each ESC.
+ */
+typedef struct {
+  uint32_t speed[COMMS_HOST_NUM_ESCS];
+  bool stopped[COMMS_HOST_NUM_ESCS];
+  uint32_t commands;
+} comms_host_state_t;
+
+extern comms_impl_t comms_impl_host;
+extern comms_host_state_t comms_host_state;
+
+/**
+* @brief Forget every command sent so far.
+*/
+void comms_impl_host_init_comms(void);
+
+/**
+* @brief Record the speed of an ESC.
+*/
+void comms_impl_host_set_speed(comms_esc_t *esc, uint32_t speed);
+
+/**
+* @brief Record that an ESC was stopped.
+*/
+void comms_impl_host_stop(comms_esc_t *esc);
+
+#endif //TC_COMMS_HOST_H
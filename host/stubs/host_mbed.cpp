@@ -0,0 +1,437 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file host_mbed.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Host stand-ins for the ticker, serial ports, I2C bus and RTOS.
+ */
+
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sched.h>
+#include "mbed.h"
+#include "rtos.h"
+
+uint32_t SystemCoreClock = 96000000;
+CoreDebug_Type host_core_debug;
+LPC_WDT_TypeDef host_wdt;
+
+static pthread_mutex_t host_critical;
+static pthread_once_t host_critical_once = PTHREAD_ONCE_INIT;
+
+static volatile bool host_ticker_manual = false;
+static volatile uint32_t host_ticker_value = 0;
+
+static Timeout *host_timers = NULL;
+static host_i2c_device_t *host_i2c_devices = NULL;
+
+static void host_critical_init(void) {
+  pthread_mutexattr_t attr;
+
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&host_critical, &attr);
+  pthread_mutexattr_destroy(&attr);
+}
+
+void core_util_critical_section_enter(void) {
+  pthread_once(&host_critical_once, host_critical_init);
+  pthread_mutex_lock(&host_critical);
+}
+
+void core_util_critical_section_exit(void) {
+  pthread_mutex_unlock(&host_critical);
+}
+
+static uint64_t host_clock_ns(void) {
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+uint32_t us_ticker_read(void) {
+  if (host_ticker_manual) {
+    return host_ticker_value;
+  }
+  return (uint32_t) (host_clock_ns() / 1000);
+}
+
+void host_ticker_set(uint32_t us) {
+  host_ticker_value = us;
+  host_ticker_manual = true;
+}
+
+void host_ticker_advance(uint32_t us) {
+  host_ticker_value += us;
+}
+
+void host_ticker_release(void) {
+  host_ticker_manual = false;
+}
+
+void wait_us(int us) {
+  if (host_ticker_manual) {
+    host_ticker_advance(us);
+    sched_yield();
+  } else {
+    usleep(us);
+  }
+}
+
+void wait_ms(int ms) {
+  wait_us(ms * 1000);
+}
+
+void wait(float s) {
+  wait_us((int) (s * 1000000.0f));
+}
+
+void sleep(void) {
+  sched_yield();
+}
+
+DWT_Type *host_dwt(void) {
+  static DWT_Type dwt;
+
+  dwt.CYCCNT = (uint32_t) (host_clock_ns() * (SystemCoreClock / 1000000) / 1000);
+  return &dwt;
+}
+
+/* Serial ports */
+
+SerialBase::SerialBase(PinName tx, PinName rx, int baud)
+  : host_out(stdout), host_written(0), baud_(baud), rx_head_(0), rx_tail_(0) {
+  (void) tx;
+  (void) rx;
+}
+
+int SerialBase::readable(void) {
+  return rx_head_ != rx_tail_;
+}
+
+int SerialBase::getc(void) {
+  if (rx_head_ == rx_tail_) {
+    return -1;
+  }
+  return rx_[rx_tail_++ % RX_LEN];
+}
+
+int SerialBase::putc(int c) {
+  host_written++;
+  if (host_out) {
+    fputc(c, host_out);
+  }
+  return c;
+}
+
+int SerialBase::puts(const char *str) {
+  int length = 0;
+
+  while (*str) {
+    putc(*str++);
+    length++;
+  }
+  return length;
+}
+
+int SerialBase::printf(const char *format, ...) {
+  char buffer[512];
+  va_list args;
+  int length;
+
+  va_start(args, format);
+  length = vsnprintf(buffer, sizeof(buffer), format, args);
+  va_end(args);
+  if (length > (int) sizeof(buffer) - 1) {
+    length = sizeof(buffer) - 1;
+  }
+  host_written += length;
+  if (host_out && length > 0) {
+    fwrite(buffer, 1, length, host_out);
+  }
+  return length;
+}
+
+void SerialBase::host_receive(const uint8_t *data, uint32_t length) {
+  uint32_t i;
+
+  for (i = 0; i < length && rx_head_ - rx_tail_ < RX_LEN; i++) {
+    rx_[rx_head_++ % RX_LEN] = data[i];
+  }
+  rx_irq_.call();
+}
+
+/* I2C */
+
+void host_i2c_attach(host_i2c_device_t *device) {
+  device->next = host_i2c_devices;
+  host_i2c_devices = device;
+}
+
+void host_i2c_detach_all(void) {
+  host_i2c_devices = NULL;
+}
+
+static host_i2c_device_t *host_i2c_find(int address) {
+  host_i2c_device_t *device;
+
+  for (device = host_i2c_devices; device; device = device->next) {
+    if (device->address == (address & ~1)) {
+      return device;
+    }
+  }
+  return NULL;
+}
+
+int I2C::write(int address, const char *data, int length, bool repeated) {
+  host_i2c_device_t *device = host_i2c_find(address);
+
+  (void) repeated;
+  if (device == NULL || !device->write(device->context, (const uint8_t *) data, length)) {
+    return 1;
+  }
+  return 0;
+}
+
+int I2C::read(int address, char *data, int length, bool repeated) {
+  host_i2c_device_t *device = host_i2c_find(address);
+
+  (void) repeated;
+  if (device == NULL || !device->read(device->context, (uint8_t *) data, length)) {
+    return 1;
+  }
+  return 0;
+}
+
+/* Timers */
+
+Timeout::Timeout() : deadline_(0), period_(0), active_(false), periodic_(false), next_(NULL) {
+  core_util_critical_section_enter();
+  next_ = host_timers;
+  host_timers = this;
+  core_util_critical_section_exit();
+}
+
+Timeout::~Timeout() {
+  Timeout **link;
+
+  core_util_critical_section_enter();
+  for (link = &host_timers; *link; link = &(*link)->next_) {
+    if (*link == this) {
+      *link = next_;
+      break;
+    }
+  }
+  core_util_critical_section_exit();
+}
+
+void Timeout::attach_us(Callback<void()> func, uint32_t us) {
+  core_util_critical_section_enter();
+  func_ = func;
+  period_ = us;
+  deadline_ = us_ticker_read() + us;
+  active_ = true;
+  core_util_critical_section_exit();
+}
+
+void Timeout::detach(void) {
+  active_ = false;
+}
+
+void Timeout::host_fire(void) {
+  if (periodic_) {
+    deadline_ += period_;
+  } else {
+    active_ = false;
+  }
+  func_.call();
+}
+
+void host_timers_run(void) {
+  Timeout *timer;
+  bool fired;
+
+  core_util_critical_section_enter();
+  do {
+    fired = false;
+    for (timer = host_timers; timer; timer = timer->next_) {
+      if (timer->host_pending(us_ticker_read())) {
+        timer->host_fire();
+        fired = true;
+        break;
+      }
+    }
+  } while (fired);
+  core_util_critical_section_exit();
+}
+
+/* RTOS */
+
+HostLock::HostLock() {
+  pthread_condattr_t attr;
+
+  pthread_mutex_init(&mutex_, NULL);
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_cond_init(&cond_, &attr);
+  pthread_condattr_destroy(&attr);
+}
+
+HostLock::~HostLock() {
+  pthread_cond_destroy(&cond_);
+  pthread_mutex_destroy(&mutex_);
+}
+
+bool HostLock::wait(const struct timespec *deadline) {
+  if (deadline == NULL) {
+    pthread_cond_wait(&cond_, &mutex_);
+    return true;
+  }
+  return pthread_cond_timedwait(&cond_, &mutex_, deadline) != ETIMEDOUT;
+}
+
+const struct timespec *host_deadline(struct timespec *deadline, uint32_t millisec) {
+  if (millisec == osWaitForever) {
+    return NULL;
+  }
+  clock_gettime(CLOCK_MONOTONIC, deadline);
+  deadline->tv_sec += millisec / 1000;
+  deadline->tv_nsec += (long) (millisec % 1000) * 1000000L;
+  if (deadline->tv_nsec >= 1000000000L) {
+    deadline->tv_sec++;
+    deadline->tv_nsec -= 1000000000L;
+  }
+  return deadline;
+}
+
+static __thread Thread *host_current_thread = NULL;
+
+Thread::Thread(osPriority priority, uint32_t stack_size, unsigned char *stack_mem)
+  : stack_size_(stack_size), signals_(0) {
+  (void) priority;
+  (void) stack_mem;
+}
+
+void *Thread::run(void *thread) {
+  Thread *self = (Thread *) thread;
+
+  host_current_thread = self;
+  self->task_.call();
+  return NULL;
+}
+
+osStatus Thread::start(Callback<void()> task) {
+  task_ = task;
+  if (pthread_create(&handle_, NULL, &Thread::run, this) != 0) {
+    return osErrorResource;
+  }
+  pthread_detach(handle_);
+  return osOK;
+}
+
+Thread *Thread::current(void) {
+  static Thread main_thread;
+
+  if (host_current_thread == NULL) {
+    host_current_thread = &main_thread;
+  }
+  return host_current_thread;
+}
+
+int32_t Thread::signal_set(int32_t signals) {
+  int32_t previous;
+
+  lock_.lock();
+  previous = signals_;
+  signals_ |= signals;
+  lock_.notify_all();
+  lock_.unlock();
+  return previous;
+}
+
+osEvent Thread::signal_wait(int32_t signals, uint32_t millisec) {
+  Thread *self = current();
+  struct timespec deadline;
+  const struct timespec *until = host_deadline(&deadline, millisec);
+  osEvent event;
+
+  self->lock_.lock();
+  for (;;) {
+    if (signals == 0 ? self->signals_ != 0 : (self->signals_ & signals) == signals) {
+      event.status = osEventSignal;
+      event.value.signals = self->signals_;
+      self->signals_ &= (signals == 0) ? 0 : ~signals;
+      break;
+    }
+    if (millisec == 0) {
+      event.status = osOK;
+      break;
+    }
+    if (!self->lock_.wait(until)) {
+      event.status = osEventTimeout;
+      break;
+    }
+  }
+  self->lock_.unlock();
+  return event;
+}
+
+osStatus Thread::wait(uint32_t millisec) {
+  wait_us(millisec * 1000);
+  return osEventTimeout;
+}
+
+osStatus Thread::yield(void) {
+  sched_yield();
+  return osOK;
+}
+
+void Thread::attach_idle_hook(void (*hook)(void)) {
+  (void) hook;
+}
+
+Mutex::Mutex() {
+  pthread_mutexattr_t attr;
+
+  pthread_mutexattr_init(&attr);
+  pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+  pthread_mutex_init(&mutex_, &attr);
+  pthread_mutexattr_destroy(&attr);
+}
+
+Mutex::~Mutex() {
+  pthread_mutex_destroy(&mutex_);
+}
+
+osStatus Mutex::lock(uint32_t millisec) {
+  (void) millisec;
+  pthread_mutex_lock(&mutex_);
+  return osOK;
+}
+
+bool Mutex::trylock(void) {
+  return pthread_mutex_trylock(&mutex_) == 0;
+}
+
+osStatus Mutex::unlock(void) {
+  pthread_mutex_unlock(&mutex_);
+  return osOK;
+}
@@ -0,0 +1,78 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file host_robot.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Sets up thread_args_t for host tests and benchmarks.
+ */
+
+#include <string.h>
+#include "host_robot.h"
+#include "comms_host.h"
+#include "drive_modes.h"
+
+/* Console that LOG() prints to, set up by main() on the robot */
+static RawSerial host_console(USBTX, USBRX);
+RawSerial *serial_ptr = &host_console;
+
+const channel_limits_t host_robot_limits[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS] = {
+  {
+    {RC_0_CHAN_1_MIN, RC_0_CHAN_1_MAX}, {RC_0_CHAN_2_MIN, RC_0_CHAN_2_MAX},
+    {RC_0_CHAN_3_MIN, RC_0_CHAN_3_MAX}, {RC_0_CHAN_4_MIN, RC_0_CHAN_4_MAX},
+    {RC_0_CHAN_5_MIN, RC_0_CHAN_5_MAX}, {RC_0_CHAN_6_MIN, RC_0_CHAN_6_MAX}
+  },
+  {
+    {RC_1_CHAN_1_MIN, RC_1_CHAN_1_MAX}, {RC_1_CHAN_2_MIN, RC_1_CHAN_2_MAX},
+    {RC_1_CHAN_3_MIN, RC_1_CHAN_3_MAX}, {RC_1_CHAN_4_MIN, RC_1_CHAN_4_MAX},
+    {RC_1_CHAN_5_MIN, RC_1_CHAN_5_MAX}, {RC_1_CHAN_6_MIN, RC_1_CHAN_6_MAX}
+  }
+};
+
+void host_robot_init(thread_args_t *args) {
+  int controller;
+
+  memset(args, 0x00, sizeof(thread_args_t));
+  thread_args_init(args);
+  args->state = STATE_DISARMED;
+  memcpy(args->channel_limits, host_robot_limits, sizeof(host_robot_limits));
+  for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
+    rc_capture_init(&args->receiver[controller]);
+  }
+
+  args->drive_mode = (drive_mode_t *) &drive_modes[DM_2_WHEEL_DIFFERENTIAL];
+  args->weapon_mode = (weapon_mode_t *) &weapon_modes[WM_MANUAL_THROTTLE];
+
+  args->comms_impl = &comms_impl_host;
+  args->comms_impl->init_comms();
+  args->comms_impl->init_esc(&args->escs.drive[0], COMMS_OUTPUT_DRIVE_1);
+  args->comms_impl->init_esc(&args->escs.drive[1], COMMS_OUTPUT_DRIVE_2);
+  args->comms_impl->init_esc(&args->escs.drive[2], COMMS_OUTPUT_DRIVE_3);
+  args->comms_impl->init_esc(&args->escs.weapon[0], COMMS_OUTPUT_WEAPON_1);
+  args->comms_impl->init_esc(&args->escs.weapon[1], COMMS_OUTPUT_WEAPON_2);
+  args->comms_impl->init_esc(&args->escs.weapon[2], COMMS_OUTPUT_WEAPON_3);
+}
+
+void host_robot_pulses(thread_args_t *args, int controller,
+    const uint16_t width_us[RC_NUMBER_CHANNELS], uint64_t now_us) {
+  int channel;
+
+  for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
+    rc_capture_pulse(&args->receiver[controller], channel, width_us[channel], now_us);
+  }
+}
@@ -0,0 +1,53 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file host_robot.h
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Sets up thread_args_t for host tests and benchmarks the way main()
+ *        does on the robot, with the host ESC comms implementation and no
+ *        receiver interrupts.
+ */
+
+#ifndef TC_HOST_ROBOT_H
+#define TC_HOST_ROBOT_H
+
+#include "thread_args.h"
+
+/* Default calibrated limits of every channel, from config.h */
+extern const channel_limits_t host_robot_limits[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS];
+
+/**
+* @brief Initialise args as main() does, with the default drive and weapon
+*        modes and the robot disarmed.
+* @param [out] args Thread arguments.
+*/
+void host_robot_init(thread_args_t *args);
+
+/**
+* @brief Capture a pulse on every channel of a controller, as its receiver
+*        interrupts would.
+* @param [in/out] args Thread arguments.
+* @param [in] controller Controller index.
+* @param [in] width_us Pulse width of each channel (microseconds).
+* @param [in] now_us Time the pulses ended, from clock_now_us().
+*/
+void host_robot_pulses(thread_args_t *args, int controller,
+  const uint16_t width_us[RC_NUMBER_CHANNELS], uint64_t now_us);
+
+#endif  // TC_HOST_ROBOT_H
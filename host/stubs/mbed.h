@@ -0,0 +1,490 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file mbed.h
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Host stand-in for the parts of mbed-os the firmware uses, so the
+ *        control pipeline, drivers and decoders build and run on a PC for
+ *        tests and benchmarks. Not part of the firmware (see .mbedignore).
+ *
+ * The ticker runs on the host's monotonic clock until a test takes it over
+ * with host_ticker_set(), after which it only moves when the test (or
+ * wait()) moves it. Timeout and Ticker never fire on their own, tests call
+ * host_timers_run() to fire the ones that are due.
+ */
+
+#ifndef HOST_MBED_H
+#define HOST_MBED_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/**
+ * LPC1768 DIP pins, numbered as on the mbed board.
+ */
+typedef enum {
+  p5 = 5, p6, p7, p8, p9, p10, p11, p12, p13, p14, p15, p16, p17, p18, p19, p20,
+  p21, p22, p23, p24, p25, p26, p27, p28, p29, p30,
+  LED1 = 101, LED2, LED3, LED4,
+  USBTX = 201, USBRX,
+  NC = -1
+} PinName;
+
+typedef enum {
+  PullUp = 0,
+  PullDown,
+  PullNone
+} PinMode;
+
+/* Cortex-M intrinsics */
+static inline void __DMB(void) {
+  __sync_synchronize();
+}
+
+static inline void __disable_irq(void) {
+}
+
+static inline void __enable_irq(void) {
+}
+
+/**
+* @brief Interrupts can't preempt host code, but the bus thread and test
+*        threads can, so critical sections are a recursive lock.
+*/
+void core_util_critical_section_enter(void);
+void core_util_critical_section_exit(void);
+
+static inline uint32_t core_util_atomic_incr_u32(volatile uint32_t *value, uint32_t delta) {
+  return __sync_add_and_fetch(value, delta);
+}
+
+static inline uint32_t core_util_atomic_decr_u32(volatile uint32_t *value, uint32_t delta) {
+  return __sync_sub_and_fetch(value, delta);
+}
+
+/**
+* @return Microsecond ticker, wrapping at 32 bits like the LPC1768 timer.
+*/
+uint32_t us_ticker_read(void);
+
+/**
+* @brief Stop the ticker following the host clock and set it to a value.
+* @param [in] us New ticker value (microseconds).
+*/
+void host_ticker_set(uint32_t us);
+
+/**
+* @brief Move the ticker forward, used with host_ticker_set().
+* @param [in] us Time to add (microseconds).
+*/
+void host_ticker_advance(uint32_t us);
+
+/**
+* @brief Let the ticker follow the host clock again.
+*/
+void host_ticker_release(void);
+
+/**
+* @brief Fire every Timeout and Ticker that is due at the current ticker
+*        value, in the calling thread.
+*/
+void host_timers_run(void);
+
+void wait(float s);
+void wait_ms(int ms);
+void wait_us(int us);
+
+/**
+* @brief Sleep until the next interrupt, a yield on the host.
+*/
+void sleep(void);
+
+extern uint32_t SystemCoreClock;
+
+/* DWT cycle counter, counts SystemCoreClock cycles of host time. */
+typedef struct {
+  volatile uint32_t CTRL;
+  volatile uint32_t CYCCNT;
+} DWT_Type;
+
+typedef struct {
+  volatile uint32_t DEMCR;
+} CoreDebug_Type;
+
+DWT_Type *host_dwt(void);
+extern CoreDebug_Type host_core_debug;
+
+#define DWT (host_dwt())
+#define CoreDebug (&host_core_debug)
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+
+/* LPC1768 watchdog registers, which do nothing on the host. */
+typedef struct {
+  volatile uint32_t WDMOD;
+  volatile uint32_t WDTC;
+  volatile uint32_t WDFEED;
+  volatile uint32_t WDTV;
+  volatile uint32_t WDCLKSEL;
+} LPC_WDT_TypeDef;
+
+extern LPC_WDT_TypeDef host_wdt;
+#define LPC_WDT (&host_wdt)
+
+/** @class Callback
+    @brief Function and argument called back by the stand-ins, as
+           mbed::Callback<void()>.
+*/
+template <typename F>
+class Callback;
+
+template <>
+class Callback<void()> {
+  public:
+  Callback() : func_(NULL), arg_(NULL), thunk_(NULL) {
+  }
+
+  Callback(void (*func)(void)) : func_(func), arg_(NULL), thunk_(NULL) {
+  }
+
+  template <typename T>
+  Callback(void (*func)(T *), T *arg)
+    : func_((void (*)(void)) func), arg_((void *) arg), thunk_(&thunk<T>) {
+  }
+
+  void call(void) const {
+    if (thunk_) {
+      thunk_(func_, arg_);
+    } else if (func_) {
+      func_();
+    }
+  }
+
+  void operator()(void) const {
+    call();
+  }
+
+  operator bool(void) const {
+    return func_ != NULL;
+  }
+
+  private:
+  template <typename T>
+  static void thunk(void (*func)(void), void *arg) {
+    ((void (*)(T *)) func)((T *) arg);
+  }
+
+  void (*func_)(void);
+  void *arg_;
+  void (*thunk_)(void (*func)(void), void *arg);
+};
+
+template <typename T, typename U>
+Callback<void()> callback(void (*func)(T *), U *arg) {
+  T *converted = arg;
+  return Callback<void()>(func, converted);
+}
+
+static inline Callback<void()> callback(void (*func)(void)) {
+  return Callback<void()>(func);
+}
+
+/** @class DigitalIn
+    @brief Input pin, tests set its level with host_set().
+*/
+class DigitalIn {
+  public:
+  DigitalIn(PinName pin) : pin_(pin), value_(0) {
+  }
+
+  int read(void) {
+    return value_;
+  }
+
+  void mode(PinMode mode) {
+    (void) mode;
+  }
+
+  operator int(void) {
+    return read();
+  }
+
+  void host_set(int value) {
+    value_ = value;
+  }
+
+  private:
+  PinName pin_;
+  int value_;
+};
+
+/** @class DigitalOut
+    @brief Output pin, remembers the last level written.
+*/
+class DigitalOut {
+  public:
+  DigitalOut(PinName pin, int value = 0) : pin_(pin), value_(value) {
+  }
+
+  void write(int value) {
+    value_ = value;
+  }
+
+  int read(void) {
+    return value_;
+  }
+
+  DigitalOut &operator=(int value) {
+    write(value);
+    return *this;
+  }
+
+  operator int(void) {
+    return read();
+  }
+
+  private:
+  PinName pin_;
+  int value_;
+};
+
+/** @class InterruptIn
+    @brief Input pin with edge callbacks, tests make edges with
+           host_rise() and host_fall().
+*/
+class InterruptIn {
+  public:
+  InterruptIn(PinName pin) : pin_(pin), value_(0) {
+  }
+
+  void rise(Callback<void()> func) {
+    rise_ = func;
+  }
+
+  void fall(Callback<void()> func) {
+    fall_ = func;
+  }
+
+  int read(void) {
+    return value_;
+  }
+
+  void mode(PinMode mode) {
+    (void) mode;
+  }
+
+  operator int(void) {
+    return read();
+  }
+
+  void host_rise(void) {
+    value_ = 1;
+    rise_.call();
+  }
+
+  void host_fall(void) {
+    value_ = 0;
+    fall_.call();
+  }
+
+  private:
+  PinName pin_;
+  int value_;
+  Callback<void()> rise_;
+  Callback<void()> fall_;
+};
+
+/** @class SerialBase
+    @brief UART settings and receive interrupt shared by the serial ports.
+*/
+class SerialBase {
+  public:
+  enum Parity {
+    None = 0,
+    Odd,
+    Even,
+    Forced1,
+    Forced0
+  };
+
+  enum IrqType {
+    RxIrq = 0,
+    TxIrq
+  };
+
+  SerialBase(PinName tx, PinName rx, int baud);
+
+  void baud(int baudrate) {
+    baud_ = baudrate;
+  }
+
+  void format(int bits = 8, Parity parity = None, int stop_bits = 1) {
+    (void) bits;
+    (void) parity;
+    (void) stop_bits;
+  }
+
+  void attach(Callback<void()> func, IrqType type = RxIrq) {
+    if (type == RxIrq) {
+      rx_irq_ = func;
+    }
+  }
+
+  int readable(void);
+  int writeable(void) {
+    return 1;
+  }
+
+  int getc(void);
+  int putc(int c);
+  int puts(const char *str);
+  int printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+  /**
+  * @brief Receive bytes as if from the RX pin, calling the receive
+  *        interrupt once for the burst.
+  * @param [in] data Bytes received.
+  * @param [in] length Number of bytes.
+  */
+  void host_receive(const uint8_t *data, uint32_t length);
+
+  /*! Where output goes, NULL to discard it. Defaults to stdout. */
+  FILE *host_out;
+
+  /*! Number of bytes written. */
+  uint32_t host_written;
+
+  private:
+  static const uint32_t RX_LEN = 512;
+
+  int baud_;
+  Callback<void()> rx_irq_;
+  uint8_t rx_[RX_LEN];
+  uint32_t rx_head_;
+  uint32_t rx_tail_;
+};
+
+class RawSerial : public SerialBase {
+  public:
+  RawSerial(PinName tx, PinName rx, int baud = 9600) : SerialBase(tx, rx, baud) {
+  }
+};
+
+class Serial : public SerialBase {
+  public:
+  Serial(PinName tx, PinName rx, int baud = 9600) : SerialBase(tx, rx, baud) {
+  }
+};
+
+/**
+ * A device on a host I2C bus, as seen by the I2C stand-in. Addresses are
+ * 8 bit like mbed's. Each function returns false to NACK.
+ */
+typedef struct host_i2c_device_t {
+  int address;
+  bool (*write)(void *context, const uint8_t *data, uint32_t length);
+  bool (*read)(void *context, uint8_t *data, uint32_t length);
+  void *context;
+  struct host_i2c_device_t *next;
+} host_i2c_device_t;
+
+/**
+* @brief Put a device model on every host I2C bus.
+* @param [in] device Device, must stay valid until detached.
+*/
+void host_i2c_attach(host_i2c_device_t *device);
+
+/**
+* @brief Take every device off the host I2C buses.
+*/
+void host_i2c_detach_all(void);
+
+/** @class I2C
+    @brief I2C master that passes transfers to the attached device models.
+*/
+class I2C {
+  public:
+  I2C(PinName sda, PinName scl) : frequency_(100000) {
+    (void) sda;
+    (void) scl;
+  }
+
+  void frequency(int hz) {
+    frequency_ = hz;
+  }
+
+  int write(int address, const char *data, int length, bool repeated = false);
+  int read(int address, char *data, int length, bool repeated = false);
+
+  private:
+  int frequency_;
+};
+
+/** @class Timeout
+    @brief One shot timer, see host_timers_run().
+*/
+class Timeout {
+  public:
+  Timeout();
+  virtual ~Timeout();
+
+  void attach_us(Callback<void()> func, uint32_t us);
+
+  void attach(Callback<void()> func, float s) {
+    attach_us(func, (uint32_t) (s * 1000000.0f));
+  }
+
+  void detach(void);
+
+  /*! Called by host_timers_run(). */
+  void host_fire(void);
+
+  bool host_pending(uint32_t now) const {
+    return active_ && (int32_t) (now - deadline_) >= 0;
+  }
+
+  protected:
+  Callback<void()> func_;
+  uint32_t deadline_;
+  uint32_t period_;
+  bool active_;
+  bool periodic_;
+  Timeout *next_;
+  friend void host_timers_run(void);
+};
+
+/** @class Ticker
+    @brief Periodic timer, see host_timers_run().
+*/
+class Ticker : public Timeout {
+  public:
+  Ticker() {
+    periodic_ = true;
+  }
+};
+
+/* mbed.h brings in the RTOS when it is present, as it is here */
+#include "rtos.h"
+
+#endif  // HOST_MBED_H
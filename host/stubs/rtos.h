@@ -0,0 +1,324 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file rtos.h
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Host stand-in for the mbed-os 5 RTOS classes the firmware uses,
+ *        built on POSIX threads. Priorities and stack sizes are accepted
+ *        and ignored.
+ */
+
+#ifndef HOST_RTOS_H
+#define HOST_RTOS_H
+
+#include <pthread.h>
+#include "mbed.h"
+
+typedef enum {
+  osPriorityIdle = -3,
+  osPriorityLow = -2,
+  osPriorityBelowNormal = -1,
+  osPriorityNormal = 0,
+  osPriorityAboveNormal = 1,
+  osPriorityHigh = 2,
+  osPriorityRealtime = 3,
+  osPriorityError = 0x84
+} osPriority;
+
+typedef enum {
+  osOK = 0,
+  osEventSignal = 0x08,
+  osEventMessage = 0x10,
+  osEventMail = 0x20,
+  osEventTimeout = 0x40,
+  osErrorParameter = 0x80,
+  osErrorResource = 0x81,
+  osErrorTimeoutResource = 0xC1
+} osStatus;
+
+#define osWaitForever 0xFFFFFFFFU
+
+typedef struct {
+  osStatus status;
+  union {
+    uint32_t v;
+    void *p;
+    int32_t signals;
+  } value;
+} osEvent;
+
+/** @class HostLock
+    @brief Mutex and condition variable behind each blocking stand-in.
+*/
+class HostLock {
+  public:
+  HostLock();
+  ~HostLock();
+
+  void lock(void) {
+    pthread_mutex_lock(&mutex_);
+  }
+
+  void unlock(void) {
+    pthread_mutex_unlock(&mutex_);
+  }
+
+  void notify_all(void) {
+    pthread_cond_broadcast(&cond_);
+  }
+
+  /**
+  * @brief Wait for a notify_all(), with the lock held.
+  * @param [in] deadline From host_deadline(), NULL to wait forever.
+  * @return false if the deadline passed.
+  */
+  bool wait(const struct timespec *deadline);
+
+  private:
+  pthread_mutex_t mutex_;
+  pthread_cond_t cond_;
+};
+
+/**
+* @param [out] deadline Time millisec from now, for HostLock::wait().
+* @param [in] millisec Timeout, osWaitForever for none.
+* @return deadline, or NULL if millisec is osWaitForever.
+*/
+const struct timespec *host_deadline(struct timespec *deadline, uint32_t millisec);
+
+/** @class Thread
+    @brief A POSIX thread with RTX style signal flags.
+*/
+class Thread {
+  public:
+  Thread(osPriority priority = osPriorityNormal, uint32_t stack_size = 4096,
+    unsigned char *stack_mem = NULL);
+
+  osStatus start(Callback<void()> task);
+  int32_t signal_set(int32_t signals);
+
+  uint32_t stack_size(void) const {
+    return stack_size_;
+  }
+
+  uint32_t used_stack(void) const {
+    return 0;
+  }
+
+  uint32_t free_stack(void) const {
+    return stack_size_;
+  }
+
+  static osEvent signal_wait(int32_t signals, uint32_t millisec = osWaitForever);
+  static osStatus wait(uint32_t millisec);
+  static osStatus yield(void);
+  static void attach_idle_hook(void (*hook)(void));
+
+  private:
+  static void *run(void *thread);
+  static Thread *current(void);
+
+  uint32_t stack_size_;
+  Callback<void()> task_;
+  pthread_t handle_;
+  HostLock lock_;
+  int32_t signals_;
+};
+
+/** @class Mutex
+    @brief Recursive mutex, as RTX mutexes are.
+*/
+class Mutex {
+  public:
+  Mutex();
+  ~Mutex();
+
+  osStatus lock(uint32_t millisec = osWaitForever);
+  bool trylock(void);
+  osStatus unlock(void);
+
+  private:
+  pthread_mutex_t mutex_;
+};
+
+/** @class Semaphore
+    @brief Counting semaphore.
+*/
+class Semaphore {
+  public:
+  Semaphore(int32_t count = 0) : count_(count) {
+  }
+
+  /**
+  * @return Tokens available before taking one, 0 on timeout.
+  */
+  int32_t wait(uint32_t millisec = osWaitForever) {
+    struct timespec deadline;
+    const struct timespec *until = host_deadline(&deadline, millisec);
+    int32_t tokens;
+
+    lock_.lock();
+    while (count_ == 0) {
+      if (millisec == 0 || !lock_.wait(until)) {
+        lock_.unlock();
+        return 0;
+      }
+    }
+    tokens = count_--;
+    lock_.unlock();
+    return tokens;
+  }
+
+  osStatus release(void) {
+    lock_.lock();
+    count_++;
+    lock_.notify_all();
+    lock_.unlock();
+    return osOK;
+  }
+
+  private:
+  HostLock lock_;
+  int32_t count_;
+};
+
+/** @class Queue
+    @brief Queue of up to N pointers.
+*/
+template <typename T, uint32_t N>
+class Queue {
+  public:
+  Queue() : head_(0), tail_(0) {
+  }
+
+  osStatus put(T *data, uint32_t millisec = 0, uint8_t prio = 0) {
+    struct timespec deadline;
+    const struct timespec *until = host_deadline(&deadline, millisec);
+
+    (void) prio;
+    lock_.lock();
+    while (head_ - tail_ >= N) {
+      if (millisec == 0 || !lock_.wait(until)) {
+        lock_.unlock();
+        return osErrorResource;
+      }
+    }
+    items_[head_++ % N] = data;
+    lock_.notify_all();
+    lock_.unlock();
+    return osOK;
+  }
+
+  osEvent get(uint32_t millisec = osWaitForever) {
+    struct timespec deadline;
+    const struct timespec *until = host_deadline(&deadline, millisec);
+    osEvent event;
+
+    event.value.p = NULL;
+    lock_.lock();
+    while (head_ == tail_) {
+      if (millisec == 0 || !lock_.wait(until)) {
+        lock_.unlock();
+        event.status = (millisec == 0) ? osOK : osEventTimeout;
+        return event;
+      }
+    }
+    event.status = osEventMessage;
+    event.value.p = items_[tail_++ % N];
+    lock_.notify_all();
+    lock_.unlock();
+    return event;
+  }
+
+  bool empty(void) {
+    bool result;
+    lock_.lock();
+    result = (head_ == tail_);
+    lock_.unlock();
+    return result;
+  }
+
+  private:
+  HostLock lock_;
+  T *items_[N];
+  uint32_t head_;
+  uint32_t tail_;
+};
+
+/** @class Mail
+    @brief Queue of up to N messages from a fixed pool.
+*/
+template <typename T, uint32_t N>
+class Mail {
+  public:
+  Mail() {
+    memset(used_, 0, sizeof(used_));
+  }
+
+  T *alloc(uint32_t millisec = 0) {
+    uint32_t i;
+
+    (void) millisec;
+    lock_.lock();
+    for (i = 0; i < N; i++) {
+      if (!used_[i]) {
+        used_[i] = true;
+        lock_.unlock();
+        return &pool_[i];
+      }
+    }
+    lock_.unlock();
+    return NULL;
+  }
+
+  T *calloc(uint32_t millisec = 0) {
+    T *mail = alloc(millisec);
+    if (mail) {
+      memset((void *) mail, 0, sizeof(T));
+    }
+    return mail;
+  }
+
+  osStatus put(T *mail) {
+    return queue_.put(mail);
+  }
+
+  osEvent get(uint32_t millisec = osWaitForever) {
+    osEvent event = queue_.get(millisec);
+    if (event.status == osEventMessage) {
+      event.status = osEventMail;
+    }
+    return event;
+  }
+
+  osStatus free(T *mail) {
+    lock_.lock();
+    used_[mail - pool_] = false;
+    lock_.unlock();
+    return osOK;
+  }
+
+  private:
+  HostLock lock_;
+  T pool_[N];
+  bool used_[N];
+  Queue<T, N> queue_;
+};
+
+#endif  // HOST_RTOS_H
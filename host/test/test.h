@@ -0,0 +1,73 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file test.h
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Checks for host tests. A test program runs every check, prints the
+ *        ones that fail and exits with 1 if any did.
+ */
+
+#ifndef TC_TEST_H
+#define TC_TEST_H
+
+#include <stdio.h>
+#include <math.h>
+
+static int test_checks = 0;
+static int test_failures = 0;
+
+#define CHECK(condition) \
+  do { \
+    test_checks++; \
+    if (!(condition)) { \
+      test_failures++; \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+    } \
+  } while (0)
+
+#define CHECK_EQUAL(expected, actual) \
+  do { \
+    long long test_e = (long long) (expected), test_a = (long long) (actual); \
+    test_checks++; \
+    if (test_e != test_a) { \
+      test_failures++; \
+      printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, test_a, test_e); \
+    } \
+  } while (0)
+
+#define CHECK_CLOSE(expected, actual, tolerance) \
+  do { \
+    double test_e = (double) (expected), test_a = (double) (actual); \
+    test_checks++; \
+    if (fabs(test_e - test_a) > (tolerance)) { \
+      test_failures++; \
+      printf("%s:%d: %s is %g, expected %g\n", __FILE__, __LINE__, #actual, test_a, test_e); \
+    } \
+  } while (0)
+
+/**
+* @brief Print a summary of the checks.
+* @return Exit status of the test program.
+*/
+static inline int test_summary(const char *name) {
+  printf("%s: %d checks, %d failed\n", name, test_checks, test_failures);
+  return test_failures ? 1 : 0;
+}
+
+#endif  // TC_TEST_H
@@ -0,0 +1,292 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file test_bno055.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief The BNO055 driver and the I2C engine, against a model of the
+ *        sensor's register map on the host I2C bus.
+ */
+
+#include <string.h>
+#include "test.h"
+#include "mbed.h"
+#include "rtos.h"
+#include "bno055.h"
+#include "i2c_engine.h"
+#include "return_codes.h"
+
+#define MAX_WRITES 64
+
+/* Signal the sampling thread waits for */
+#define SAMPLE_SIGNAL 0x10
+
+/**
+ * Register map of a BNO055. Writes set the register pointer, then fill
+ * registers from it, and reads carry on from the pointer, as the sensor's
+ * auto increment does.
+ */
+typedef struct {
+  uint8_t page[2][0x80];
+  uint8_t pointer;
+  bool present;
+
+  /*! Every register written, in order, as page << 8 | register. */
+  uint16_t written[MAX_WRITES];
+  uint8_t value[MAX_WRITES];
+  uint32_t writes;
+  uint32_t reads;
+} bno055_model_t;
+
+static uint8_t *model_page(bno055_model_t *model) {
+  return model->page[model->page[0][BNO055_PAGE_ID_ADDR] & 0x01];
+}
+
+static bool model_write(void *context, const uint8_t *data, uint32_t length) {
+  bno055_model_t *model = (bno055_model_t *) context;
+  uint32_t i;
+
+  if (!model->present || length == 0) {
+    return false;
+  }
+  model->pointer = data[0] & 0x7F;
+  for (i = 1; i < length; i++) {
+    if (model->writes < MAX_WRITES) {
+      model->written[model->writes] = (uint16_t) ((model_page(model) == model->page[1]) << 8 | model->pointer);
+      model->value[model->writes] = data[i];
+      model->writes++;
+    }
+    // The page register is at the same address on both pages
+    if (model->pointer == BNO055_PAGE_ID_ADDR) {
+      model->page[0][BNO055_PAGE_ID_ADDR] = data[i];
+      model->page[1][BNO055_PAGE_ID_ADDR] = data[i];
+    } else {
+      model_page(model)[model->pointer] = data[i];
+    }
+    model->pointer = (model->pointer + 1) & 0x7F;
+  }
+  return true;
+}
+
+static bool model_read(void *context, uint8_t *data, uint32_t length) {
+  bno055_model_t *model = (bno055_model_t *) context;
+  uint32_t i;
+
+  if (!model->present) {
+    return false;
+  }
+  for (i = 0; i < length; i++) {
+    data[i] = model_page(model)[model->pointer];
+    model->pointer = (model->pointer + 1) & 0x7F;
+  }
+  model->reads++;
+  return true;
+}
+
+static bno055_model_t model;
+static host_i2c_device_t device;
+static i2c_engine_t engine;
+
+static void model_reset(void) {
+  memset(&model, 0x00, sizeof(model));
+  model.present = true;
+  model.page[0][BNO055_ID_ADDR] = 0xA0;
+  model.page[0][BNO055_TEMP_ADDR] = 25;
+}
+
+static void model_set_s16(int reg, int16_t value) {
+  model.page[0][reg] = (uint8_t) (value & 0xFF);
+  model.page[0][reg + 1] = (uint8_t) ((uint16_t) value >> 8);
+}
+
+/* Index of the nth write to a register, or -1 */
+static int model_find_write(int page, int reg, int nth) {
+  uint32_t i;
+
+  for (i = 0; i < model.writes; i++) {
+    if (model.written[i] == (page << 8 | reg) && nth-- == 0) {
+      return (int) i;
+    }
+  }
+  return -1;
+}
+
+static void test_init(void) {
+  bno055_config_t config;
+  int first_mode, last_mode;
+
+  // Raw sensors at 100 Hz with the data ready interrupt
+  model_reset();
+  config.mode = BNO055_MODE_ACCGYRO;
+  config.raw_rate_hz = 100;
+  config.data_ready_int = true;
+  CHECK(bno055_init(&engine, &config));
+
+  first_mode = model_find_write(0, BNO055_OPR_MODE_ADDR, 0);
+  last_mode = model_find_write(0, BNO055_OPR_MODE_ADDR, 1);
+  CHECK_EQUAL(0, first_mode);
+  CHECK_EQUAL(BNO055_MODE_CONFIG, model.value[first_mode]);
+  CHECK_EQUAL(BNO055_MODE_ACCGYRO, model.value[last_mode]);
+  CHECK_EQUAL(model.writes - 1, last_mode);
+  CHECK_EQUAL(BNO055_MODE_ACCGYRO, model.page[0][BNO055_OPR_MODE_ADDR]);
+  CHECK_EQUAL(0x06, model.page[0][BNO055_AXIS_MAP_CONFIG_ADDR]);
+  CHECK_EQUAL((uint8_t) BNO055_SYS_TRIGGER_CLK_SEL, model.page[0][BNO055_SYS_TRIGGER_ADDR]);
+
+  // Page 1 is written in CONFIG mode, and page 0 selected again after
+  CHECK(model_find_write(1, BNO055_ACC_CONFIG_ADDR, 0) > first_mode);
+  CHECK(model_find_write(1, BNO055_INT_EN_ADDR, 0) < last_mode);
+  CHECK_EQUAL(0, model.page[0][BNO055_PAGE_ID_ADDR]);
+  // 125 Hz accelerometer (62.5 Hz bandwidth) and 100 Hz gyroscope
+  CHECK_EQUAL(0x0D, model.page[1][BNO055_ACC_CONFIG_ADDR]);
+  CHECK_EQUAL(0x28, model.page[1][BNO055_GYR_CONFIG_0_ADDR]);
+  CHECK_EQUAL(BNO055_INT_ACC_BSX_DRDY, model.page[1][BNO055_INT_MSK_ADDR]);
+  CHECK_EQUAL(BNO055_INT_ACC_BSX_DRDY, model.page[1][BNO055_INT_EN_ADDR]);
+  CHECK_EQUAL(100, bno055_data_rate_hz(&config));
+
+  // Fusion leaves the sensor bandwidths alone and has no interrupt
+  model_reset();
+  config.mode = BNO055_MODE_NDOF;
+  config.data_ready_int = false;
+  CHECK(bno055_init(&engine, &config));
+  CHECK_EQUAL(-1, model_find_write(1, BNO055_ACC_CONFIG_ADDR, 0));
+  CHECK_EQUAL(0, model.page[1][BNO055_INT_EN_ADDR]);
+  CHECK_EQUAL(BNO055_MODE_NDOF, model.page[0][BNO055_OPR_MODE_ADDR]);
+  CHECK_EQUAL(BNO055_FUSION_RATE_HZ, bno055_data_rate_hz(&config));
+
+  // Another device at the address
+  model_reset();
+  model.page[0][BNO055_ID_ADDR] = 0x55;
+  CHECK(!bno055_init(&engine, &config));
+}
+
+static void set_measurements(int16_t heading) {
+  model_set_s16(BNO055_ACCEL_DATA_X_LSB_ADDR, 981);
+  model_set_s16(BNO055_ACCEL_DATA_X_LSB_ADDR + 2, -50);
+  model_set_s16(BNO055_DATA_START_ADDR + BNO055_DATA_GYRO + 4, -160);
+  model_set_s16(BNO055_EULER_H_LSB_ADDR, heading);
+  model_set_s16(BNO055_EULER_H_LSB_ADDR + 2, 80);
+  model_set_s16(BNO055_EULER_H_LSB_ADDR + 4, -160);
+  model_set_s16(BNO055_DATA_START_ADDR + BNO055_DATA_QUATERNION, 16384);
+  model.page[0][BNO055_TEMP_ADDR] = (uint8_t) -5;
+}
+
+static void check_sample(const bno055_sample_t *sample, float heading) {
+  CHECK_CLOSE(9.81, sample->accel.x, 0.001);
+  CHECK_CLOSE(-0.5, sample->accel.y, 0.001);
+  CHECK_CLOSE(0.0, sample->accel.z, 0.001);
+  CHECK_CLOSE(-10.0, sample->gyro.z, 0.001);
+  CHECK_CLOSE(heading, sample->euler.heading, 0.001);
+  CHECK_CLOSE(5.0, sample->euler.roll, 0.001);
+  CHECK_CLOSE(-10.0, sample->euler.pitch, 0.001);
+  CHECK_CLOSE(1.0, sample->quaternion.w, 0.001);
+  CHECK_EQUAL(-5, sample->temp);
+}
+
+static void test_read_sample(void) {
+  bno055_sample_t sample;
+  uint32_t reads;
+
+  set_measurements(90 * 16);
+  reads = model.reads;
+  CHECK(bno055_read_sample(&sample));
+  check_sample(&sample, 90.0f);
+  // One burst read of every measurement
+  CHECK_EQUAL(reads + 1, model.reads);
+  CHECK(bno055_healthy() == false);
+  model.page[0][BNO055_SYS_STAT_ADDR] = 5;
+  CHECK(bno055_healthy());
+}
+
+/**
+ * A thread that queues a read and sleeps until the bus thread signals it,
+ * as the orientation task does.
+ */
+typedef struct {
+  Thread *thread;
+  Semaphore *done;
+  bno055_read_t read;
+  int queued;
+  osEvent event;
+} sampler_t;
+
+static void sampler_run(sampler_t *sampler) {
+  sampler->queued = bno055_request_sample(&sampler->read, sampler->thread, SAMPLE_SIGNAL);
+  if (sampler->queued == RET_OK) {
+    sampler->event = Thread::signal_wait(SAMPLE_SIGNAL, 1000);
+  }
+  sampler->done->release();
+}
+
+static void test_request_sample(void) {
+  static Thread thread;
+  Semaphore done(0);
+  sampler_t sampler;
+  bno055_sample_t sample;
+
+  set_measurements(-45 * 16);
+  memset(&sampler.read, 0x00, sizeof(sampler.read));
+  sampler.thread = &thread;
+  sampler.done = &done;
+  thread.start(callback(sampler_run, &sampler));
+  CHECK(done.wait(2000) > 0);
+
+  CHECK_EQUAL(RET_OK, sampler.queued);
+  CHECK_EQUAL(osEventSignal, sampler.event.status);
+  CHECK_EQUAL(I2C_DONE, sampler.read.transaction.result);
+  CHECK(bno055_sample_result(&sampler.read, &sample));
+  check_sample(&sample, -45.0f);
+}
+
+/* A sensor that stops answering fails the read rather than returning stale
+   data */
+static void test_nack(void) {
+  bno055_read_t read;
+  bno055_sample_t sample;
+  uint32_t nacked = engine.nacked;
+
+  model.present = false;
+  CHECK(!bno055_read_sample(&sample));
+  CHECK(!bno055_healthy());
+  CHECK_EQUAL(nacked + 2, engine.nacked);
+
+  // An unfinished read isn't decoded either
+  memset(&read, 0x00, sizeof(read));
+  read.transaction.result = I2C_PENDING;
+  CHECK(!bno055_sample_result(&read, &sample));
+  model.present = true;
+}
+
+int main(void) {
+  device.address = bno055_addr;
+  device.write = model_write;
+  device.read = model_read;
+  device.context = &model;
+  host_i2c_attach(&device);
+  i2c_engine_init(&engine, I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCY_HZ);
+
+  // The waits in bno055_init() pass in virtual time
+  host_ticker_set(1000);
+  test_init();
+  host_ticker_release();
+
+  test_read_sample();
+  test_request_sample();
+  test_nack();
+  host_i2c_detach_all();
+  return test_summary("test_bno055");
+}
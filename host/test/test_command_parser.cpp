@@ -0,0 +1,149 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file test_command_parser.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Command and parameter lookup, the tokenizer and the values read by
+ *        command_generate().
+ */
+
+#include <string.h>
+#include "test.h"
+#include "command_parser.h"
+#include "return_codes.h"
+#include "tele_params.h"
+
+static command_token_t token(const char *text) {
+  command_token_t t;
+
+  t.text = text;
+  t.length = strlen(text);
+  return t;
+}
+
+static void test_tokens(void) {
+  const char *line = "  set   arm_status 3 ";
+  const char *cursor = line;
+  command_token_t t;
+
+  CHECK(command_next_token(&cursor, &t));
+  CHECK_EQUAL(3, t.length);
+  CHECK(strncmp(t.text, "set", t.length) == 0);
+  CHECK(command_next_token(&cursor, &t));
+  CHECK_EQUAL(10, t.length);
+  CHECK(strncmp(t.text, "arm_status", t.length) == 0);
+  CHECK(command_next_token(&cursor, &t));
+  CHECK(strncmp(t.text, "3", t.length) == 0);
+  CHECK(!command_next_token(&cursor, &t));
+  CHECK(!command_next_token(&cursor, &t));
+  CHECK_EQUAL(0, t.length);
+
+  // The line is left as it was
+  CHECK(strcmp(line, "  set   arm_status 3 ") == 0);
+}
+
+/* Every name is found, and only by its full name */
+static void test_lookup(void) {
+  command_token_t t;
+  char prefix[64];
+  unsigned i;
+
+  for (i = 0; i < NUM_COMMANDS; i++) {
+    t = token(available_commands[i].name);
+    CHECK_EQUAL(i, command_find(&t));
+    CHECK_EQUAL(available_commands[i].id, i);
+  }
+  for (i = 0; i < NUM_TELE_COMMANDS; i++) {
+    t = token(tele_commands[i].name);
+    CHECK_EQUAL(i, tele_param_find(&t));
+    CHECK_EQUAL(tele_commands[i].id, i);
+
+    // Neither a prefix nor a longer name matches
+    strcpy(prefix, tele_commands[i].name);
+    prefix[strlen(prefix) - 1] = '\0';
+    t = token(prefix);
+    CHECK_EQUAL(-1, tele_param_find(&t));
+    strcat(prefix, "xx");
+    t = token(prefix);
+    CHECK_EQUAL(-1, tele_param_find(&t));
+  }
+
+  // Neither part of a command name nor a longer word matches
+  t = token("dis");
+  CHECK_EQUAL(-1, command_find(&t));
+  t = token("arming");
+  CHECK_EQUAL(-1, command_find(&t));
+  t = token("");
+  CHECK_EQUAL(-1, command_find(&t));
+  t = token("arm_status");
+  CHECK_EQUAL(-1, command_find(&t));
+
+  // A name within a longer line is found by its length alone
+  t.text = "armed";
+  t.length = 3;
+  CHECK_EQUAL(FULLY_ARM, command_find(&t));
+}
+
+static void test_generate(void) {
+  command_t command;
+
+  CHECK_EQUAL(RET_OK, command_generate(&command, "arm"));
+  CHECK_EQUAL(FULLY_ARM, command.id);
+  CHECK(strcmp(command.name, "arm") == 0);
+  CHECK_EQUAL(RET_OK, command_generate(&command, " disarm  "));
+  CHECK_EQUAL(FULLY_DISARM, command.id);
+
+  CHECK_EQUAL(RET_OK, command_generate(&command, "get drive_rx_age"));
+  CHECK_EQUAL(GET_PARAM, command.id);
+  CHECK(command.tele_param == &tele_commands[CID_DRIVE_RX_AGE]);
+
+  CHECK_EQUAL(RET_OK, command_generate(&command, "set arm_status 3"));
+  CHECK_EQUAL(SET_PARAM, command.id);
+  CHECK(command.tele_param == &tele_commands[CID_ARM_STATUS]);
+  CHECK_EQUAL(3, command.value.i);
+
+  CHECK_EQUAL(RET_OK, command_generate(&command, "set drive_rpm_1 -1234.5"));
+  CHECK_CLOSE(-1234.5, command.value.f, 0.001);
+
+  CHECK_EQUAL(RET_OK, command_generate(&command, "set inverted 1"));
+  CHECK(command.value.b);
+  CHECK_EQUAL(RET_OK, command_generate(&command, "set inverted 0"));
+  CHECK(!command.value.b);
+
+
+  // Words after the ones a command needs are ignored
+  CHECK_EQUAL(RET_OK, command_generate(&command, "set arm_status 2 extra"));
+  CHECK_EQUAL(2, command.value.i);
+
+  CHECK_EQUAL(RET_ERROR, command_generate(&command, ""));
+  CHECK_EQUAL(RET_ERROR, command_generate(&command, "unknown_command"));
+  CHECK_EQUAL(RET_ERROR, command_generate(&command, "get"));
+  CHECK_EQUAL(RET_ERROR, command_generate(&command, "get no_such_param"));
+  CHECK_EQUAL(RET_ERROR, command_generate(&command, "set arm_status"));
+  CHECK_EQUAL(RET_ERROR, command_generate(&command, "set arm_status 3x"));
+  CHECK_EQUAL(RET_ERROR, command_generate(&command, "set drive_rpm_1 12.5.1"));
+}
+
+int main(void) {
+  CHECK_EQUAL(RET_OK, command_parser_init());
+  test_tokens();
+  test_lookup();
+  test_generate();
+  return test_summary("test_command_parser");
+}
@@ -0,0 +1,140 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file test_cpu_usage.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Charging processor time to tasks from scripted wake, block and
+ *        idle events, as cpu_monitor reports them from the cycle counter.
+ */
+
+#include "test.h"
+#include "cpu_usage.h"
+
+#define PERIOD 1000
+
+/* A periodic task released every period, running for part of each */
+static void test_periodic(void) {
+  cpu_usage_t cpu;
+
+  cpu_usage_init(&cpu, 1, 0);
+  cpu_usage_set_period(&cpu, 0, PERIOD);
+  cpu_usage_wake(&cpu, 0, 0, true);
+  cpu_usage_block(&cpu, 0, 300);
+  cpu_usage_idle(&cpu, 300, 1000, 0);
+  cpu_usage_wake(&cpu, 0, 1000, true);
+  cpu_usage_block(&cpu, 0, 1200);
+  cpu_usage_idle(&cpu, 1200, 2000, 0);
+  cpu_usage_wake(&cpu, 0, 2000, true);
+  cpu_usage_update(&cpu, 2000);
+
+  CHECK_EQUAL(3, cpu.tasks[0].runs);
+  CHECK_EQUAL(500, cpu.tasks[0].busy);
+  CHECK_EQUAL(300, cpu.tasks[0].worst_run);
+  CHECK_EQUAL(0, cpu.tasks[0].misses);
+  CHECK_EQUAL(1500, cpu.idle);
+  CHECK_EQUAL(2000, cpu.elapsed);
+  CHECK_EQUAL(0, cpu_usage_other(&cpu));
+  CHECK_CLOSE(25.0, cpu_usage_percent(cpu.tasks[0].busy, cpu.elapsed), 1e-3);
+}
+
+/* Waking part way through a run, such as after a bus transfer, carries on
+   the same run */
+static void test_partial_wake(void) {
+  cpu_usage_t cpu;
+
+  cpu_usage_init(&cpu, 1, 0);
+  cpu_usage_set_period(&cpu, 0, PERIOD);
+  cpu_usage_wake(&cpu, 0, 0, true);
+  cpu_usage_block(&cpu, 0, 100);
+  cpu_usage_wake(&cpu, 0, 400, false);
+  cpu_usage_block(&cpu, 0, 600);
+  cpu_usage_wake(&cpu, 0, 1000, true);
+
+  CHECK_EQUAL(2, cpu.tasks[0].runs);
+  CHECK_EQUAL(300, cpu.tasks[0].worst_run);
+  CHECK_EQUAL(0, cpu.tasks[0].misses);
+
+  // A task without a period starts a run on every wake
+  cpu_usage_set_period(&cpu, 0, 0);
+  cpu_usage_block(&cpu, 0, 1050);
+  cpu_usage_wake(&cpu, 0, 1500, false);
+  CHECK_EQUAL(3, cpu.tasks[0].runs);
+}
+
+/* A higher priority task preempts, and the lower one is charged again once
+   it blocks */
+static void test_preemption(void) {
+  cpu_usage_t cpu;
+
+  cpu_usage_init(&cpu, 2, 0);
+  cpu_usage_wake(&cpu, 0, 0, true);
+  cpu_usage_wake(&cpu, 1, 100, true);
+  CHECK_EQUAL(1, cpu.running);
+  cpu_usage_block(&cpu, 1, 150);
+  CHECK_EQUAL(0, cpu.running);
+  cpu_usage_block(&cpu, 0, 400);
+  CHECK_EQUAL(CPU_USAGE_NONE, cpu.running);
+
+  CHECK_EQUAL(350, cpu.tasks[0].busy);
+  CHECK_EQUAL(50, cpu.tasks[1].busy);
+  CHECK_EQUAL(400, cpu.elapsed);
+}
+
+/* A run that blocks for the last time more than a period after its release
+   missed its deadline, counted when the next run is released */
+static void test_deadline_miss(void) {
+  cpu_usage_t cpu;
+
+  cpu_usage_init(&cpu, 1, 0);
+  cpu_usage_set_period(&cpu, 0, PERIOD);
+  cpu_usage_wake(&cpu, 0, 0, true);
+  cpu_usage_block(&cpu, 0, 1200);
+  cpu_usage_wake(&cpu, 0, 1200, true);
+  CHECK_EQUAL(1, cpu.tasks[0].misses);
+  cpu_usage_block(&cpu, 0, 1300);
+  cpu_usage_wake(&cpu, 0, 2200, true);
+  CHECK_EQUAL(1, cpu.tasks[0].misses);
+}
+
+/* Time asleep that the cycle counter missed, interrupts taken while idle
+   and a wrap of the counter */
+static void test_idle_and_wrap(void) {
+  cpu_usage_t cpu;
+  uint32_t start = 0xFFFFFF00;
+
+  cpu_usage_init(&cpu, 1, start);
+  cpu_usage_wake(&cpu, 0, start, true);
+  cpu_usage_block(&cpu, 0, start + 0x80);
+  cpu_usage_idle(&cpu, start + 0x100, start + 0x200, 1000);
+
+  CHECK_EQUAL(0x80, cpu.tasks[0].busy);
+  CHECK_EQUAL(0x100 + 1000, cpu.idle);
+  CHECK_EQUAL(0x200 + 1000, cpu.elapsed);
+  CHECK_EQUAL(0x80, cpu_usage_other(&cpu));
+  CHECK_CLOSE(0.0, cpu_usage_percent(1, 0), 1e-6);
+}
+
+int main(void) {
+  test_periodic();
+  test_partial_wake();
+  test_preemption();
+  test_deadline_miss();
+  test_idle_and_wrap();
+  return test_summary("test_cpu_usage");
+}
@@ -0,0 +1,293 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file test_failsafe.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Receiver dropouts, through the failsafe deadlines and the motor
+ *        loop's stall check in virtual time, and through replayed traces.
+ */
+
+#include <string.h>
+#include "test.h"
+#include "mbed.h"
+#include "failsafe.h"
+#include "states.h"
+#include "task_utils.h"
+#include "utils.h"
+#include "replay.h"
+#include "drive_modes.h"
+#include "host_robot.h"
+#include "comms_host.h"
+
+#define FRAME_US 20000
+
+/* Sticks centred, throttles closed and arm switches on */
+static const uint16_t armed_widths[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS] = {
+  {1460, 1460, 1014, 1440, 1857, 1450},
+  {1202, 1494, 1494, 1494, 1892, 1494}
+};
+
+/* Send a frame from each receiver that is sending, then run whatever
+   timers are due over the next frame period, a millisecond at a time. */
+static void send_frames(thread_args_t *args, bool weapon, bool drive) {
+  int ms;
+
+  if (weapon) {
+    host_robot_pulses(args, 0, armed_widths[0], clock_now_us());
+  }
+  if (drive) {
+    host_robot_pulses(args, 1, armed_widths[1], clock_now_us());
+  }
+  for (ms = 0; ms < FRAME_US / 1000; ms++) {
+    host_ticker_advance(1000);
+    host_timers_run();
+  }
+}
+
+static void test_deadline(void) {
+  static thread_args_t args;
+  uint32_t trips;
+  int i;
+
+  host_robot_init(&args);
+  host_ticker_set(1000);
+  failsafe_init(&args);
+  trips = failsafe_trips();
+
+  for (i = 0; i < 10; i++) {
+    send_frames(&args, true, true);
+  }
+  args.state = STATE_FULLY_ARMED;
+
+  // The drive receiver drops out, its ESCs stop once its deadline expires.
+  // The period after its last frame counts towards the deadline.
+  for (i = 0; i < RC_STALL_TIMEOUT_US / FRAME_US - 2; i++) {
+    send_frames(&args, true, false);
+  }
+  CHECK_EQUAL(STATE_FULLY_ARMED, args.state);
+  CHECK_EQUAL(trips, failsafe_trips());
+  send_frames(&args, true, false);
+  CHECK_EQUAL(STATE_WEAPON_ONLY, args.state);
+  CHECK_EQUAL(trips + 1, failsafe_trips());
+  for (i = 0; i < NUM_DRIVE_ESCS; i++) {
+    CHECK(comms_host_state.stopped[COMMS_OUTPUT_DRIVE_1 + i]);
+  }
+  CHECK(!comms_host_state.stopped[COMMS_OUTPUT_WEAPON_1]);
+  CHECK(failsafe_worst_latency_us() >= RC_STALL_TIMEOUT_US);
+  CHECK(failsafe_worst_latency_us() <= RC_STALL_TIMEOUT_US + 1000);
+
+  // Then the weapon receiver
+  for (i = 0; i < RC_STALL_TIMEOUT_US / FRAME_US; i++) {
+    send_frames(&args, false, false);
+  }
+  CHECK_EQUAL(STATE_DISARMED, args.state);
+  CHECK_EQUAL(trips + 2, failsafe_trips());
+  CHECK(comms_host_state.stopped[COMMS_OUTPUT_WEAPON_1]);
+
+  // A receiver that comes back doesn't rearm anything by itself
+  for (i = 0; i < 10; i++) {
+    send_frames(&args, true, true);
+  }
+  CHECK_EQUAL(STATE_DISARMED, args.state);
+  host_ticker_release();
+}
+
+/* The motor loop's check still lowers the state if a deadline interrupt
+   never fires */
+static void test_poll(void) {
+  static thread_args_t args;
+  int i, channel;
+
+  host_robot_init(&args);
+  host_ticker_set(1000);
+  for (i = 0; i < 10; i++) {
+    send_frames(&args, true, true);
+  }
+  args.state = STATE_FULLY_ARMED;
+  failsafe_poll(&args);
+  CHECK_EQUAL(STATE_FULLY_ARMED, args.state);
+
+  // A single channel of the weapon receiver stops, so no more frames
+  // complete, and no deadline interrupts are run
+  for (i = 0; i < RC_STALL_TIMEOUT_US / FRAME_US - 1; i++) {
+    host_robot_pulses(&args, 1, armed_widths[1], clock_now_us());
+    for (channel = 0; channel < RC_NUMBER_CHANNELS - 1; channel++) {
+      rc_capture_pulse(&args.receiver[0], channel, armed_widths[0][channel], clock_now_us());
+    }
+    host_ticker_advance(FRAME_US);
+    failsafe_poll(&args);
+  }
+  CHECK_EQUAL(STATE_FULLY_ARMED, args.state);
+  host_robot_pulses(&args, 1, armed_widths[1], clock_now_us());
+  host_ticker_advance(FRAME_US);
+  failsafe_poll(&args);
+  CHECK_EQUAL(STATE_DRIVE_ONLY, args.state);
+
+  host_ticker_advance(RC_STALL_TIMEOUT_US);
+  failsafe_poll(&args);
+  CHECK_EQUAL(STATE_DISARMED, args.state);
+  host_ticker_release();
+}
+
+/* A receiver stuck sending widths out of range, such as one holding every
+   output low, fails safe as if it had stopped */
+static void test_out_of_range(void) {
+  static thread_args_t args;
+  static const uint16_t low_widths[RC_NUMBER_CHANNELS] = {700, 700, 700, 700, 700, 700};
+  uint32_t trips;
+  int i;
+
+  host_robot_init(&args);
+  host_ticker_set(1000);
+  failsafe_init(&args);
+  trips = failsafe_trips();
+
+  for (i = 0; i < 10; i++) {
+    send_frames(&args, true, true);
+  }
+  args.state = STATE_FULLY_ARMED;
+
+  for (i = 0; i < RC_STALL_TIMEOUT_US / FRAME_US - 2; i++) {
+    host_robot_pulses(&args, 1, low_widths, clock_now_us());
+    send_frames(&args, true, false);
+  }
+  CHECK_EQUAL(STATE_FULLY_ARMED, args.state);
+  host_robot_pulses(&args, 1, low_widths, clock_now_us());
+  send_frames(&args, true, false);
+  CHECK_EQUAL(STATE_WEAPON_ONLY, args.state);
+  CHECK_EQUAL(trips + 1, failsafe_trips());
+
+  // The motor loop's check agrees, once the channels are past the timeout
+  host_robot_pulses(&args, 1, low_widths, clock_now_us());
+  send_frames(&args, true, false);
+  CHECK(is_drive_stalled(&args));
+  CHECK(!is_weapon_stalled(&args));
+  args.state = STATE_FULLY_ARMED;
+  failsafe_poll(&args);
+  CHECK_EQUAL(STATE_WEAPON_ONLY, args.state);
+  host_ticker_release();
+}
+
+/* The arming task must lower the state when a receiver stalls, even with
+   the stale switch still reading armed */
+static void test_arm_stalled(void) {
+  static thread_args_t args;
+  rc_frame_t frame;
+  int i;
+
+  host_robot_init(&args);
+  host_ticker_set(1000);
+  for (i = 0; i < 10; i++) {
+    send_frames(&args, true, true);
+    read_recv_pw(&args, &frame);
+  }
+  CHECK_EQUAL(STATE_FULLY_ARMED, state_arm(STATE_FULLY_ARMED, &frame, false, false));
+  CHECK_EQUAL(STATE_WEAPON_ONLY, state_arm(STATE_FULLY_ARMED, &frame, true, false));
+  CHECK_EQUAL(STATE_DRIVE_ONLY, state_arm(STATE_FULLY_ARMED, &frame, false, true));
+  CHECK_EQUAL(STATE_DISARMED, state_arm(STATE_FULLY_ARMED, &frame, true, true));
+  CHECK_EQUAL(STATE_DISARMED, state_arm(STATE_DRIVE_ONLY, &frame, true, false));
+  CHECK_EQUAL(STATE_DISARMED, state_arm(STATE_WEAPON_ONLY, &frame, false, true));
+  host_ticker_release();
+}
+
+/* A record of a cycle in which the given receivers sent a whole frame */
+static void trace_record(blackbox_record_t *record, uint32_t time_us, bool weapon, bool drive) {
+  memset(record, 0x00, sizeof(blackbox_record_t));
+  record->time_us = time_us;
+  memcpy(record->width_us, armed_widths, sizeof(record->width_us));
+  record->fresh = (uint16_t) ((weapon ? 0x003F : 0) | (drive ? 0x0FC0 : 0));
+  record->state = STATE_FULLY_ARMED;
+}
+
+/* Replay a trace in which one receiver drops out, and return the number of
+   cycles after its last frame that the state was lowered */
+static int replay_dropout(int controller, state_t *lowered) {
+  static replay_t replay;
+  blackbox_record_t record, result;
+  uint32_t now = 5000000;
+  int i;
+
+  replay_init(&replay, host_robot_limits, (const drive_mode_t *) &drive_modes[DM_2_WHEEL_DIFFERENTIAL],
+    (const weapon_mode_t *) &weapon_modes[WM_MANUAL_THROTTLE], RC_FILTER_STAGES);
+  for (i = 0; i < 20; i++, now += FRAME_US) {
+    trace_record(&record, now, true, true);
+    replay_cycle(&replay, &record, &result);
+  }
+  CHECK_EQUAL(STATE_FULLY_ARMED, result.state);
+
+  for (i = 1; i < 50; i++, now += FRAME_US) {
+    trace_record(&record, now, controller != 0, controller != 1);
+    replay_cycle(&replay, &record, &result);
+    if (result.state != STATE_FULLY_ARMED) {
+      *lowered = (state_t) result.state;
+      return i;
+    }
+  }
+  return -1;
+}
+
+/* As replay_dropout(), with the drive receiver sending widths out of range
+   instead of stopping */
+static int replay_out_of_range(void) {
+  static replay_t replay;
+  blackbox_record_t record, result;
+  uint32_t now = 5000000;
+  int i, channel;
+
+  replay_init(&replay, host_robot_limits, (const drive_mode_t *) &drive_modes[DM_2_WHEEL_DIFFERENTIAL],
+    (const weapon_mode_t *) &weapon_modes[WM_MANUAL_THROTTLE], RC_FILTER_STAGES);
+  for (i = 0; i < 20; i++, now += FRAME_US) {
+    trace_record(&record, now, true, true);
+    replay_cycle(&replay, &record, &result);
+  }
+
+  for (i = 1; i < 50; i++, now += FRAME_US) {
+    trace_record(&record, now, true, true);
+    for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
+      record.width_us[1][channel] = 700;
+    }
+    replay_cycle(&replay, &record, &result);
+    if (result.state != STATE_FULLY_ARMED) {
+      CHECK_EQUAL(STATE_WEAPON_ONLY, result.state);
+      return i;
+    }
+  }
+  return -1;
+}
+
+static void test_replay_dropouts(void) {
+  state_t lowered = STATE_FULLY_ARMED;
+
+  // The first cycle RC_STALL_TIMEOUT_US after the last frame, as the
+  // deadline interrupt in test_deadline()
+  CHECK_EQUAL(RC_STALL_TIMEOUT_US / FRAME_US, replay_dropout(1, &lowered));
+  CHECK_EQUAL(STATE_WEAPON_ONLY, lowered);
+  CHECK_EQUAL(RC_STALL_TIMEOUT_US / FRAME_US, replay_dropout(0, &lowered));
+  CHECK_EQUAL(STATE_DRIVE_ONLY, lowered);
+  CHECK_EQUAL(RC_STALL_TIMEOUT_US / FRAME_US, replay_out_of_range());
+}
+
+int main(void) {
+  test_deadline();
+  test_poll();
+  test_out_of_range();
+  test_arm_stalled();
+  test_replay_dropouts();
+  return test_summary("test_failsafe");
+}
@@ -0,0 +1,195 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file test_heading_lock.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Closes the heading controller around a model of the robot turning,
+ *        and checks how quickly and how cleanly it reaches the locked
+ *        heading.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include "test.h"
+#include "config.h"
+#include "heading_lock.h"
+#include "tmath.h"
+
+/* The controller runs at the fusion rate, the plant is stepped faster */
+#define SAMPLE_HZ 100
+#define PLANT_STEPS 10
+
+/* Yaw rate at full rotation command, and how quickly the robot gets to
+   it, roughly a 2 wheel drive robot on a smooth floor */
+#define PLANT_MAX_RATE 360.0f
+#define PLANT_TAU_S 0.15f
+
+#define SIM_SECONDS 5.0f
+
+/**
+ * A robot turning: the rotation command sets the yaw rate it accelerates
+ * towards, a disturbance (e.g. a wheel dragging) adds to it.
+ */
+typedef struct {
+  float heading;
+  float rate;
+  float disturbance;
+  bool blocked;
+} plant_t;
+
+static void plant_step(plant_t *plant, float command, float dt) {
+  float target = command * PLANT_MAX_RATE + plant->disturbance;
+
+  if (plant->blocked) {
+    plant->rate = 0;
+    return;
+  }
+  plant->rate += (target - plant->rate) * dt / PLANT_TAU_S;
+  plant->heading = fmodf(plant->heading + plant->rate * dt + 360.0f, 360.0f);
+}
+
+typedef struct {
+  /*! Time from the start until the error stays within the deadband and a
+      degree, -1 if it never does (seconds). */
+  float settle_s;
+
+  /*! Largest error past the setpoint, against the first error (degrees). */
+  float overshoot;
+
+  /*! Error at the end (degrees). */
+  float final_error;
+} sim_result_t;
+
+/* Run the controller from heading start to setpoint. The plant is held
+   still for the first blocked_s seconds. */
+static sim_result_t simulate(const pid_gains_t *gains, float start, float setpoint,
+    float disturbance, float blocked_s) {
+  heading_pid_t pid;
+  plant_t plant;
+  sim_result_t result;
+  float dt = 1.0f / SAMPLE_HZ;
+  float t, error, first_error, command = 0;
+  int i;
+
+  heading_pid_reset(&pid);
+  plant.heading = start;
+  plant.rate = 0;
+  plant.disturbance = disturbance;
+  result.settle_s = -1;
+  result.overshoot = 0;
+  first_error = heading_error(setpoint, start);
+
+  for (t = 0; t < SIM_SECONDS; t += dt) {
+    plant.blocked = (t < blocked_s);
+    error = heading_error(setpoint, plant.heading);
+    command = heading_pid_update(&pid, gains, error, plant.rate, dt,
+      HEADING_LOCK_DEADBAND, HEADING_LOCK_SPEED / 100.0f);
+    for (i = 0; i < PLANT_STEPS; i++) {
+      plant_step(&plant, command, dt / PLANT_STEPS);
+    }
+
+    if (fabsf(error) > HEADING_LOCK_DEADBAND + 1.0f) {
+      result.settle_s = -1;
+    } else if (result.settle_s < 0) {
+      result.settle_s = t;
+    }
+    // Past the setpoint is an error of the opposite sign to the first
+    if (error * first_error < 0 && fabsf(error) > result.overshoot) {
+      result.overshoot = fabsf(error);
+    }
+  }
+  result.final_error = heading_error(setpoint, plant.heading);
+  return result;
+}
+
+static const pid_gains_t default_gains = {HEADING_LOCK_KP, HEADING_LOCK_KI, HEADING_LOCK_KD};
+
+static void report(const char *name, const sim_result_t *result) {
+  printf("  %-40s settles in %4.2f s, overshoot %5.2f deg, error %5.2f deg\n",
+    name, result->settle_s, result->overshoot, result->final_error);
+}
+
+static void test_step(void) {
+  sim_result_t result;
+
+  result = simulate(&default_gains, 0.0f, 90.0f, 0.0f, 0.0f);
+  report("90 degree step", &result);
+  CHECK(result.settle_s > 0 && result.settle_s < 1.5f);
+  CHECK(result.overshoot < 5.0f);
+  CHECK(fabsf(result.final_error) <= HEADING_LOCK_DEADBAND + 1.0f);
+
+  // Round the short way, through north
+  result = simulate(&default_gains, 350.0f, 20.0f, 0.0f, 0.0f);
+  report("30 degree step through north", &result);
+  CHECK(result.settle_s > 0 && result.settle_s < 1.0f);
+  CHECK(fabsf(result.final_error) <= HEADING_LOCK_DEADBAND + 1.0f);
+
+  result = simulate(&default_gains, 0.0f, 180.0f, 0.0f, 0.0f);
+  report("180 degree step", &result);
+  CHECK(result.settle_s > 0 && result.settle_s < 2.0f);
+}
+
+/* A steady disturbance leaves an error proportional control can't remove,
+   the integral term does */
+static void test_disturbance(void) {
+  pid_gains_t gains = default_gains;
+  sim_result_t proportional, integral;
+
+  proportional = simulate(&gains, 0.0f, 0.0f, 20.0f, 0.0f);
+  report("20 deg/s disturbance, ki 0", &proportional);
+  gains.ki = 0.02f;
+  integral = simulate(&gains, 0.0f, 0.0f, 20.0f, 0.0f);
+  report("20 deg/s disturbance, ki 0.02", &integral);
+  CHECK(fabsf(integral.final_error) <= HEADING_LOCK_DEADBAND + 1.0f);
+  CHECK(fabsf(integral.final_error) < fabsf(proportional.final_error));
+}
+
+/* Held against the arena wall with the output saturated, the integral
+   must not wind up and throw the robot past the heading once it is free */
+static void test_windup(void) {
+  pid_gains_t gains = default_gains;
+  sim_result_t result;
+
+  gains.ki = 0.02f;
+  result = simulate(&gains, 0.0f, 90.0f, 0.0f, 2.0f);
+  report("90 degree step, held for 2 s", &result);
+  CHECK(result.settle_s > 0 && result.settle_s < 2.0f + 2.0f);
+  CHECK(result.overshoot < 10.0f);
+}
+
+/* Nothing happens inside the deadband, so the robot doesn't hunt */
+static void test_deadband(void) {
+  heading_pid_t pid;
+  float command;
+
+  heading_pid_reset(&pid);
+  command = heading_pid_update(&pid, &default_gains, HEADING_LOCK_DEADBAND / 2.0f, 0.0f,
+    1.0f / SAMPLE_HZ, HEADING_LOCK_DEADBAND, 1.0f);
+  CHECK_CLOSE(0.0, command, 1e-6);
+  CHECK_CLOSE(180.0, fabsf(heading_error(0.0f, 180.0f)), 1e-3);
+  CHECK_CLOSE(-20.0, heading_error(350.0f, 10.0f), 1e-3);
+}
+
+int main(void) {
+  test_step();
+  test_disturbance();
+  test_windup();
+  test_deadband();
+  return test_summary("test_heading_lock");
+}
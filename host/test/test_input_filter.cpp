@@ -0,0 +1,117 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file test_input_filter.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Steps and glitches through the receiver input filter, and how many
+ *        frames each takes to reach the output.
+ */
+
+#include <string.h>
+#include "test.h"
+#include "config.h"
+#include "rc_input.h"
+
+#define STAGES (RC_FILTER_RANGE | RC_FILTER_STEP | RC_FILTER_MEDIAN)
+
+/* Filter one width on one channel. Returns the filtered width, or 0 if the
+   width was rejected. */
+static int filter_width(input_filter_t *filter, int controller, int channel, uint16_t width_us) {
+  rc_raw_frame_t raw;
+
+  memset(&raw, 0x00, sizeof(raw));
+  raw.width_us[controller][channel] = width_us;
+  raw.fresh[controller] = 1U << channel;
+  input_filter_run(filter, &raw);
+  return (raw.fresh[controller] & (1U << channel)) ? raw.width_us[controller][channel] : 0;
+}
+
+/* Settle a channel at width_us */
+static void settle(input_filter_t *filter, int controller, int channel, uint16_t width_us) {
+  int i;
+
+  for (i = 0; i < 3; i++) {
+    CHECK_EQUAL(width_us, filter_width(filter, controller, channel, width_us));
+  }
+}
+
+/* Frames a step takes to reach the output, 0 if it gets there in the frame
+   it arrives */
+static int step_latency(int controller, int channel, uint16_t from_us, uint16_t to_us) {
+  input_filter_t filter;
+  int frames;
+
+  input_filter_init(&filter, STAGES);
+  settle(&filter, controller, channel, from_us);
+  for (frames = 0; frames < 10; frames++) {
+    if (filter_width(&filter, controller, channel, to_us) == to_us) {
+      return frames;
+    }
+  }
+  return frames;
+}
+
+static void test_step_latency(void) {
+  // Small moves go straight through the median, it lags them by a frame
+  CHECK_EQUAL(1, step_latency(1, RC_1_AILERON, 1500, 1800));
+  // Steps wait for one confirming width, then the median starts again
+  CHECK_EQUAL(1, step_latency(1, RC_1_AILERON, 1500, 1950));
+  CHECK_EQUAL(1, step_latency(1, RC_1_AILERON, 1950, 1050));
+  CHECK_EQUAL(1, step_latency(0, RC_0_THROTTLE, 1000, 1900));
+  // Throttles closing and switches are never held
+  CHECK_EQUAL(0, step_latency(0, RC_0_THROTTLE, 1900, 1000));
+  CHECK_EQUAL(0, step_latency(1, RC_1_THROTTLE, 1900, 1000));
+  CHECK_EQUAL(0, step_latency(0, RC_0_ARM_SWITCH, 1000, 2000));
+  CHECK_EQUAL(0, step_latency(1, RC_1_ARM_SWITCH, 2000, 1000));
+}
+
+static void test_glitches(void) {
+  input_filter_t filter;
+
+  input_filter_init(&filter, STAGES);
+  settle(&filter, 1, RC_1_AILERON, 1500);
+
+  // A single frame glitch never reaches the output
+  CHECK_EQUAL(0, filter_width(&filter, 1, RC_1_AILERON, 2000));
+  CHECK_EQUAL(1500, filter_width(&filter, 1, RC_1_AILERON, 1500));
+  CHECK_EQUAL(1, filter.channel[1][RC_1_AILERON].rejected);
+
+  // Nor do glitches that disagree with each other
+  CHECK_EQUAL(0, filter_width(&filter, 1, RC_1_AILERON, 2000));
+  CHECK_EQUAL(0, filter_width(&filter, 1, RC_1_AILERON, 1000));
+  CHECK_EQUAL(1500, filter_width(&filter, 1, RC_1_AILERON, 1500));
+  CHECK_EQUAL(3, filter.channel[1][RC_1_AILERON].rejected);
+
+  // A confirmed step isn't dragged back by the widths before it
+  CHECK_EQUAL(0, filter_width(&filter, 1, RC_1_AILERON, 2000));
+  CHECK_EQUAL(2010, filter_width(&filter, 1, RC_1_AILERON, 2010));
+  CHECK_EQUAL(2010, filter_width(&filter, 1, RC_1_AILERON, 1990));
+  CHECK_EQUAL(1990, filter_width(&filter, 1, RC_1_AILERON, 1990));
+
+  // Out of range widths are rejected whatever the channel
+  CHECK_EQUAL(0, filter_width(&filter, 1, RC_1_ARM_SWITCH, 700));
+  CHECK_EQUAL(0, filter_width(&filter, 1, RC_1_ARM_SWITCH, 2300));
+  CHECK_EQUAL(2, filter.channel[1][RC_1_ARM_SWITCH].rejected);
+}
+
+int main(void) {
+  test_step_latency();
+  test_glitches();
+  return test_summary("test_input_filter");
+}
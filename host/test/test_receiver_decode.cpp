@@ -0,0 +1,284 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file test_receiver_decode.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Feeds PPM pulse trains and SBUS byte streams to the decoders, on
+ *        their own and through the PPM and SBUS receivers into rc_capture.
+ */
+
+#include <string.h>
+#include "test.h"
+#include "mbed.h"
+#include "receiver_decode.h"
+#include "receiver_ppm.h"
+#include "receiver_sbus.h"
+#include "rc_capture.h"
+
+/* Intervals between the rising edges of an 8 channel PPM receiver
+   (microseconds), 22.5 ms frames with a microsecond or two of jitter. The
+   train starts part way through a frame. */
+static const uint32_t ppm_train_us[] = {
+  1099, 1899, 1500, 1499,
+  10998,
+  1520, 1479, 1011, 1501, 1151, 1879, 1500, 1499,
+  10961,
+  1541, 1459, 1023, 1500, 1199, 1861, 1499, 1500,
+  10918
+};
+
+/* Widths of the two complete frames in ppm_train_us */
+static const uint32_t ppm_frames_us[2][8] = {
+  {1520, 1479, 1011, 1501, 1151, 1879, 1500, 1499},
+  {1541, 1459, 1023, 1500, 1199, 1861, 1499, 1500}
+};
+
+#define PPM_TRAIN_LEN (sizeof(ppm_train_us) / sizeof(ppm_train_us[0]))
+
+/* Decode a train, starting at start_us. Returns the number of channels
+   decoded, with their indices and widths. */
+static int ppm_decode_train(ppm_decoder_t *ppm, const uint32_t *train, int length, uint32_t start_us,
+    int *channels, uint32_t *widths) {
+  uint32_t now = start_us, width;
+  int i, channel, decoded = 0;
+
+  ppm_decode_edge(ppm, now, &width);
+  for (i = 0; i < length; i++) {
+    now += train[i];
+    if ((channel = ppm_decode_edge(ppm, now, &width)) >= 0) {
+      channels[decoded] = channel;
+      widths[decoded] = width;
+      decoded++;
+    }
+  }
+  return decoded;
+}
+
+static void test_ppm_frames(uint32_t start_us) {
+  ppm_decoder_t ppm;
+  int channels[PPM_TRAIN_LEN];
+  uint32_t widths[PPM_TRAIN_LEN];
+  int decoded, frame, channel;
+
+  memset(&ppm, 0x00, sizeof(ppm));
+  decoded = ppm_decode_train(&ppm, ppm_train_us, PPM_TRAIN_LEN, start_us, channels, widths);
+
+  // The channels before the first sync gap can't be numbered
+  CHECK_EQUAL(16, decoded);
+  for (frame = 0; frame < 2; frame++) {
+    for (channel = 0; channel < 8; channel++) {
+      CHECK_EQUAL(channel, channels[frame * 8 + channel]);
+      CHECK_EQUAL(ppm_frames_us[frame][channel], widths[frame * 8 + channel]);
+    }
+  }
+}
+
+/* A missed edge merges two channels into one wide one and shifts the rest,
+   until the next sync gap puts the numbering right. */
+static void test_ppm_missed_edge(void) {
+  static const uint32_t train[] = {
+    10000,
+    1520, 1479, 1011 + 1501, 1151, 1879, 1500, 1499,
+    12462,
+    1541, 1459, 1023
+  };
+  ppm_decoder_t ppm;
+  int channels[16];
+  uint32_t widths[16];
+  int decoded;
+
+  memset(&ppm, 0x00, sizeof(ppm));
+  decoded = ppm_decode_train(&ppm, train, sizeof(train) / sizeof(train[0]), 0, channels, widths);
+  CHECK_EQUAL(10, decoded);
+  CHECK_EQUAL(2, channels[2]);
+  CHECK_EQUAL(2512, widths[2]);
+  CHECK_EQUAL(6, channels[6]);
+  CHECK_EQUAL(0, channels[7]);
+  CHECK_EQUAL(1541, widths[7]);
+  CHECK_EQUAL(2, channels[9]);
+  CHECK_EQUAL(1023, widths[9]);
+}
+
+/* The train through the PPM receiver's edge interrupt into rc_capture,
+   which keeps the first RC_NUMBER_CHANNELS channels. */
+static void test_ppm_receiver(void) {
+  static rc_capture_t capture;
+  InterruptIn *pin;
+  rc_pulse_t pulse;
+  uint32_t i, pulses = 0;
+
+  memset(&capture, 0x00, sizeof(capture));
+  host_ticker_set(1000);
+  receiver_impl_ppm_init(&capture, NULL, p29);
+  pin = (InterruptIn *) capture.device;
+
+  pin->host_rise();
+  for (i = 0; i < PPM_TRAIN_LEN; i++) {
+    host_ticker_advance(ppm_train_us[i]);
+    pin->host_rise();
+    pin->host_fall();
+  }
+
+  CHECK_EQUAL(2, capture.frames);
+  CHECK_EQUAL(0, capture.pulses.dropped());
+  while (capture.pulses.pop(&pulse)) {
+    CHECK(pulse.channel < RC_NUMBER_CHANNELS);
+    CHECK_EQUAL(ppm_frames_us[pulses / RC_NUMBER_CHANNELS][pulse.channel], pulse.width_us);
+    pulses++;
+  }
+  CHECK_EQUAL(2 * RC_NUMBER_CHANNELS, pulses);
+  CHECK_EQUAL(1541, rc_capture_pulsewidth(&capture, 0));
+
+  // Channel 0 is the oldest, it ended 8 edges before the end of the train
+  CHECK_EQUAL(1459 + 1023 + 1500 + 1199 + 1861 + 1499 + 1500 + 10918, rc_capture_max_age_us(&capture));
+}
+
+/* Pack 11 bit channel values into an SBUS frame */
+static void sbus_encode(const uint16_t *values, uint8_t flags, uint8_t end, uint8_t *frame) {
+  uint32_t bit, byte;
+  int i;
+
+  memset(frame, 0x00, SBUS_FRAME_LEN);
+  frame[0] = SBUS_HEADER;
+  for (i = 0; i < SBUS_NUM_CHANNELS; i++) {
+    bit = 11 * i;
+    byte = 1 + bit / 8;
+    frame[byte] |= (uint8_t) (values[i] << (bit % 8));
+    frame[byte + 1] |= (uint8_t) (values[i] >> (8 - bit % 8));
+    if (bit % 8 > 5) {
+      frame[byte + 2] |= (uint8_t) (values[i] >> (16 - bit % 8));
+    }
+  }
+  frame[SBUS_FRAME_LEN - 2] = flags;
+  frame[SBUS_FRAME_LEN - 1] = end;
+}
+
+/* Sticks at minimum, centre and maximum, as a Futaba receiver sends them */
+static const uint16_t sbus_values[SBUS_NUM_CHANNELS] = {
+  172, 992, 1811, 992, 172, 1811, 992, 992, 992, 992, 992, 992, 992, 992, 992, 992
+};
+static const uint16_t sbus_widths_us[6] = {987, 1500, 2011, 1500, 987, 2011};
+
+/* Feed a frame a byte at a time, 120 us apart as at 100000 baud 8E2 */
+static int sbus_feed(sbus_decoder_t *sbus, const uint8_t *bytes, int length, uint32_t *now_us) {
+  int i, frames = 0;
+
+  for (i = 0; i < length; i++) {
+    if (sbus_decode_byte(sbus, bytes[i], *now_us)) {
+      frames++;
+    }
+    *now_us += 120;
+  }
+  return frames;
+}
+
+static void test_sbus_channels(void) {
+  uint8_t frame[SBUS_FRAME_LEN];
+  uint16_t widths[SBUS_NUM_CHANNELS];
+  int i;
+
+  sbus_encode(sbus_values, 0x00, 0x00, frame);
+  CHECK(sbus_frame_channels(frame, widths, SBUS_NUM_CHANNELS));
+  for (i = 0; i < 6; i++) {
+    CHECK_EQUAL(sbus_widths_us[i], widths[i]);
+  }
+  CHECK_EQUAL(1500, widths[15]);
+
+  sbus_encode(sbus_values, SBUS_FLAG_FAILSAFE, 0x00, frame);
+  CHECK(!sbus_frame_channels(frame, widths, SBUS_NUM_CHANNELS));
+
+  // Frame lost alone still has usable channels
+  sbus_encode(sbus_values, SBUS_FLAG_FRAME_LOST, 0x00, frame);
+  CHECK(sbus_frame_channels(frame, widths, SBUS_NUM_CHANNELS));
+}
+
+static void test_sbus_stream(void) {
+  sbus_decoder_t sbus;
+  uint8_t frame[SBUS_FRAME_LEN];
+  uint32_t now = 5000;
+
+  memset(&sbus, 0x00, sizeof(sbus));
+  sbus_encode(sbus_values, 0x00, 0x00, frame);
+
+  // Joining part way through a frame, the tail is ignored
+  CHECK_EQUAL(0, sbus_feed(&sbus, frame + 12, SBUS_FRAME_LEN - 12, &now));
+  now += 4000;
+  CHECK_EQUAL(1, sbus_feed(&sbus, frame, SBUS_FRAME_LEN, &now));
+
+  // SBUS2 end bytes
+  sbus_encode(sbus_values, 0x00, 0x14, frame);
+  now += 4000;
+  CHECK_EQUAL(1, sbus_feed(&sbus, frame, SBUS_FRAME_LEN, &now));
+
+  // Corrupt end byte
+  sbus_encode(sbus_values, 0x00, 0x55, frame);
+  now += 4000;
+  CHECK_EQUAL(0, sbus_feed(&sbus, frame, SBUS_FRAME_LEN, &now));
+
+  // Bytes lost part way through, the gap before the next frame restarts it
+  sbus_encode(sbus_values, 0x00, 0x00, frame);
+  now += 4000;
+  CHECK_EQUAL(0, sbus_feed(&sbus, frame, SBUS_FRAME_LEN - 5, &now));
+  now += 4000;
+  CHECK_EQUAL(1, sbus_feed(&sbus, frame, SBUS_FRAME_LEN, &now));
+}
+
+/* Frames through the SBUS receiver's serial interrupt into rc_capture.
+   Channels are left stale while the receiver flags failsafe. */
+static void test_sbus_receiver(void) {
+  static rc_capture_t capture;
+  uint8_t frame[SBUS_FRAME_LEN];
+  RawSerial *serial;
+  rc_pulse_t pulse;
+  int i;
+
+  memset(&capture, 0x00, sizeof(capture));
+  memset(&pulse, 0x00, sizeof(pulse));
+  host_ticker_set(2000000);
+  receiver_impl_sbus_init(&capture, NULL, p30);
+  serial = (RawSerial *) capture.device;
+
+  sbus_encode(sbus_values, 0x00, 0x00, frame);
+  serial->host_receive(frame, SBUS_FRAME_LEN);
+  CHECK_EQUAL(1, capture.frames);
+  for (i = 0; i < RC_NUMBER_CHANNELS; i++) {
+    CHECK(capture.pulses.pop(&pulse));
+    CHECK_EQUAL(i, pulse.channel);
+    CHECK_EQUAL(sbus_widths_us[i], pulse.width_us);
+  }
+
+  host_ticker_advance(14000);
+  sbus_encode(sbus_values, SBUS_FLAG_FAILSAFE, 0x00, frame);
+  serial->host_receive(frame, SBUS_FRAME_LEN);
+  CHECK_EQUAL(1, capture.frames);
+  CHECK_EQUAL(0, capture.pulses.count());
+  CHECK_EQUAL(14000, rc_capture_max_age_us(&capture));
+}
+
+int main(void) {
+  test_ppm_frames(0);
+  // The capture timer wraps part way through the train
+  test_ppm_frames(0xFFFFFFFFU - 20000);
+  test_ppm_missed_edge();
+  test_ppm_receiver();
+  test_sbus_channels();
+  test_sbus_stream();
+  test_sbus_receiver();
+  return test_summary("test_receiver_decode");
+}
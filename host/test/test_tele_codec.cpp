@@ -0,0 +1,268 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file test_tele_codec.cpp
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Encodes the telemetry table as the robot does and decodes it as the
+ *        ESP8266 side does: metadata, keyframes, deltas and damaged frames.
+ */
+
+#include <string.h>
+#include "test.h"
+#include "tele_codec.h"
+#include "tele_params.h"
+
+/* The table with values that have a realistic number of digits */
+static tele_command_t params[NUM_TELE_COMMANDS];
+
+static void fill_params(float f, int i, bool b) {
+  unsigned n;
+
+  memcpy(params, tele_commands, sizeof(params));
+  for (n = 0; n < NUM_TELE_COMMANDS; n++) {
+    switch (params[n].type) {
+      case CT_FLOAT:
+        params[n].param.f = f * (n + 1);
+        break;
+      case CT_INT:
+        params[n].param.i = i * (int) (n + 1);
+        break;
+      case CT_BOOLEAN:
+        params[n].param.b = b;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+/* Frame and send a frame, then feed it to a decoder a byte at a time.
+   Returns the number of frames the decoder produced. */
+static int send_frame(tele_decoder_t *decoder, const tele_frame_t *frame, tele_frame_t *received) {
+  uint8_t encoded[TELE_ENCODED_MAX_LEN];
+  uint32_t length, i;
+  int frames = 0;
+
+  length = tele_frame_encode(frame, encoded);
+  CHECK(length <= TELE_ENCODED_MAX_LEN);
+  CHECK_EQUAL(0, encoded[length - 1]);
+  for (i = 0; i < length; i++) {
+    if (i < length - 1) {
+      CHECK(encoded[i] != 0);
+    }
+    if (tele_decode_byte(decoder, encoded[i], received)) {
+      frames++;
+    }
+  }
+  return frames;
+}
+
+static void check_values(const tele_value_t *values) {
+  unsigned n;
+
+  for (n = 0; n < NUM_TELE_COMMANDS; n++) {
+    switch (params[n].type) {
+      case CT_FLOAT:
+        CHECK_CLOSE(params[n].param.f, values[n].f, 0.5 / TELE_FLOAT_SCALE);
+        break;
+      case CT_INT:
+        CHECK_EQUAL(params[n].param.i, values[n].i);
+        break;
+      case CT_BOOLEAN:
+        CHECK_EQUAL(params[n].param.b, values[n].b);
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+static void test_crc(void) {
+  const uint8_t check[] = "123456789";
+
+  // The CRC-16/CCITT-FALSE check value
+  CHECK_EQUAL(0x29B1, tele_crc16(0xFFFF, check, 9));
+  CHECK_EQUAL(0x29B1, tele_crc16(tele_crc16(0xFFFF, check, 4), check + 4, 5));
+}
+
+/* Learn the table from its metadata, as the ESP8266 does on connect */
+static void test_meta(tele_command_type_t *types) {
+  tele_decoder_t decoder;
+  tele_frame_t frame, received;
+  tele_header_t header, decoded;
+  tele_command_type_t type;
+  tele_command_unit_t unit;
+  char name[TELE_NAME_MAX_LEN + 1];
+  uint32_t index, n;
+
+  tele_decoder_init(&decoder);
+  header.schema = tele_schema_id(tele_commands, NUM_TELE_COMMANDS);
+  header.sequence = 0;
+  for (n = 0; n < NUM_TELE_COMMANDS; n++) {
+    CHECK(tele_encode_meta(&frame, header, n, &tele_commands[n]));
+    CHECK_EQUAL(1, send_frame(&decoder, &frame, &received));
+    CHECK(tele_decode_header(&received, &decoded));
+    CHECK_EQUAL(TELE_FRAME_META, decoded.type);
+    CHECK_EQUAL(header.schema, decoded.schema);
+    CHECK(tele_decode_meta(&received, &index, &type, &unit, name));
+    CHECK_EQUAL(n, index);
+    CHECK_EQUAL(tele_commands[n].type, type);
+    CHECK_EQUAL(tele_commands[n].unit, unit);
+    CHECK(strcmp(tele_commands[n].name, name) == 0);
+    types[index] = type;
+  }
+  CHECK_EQUAL(0, decoder.errors);
+}
+
+static void test_values(const tele_command_type_t *types) {
+  tele_decoder_t decoder;
+  tele_frame_t frame, received;
+  tele_header_t header, decoded;
+  tele_value_t values[NUM_TELE_COMMANDS];
+
+  fill_params(-123.45f, 12345, true);
+  tele_decoder_init(&decoder);
+  header.schema = tele_schema_id(params, NUM_TELE_COMMANDS);
+  header.sequence = 200;
+  CHECK(tele_encode_values(&frame, header, params, NUM_TELE_COMMANDS));
+  CHECK_EQUAL(1, send_frame(&decoder, &frame, &received));
+  CHECK(tele_decode_header(&received, &decoded));
+  CHECK_EQUAL(TELE_FRAME_VALUES, decoded.type);
+  CHECK_EQUAL(header.schema, decoded.schema);
+  CHECK_EQUAL(200, decoded.sequence);
+  memset(values, 0x00, sizeof(values));
+  CHECK_EQUAL(NUM_TELE_COMMANDS, tele_decode_values(&received, types, values, NUM_TELE_COMMANDS));
+  check_values(values);
+
+  // A decoder that knows a different number of parameters refuses it
+  CHECK_EQUAL(-1, tele_decode_values(&received, types, values, NUM_TELE_COMMANDS - 1));
+}
+
+static void test_delta(const tele_command_type_t *types) {
+  tele_delta_t delta;
+  tele_decoder_t decoder;
+  tele_frame_t frame, received;
+  tele_header_t header, decoded;
+  tele_value_t values[NUM_TELE_COMMANDS];
+  int sent, frame_number;
+
+  fill_params(12.5f, 100, false);
+  tele_decoder_init(&decoder);
+  tele_delta_init(&delta, 4);
+  header.schema = tele_schema_id(params, NUM_TELE_COMMANDS);
+  header.sequence = 0;
+  memset(values, 0x00, sizeof(values));
+
+  // The first frame is a keyframe
+  sent = tele_encode_delta(&frame, header, &delta, params, NUM_TELE_COMMANDS);
+  CHECK_EQUAL(NUM_TELE_COMMANDS, sent);
+  CHECK_EQUAL(1, send_frame(&decoder, &frame, &received));
+  CHECK(tele_decode_header(&received, &decoded));
+  CHECK_EQUAL(TELE_FRAME_VALUES, decoded.type);
+  CHECK_EQUAL(NUM_TELE_COMMANDS, tele_decode_values(&received, types, values, NUM_TELE_COMMANDS));
+
+  // Nothing has changed, so there is nothing to send
+  CHECK_EQUAL(0, tele_encode_delta(&frame, header, &delta, params, NUM_TELE_COMMANDS));
+
+  // One value moves past its deadband, another stays within it
+  params[CID_DRIVE_RPM_1].param.f += 2 * tele_commands[CID_DRIVE_RPM_1].deadband;
+  params[CID_DRIVE_RPM_2].param.f += tele_commands[CID_DRIVE_RPM_2].deadband / 2;
+  params[CID_ARM_STATUS].param.i = 3;
+  sent = tele_encode_delta(&frame, header, &delta, params, NUM_TELE_COMMANDS);
+  CHECK_EQUAL(2, sent);
+  CHECK_EQUAL(1, send_frame(&decoder, &frame, &received));
+  CHECK(tele_decode_header(&received, &decoded));
+  CHECK_EQUAL(TELE_FRAME_DELTA, decoded.type);
+  CHECK_EQUAL(2, tele_decode_delta(&received, types, values, NUM_TELE_COMMANDS));
+  CHECK_CLOSE(params[CID_DRIVE_RPM_1].param.f, values[CID_DRIVE_RPM_1].f, 0.5 / TELE_FLOAT_SCALE);
+  CHECK_CLOSE(12.5f * (CID_DRIVE_RPM_2 + 1), values[CID_DRIVE_RPM_2].f, 0.5 / TELE_FLOAT_SCALE);
+  CHECK_EQUAL(3, values[CID_ARM_STATUS].i);
+
+  // A delta naming a parameter the decoder doesn't know is refused
+  CHECK_EQUAL(-1, tele_decode_delta(&received, types, values, CID_DRIVE_RPM_1));
+
+  // Every value is sent again once the keyframe interval is up
+  for (frame_number = 0; frame_number < 4; frame_number++) {
+    sent = tele_encode_delta(&frame, header, &delta, params, NUM_TELE_COMMANDS);
+    if (sent == NUM_TELE_COMMANDS) {
+      break;
+    }
+  }
+  CHECK_EQUAL(NUM_TELE_COMMANDS, sent);
+  CHECK_EQUAL(1, send_frame(&decoder, &frame, &received));
+  CHECK_EQUAL(NUM_TELE_COMMANDS, tele_decode_values(&received, types, values, NUM_TELE_COMMANDS));
+  check_values(values);
+  CHECK_EQUAL(0, decoder.errors);
+}
+
+/* Damaged frames are dropped, and the next frame is still decoded */
+static void test_damaged(const tele_command_type_t *types) {
+  const uint8_t noise[] = {0x12, 0x00, 0x55, 0xAA, 0x03, 0x00};
+  tele_decoder_t decoder;
+  tele_frame_t frame, received;
+  tele_header_t header;
+  tele_value_t values[NUM_TELE_COMMANDS];
+  uint8_t encoded[TELE_ENCODED_MAX_LEN];
+  uint32_t length, i;
+  int frames = 0;
+
+  fill_params(1.25f, 7, true);
+  tele_decoder_init(&decoder);
+  header.schema = tele_schema_id(params, NUM_TELE_COMMANDS);
+  header.sequence = 1;
+  CHECK(tele_encode_values(&frame, header, params, NUM_TELE_COMMANDS));
+  length = tele_frame_encode(&frame, encoded);
+
+  // A flipped bit fails the CRC
+  encoded[length / 2] ^= 0x10;
+  for (i = 0; i < length; i++) {
+    frames += tele_decode_byte(&decoder, encoded[i], &received) ? 1 : 0;
+  }
+  CHECK_EQUAL(0, frames);
+  CHECK_EQUAL(1, decoder.errors);
+
+  // Line noise between frames
+  for (i = 0; i < sizeof(noise); i++) {
+    frames += tele_decode_byte(&decoder, noise[i], &received) ? 1 : 0;
+  }
+  CHECK_EQUAL(0, frames);
+
+  // A frame that starts part way through is dropped at its delimiter
+  encoded[length / 2] ^= 0x10;
+  for (i = length / 2; i < length; i++) {
+    frames += tele_decode_byte(&decoder, encoded[i], &received) ? 1 : 0;
+  }
+  CHECK_EQUAL(0, frames);
+
+  CHECK_EQUAL(1, send_frame(&decoder, &frame, &received));
+  memset(values, 0x00, sizeof(values));
+  CHECK_EQUAL(NUM_TELE_COMMANDS, tele_decode_values(&received, types, values, NUM_TELE_COMMANDS));
+  check_values(values);
+}
+
+int main(void) {
+  tele_command_type_t types[NUM_TELE_COMMANDS];
+
+  test_crc();
+  test_meta(types);
+  test_values(types);
+  test_delta(types);
+  test_damaged(types);
+  return test_summary("test_tele_codec");
+}
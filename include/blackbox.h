@@ -0,0 +1,132 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * @file blackbox.h
+ * @author Cameron A. Craig
+ * @date 18 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Flight recorder, keeps what the control loop saw and commanded in
+ *        the last few seconds in a ring of compact binary records.
+ */
+
+#ifndef TC_BLACKBOX_H
+#define TC_BLACKBOX_H
+
+#include <stdint.h>
+#include "config.h"
+#include "types.h"
+#include "rc_input.h"
+#include "bno055_decode.h"
+#include "loop_stats.h"
+
+/* Set in blackbox_record_t::flags */
+#define BLACKBOX_FLAG_INVERTED 0x01  // Controls were remapped for an inverted robot
+#define BLACKBOX_FLAG_HEADING_LOCK 0x02  // Heading lock was on
+
+/**
+ * One control loop cycle. Values are copied as they are rather than
+ * converted, which costs far more than the copy without an FPU. Fields are
+ * ordered so that there is no padding between them, tools/blackbox_csv.py
+ * unpacks the same layout.
+ */
+typedef struct {
+  /*! Start of the cycle, from clock_now_us() (microseconds). */
+  uint32_t time_us;
+
+  /*! Pulse widths before filtering, channels without a new pulse this
+      cycle repeat their last width (microseconds). */
+  uint16_t width_us[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS];
+
+  /*! Bit controller * RC_NUMBER_CHANNELS + channel is set for each channel
+      that had a new pulse this cycle. */
+  uint16_t fresh;
+
+  /*! Arm state, a state_t. */
+  uint8_t state;
+
+  /*! BLACKBOX_FLAG_* bits. */
+  uint8_t flags;
+
+  /*! Channel values after filtering and calibration. */
+  rc_controls_t controls[RC_NUMBER_CONTROLLERS];
+
+  /*! Latest orientation (degrees). */
+  euler_t orientation;
+
+  /*! Outputs sent to the ESCs (0 - 100). */
+  uint8_t wheel[MAX_DRIVE_WHEELS];
+  uint8_t weapon[3];
+} blackbox_record_t;
+
+/* Each 16KB AHB SRAM bank holds a half of the ring. Nothing else on this
+   robot uses them, they are meant for USB and Ethernet buffers. 326 records
+   keep the last 6.5 seconds at the 50 Hz receiver frame rate. */
+#define BLACKBOX_BANK_BYTES (16 * 1024)
+#define BLACKBOX_BANK_RECORDS (BLACKBOX_BANK_BYTES / sizeof(blackbox_record_t))
+#define BLACKBOX_RECORDS (2 * BLACKBOX_BANK_RECORDS)
+
+/**
+ * Position of the ring, and the cost of recording.
+ */
+typedef struct {
+  /*! Records written since the ring was cleared, the newest is at
+      (written - 1) % BLACKBOX_RECORDS. */
+  volatile uint32_t written;
+
+  /*! Set while the ring is being read out, so it does not move. */
+  volatile bool paused;
+
+  /*! Time taken by blackbox_record(), measured by the caller. */
+  timing_histogram_t cost;
+} blackbox_t;
+
+/**
+* @brief Empty the ring.
+* @param [out] blackbox Recorder to initialise.
+*/
+void blackbox_init(blackbox_t *blackbox);
+
+/**
+* @brief Append a record of one control loop cycle, overwriting the oldest
+*        once the ring is full. Does nothing while paused.
+* @param [in/out] blackbox Recorder.
+* @param [in] time_us Start of the cycle (microseconds).
+* @param [in] raw Pulse widths before filtering.
+* @param [in] frame Channel values.
+* @param [in] outputs ESC outputs.
+* @param [in] state Arm state.
+* @param [in] orientation Latest orientation.
+* @param [in] flags BLACKBOX_FLAG_* bits.
+*/
+void blackbox_record(blackbox_t *blackbox, uint32_t time_us, const rc_raw_frame_t *raw,
+                     const rc_frame_t *frame, const struct rc_outputs_t *outputs, int state,
+                     const euler_t *orientation, uint8_t flags);
+
+/**
+* @param [in] blackbox Recorder.
+* @return Number of records held in the ring.
+*/
+uint32_t blackbox_count(const blackbox_t *blackbox);
+
+/**
+* @brief Read a record, the ring should be paused so it does not move.
+* @param [in] blackbox Recorder.
+* @param [in] index Record to read, 0 is the oldest.
+* @return The record, or NULL if index is not below blackbox_count().
+*/
+const blackbox_record_t * blackbox_get(const blackbox_t *blackbox, uint32_t index);
+
+#endif  // TC_BLACKBOX_H
@@ -34,6 +34,8 @@
 #include <stdint.h>
 
 #include "mbed.h"
+#include "bno055_decode.h"
+#include "i2c_engine.h"
 
 
 const int bno055_addr = 0x28 << 1;
@@ -48,6 +50,67 @@ const int BNO055_SYS_STAT_ADDR                                    = 0x39;
 const int BNO055_SYS_ERR_ADDR                                     = 0x3A;
 const int BNO055_AXIS_MAP_CONFIG_ADDR                             = 0x41;
 const int BNO055_SYS_TRIGGER_ADDR                                 = 0x3F;
+const int BNO055_PAGE_ID_ADDR                                     = 0x07;
+
+/* Page 1 registers */
+const int BNO055_ACC_CONFIG_ADDR                                  = 0x08;
+const int BNO055_GYR_CONFIG_0_ADDR                                = 0x0A;
+const int BNO055_INT_MSK_ADDR                                     = 0x0F;
+const int BNO055_INT_EN_ADDR                                      = 0x10;
+
+/* SYS_TRIGGER bits */
+const char BNO055_SYS_TRIGGER_RST_INT                             = 0x40;
+const char BNO055_SYS_TRIGGER_CLK_SEL                             = 0x80;
+
+/* INT_MSK and INT_EN bit for accelerometer / fusion data ready. */
+const char BNO055_INT_ACC_BSX_DRDY                                = 0x01;
+
+/* The fusion modes produce data at a fixed rate. */
+#define BNO055_FUSION_RATE_HZ 100
+
+/**
+ * Operating modes, the values written to OPR_MODE.
+ */
+typedef enum {
+  BNO055_MODE_CONFIG = 0x00,
+  /*! Raw accelerometer and gyroscope, no fusion. */
+  BNO055_MODE_ACCGYRO = 0x05,
+  /*! Fusion of accelerometer and gyroscope, relative heading. */
+  BNO055_MODE_IMU = 0x08,
+  /*! Full fusion without fast magnetometer calibration. */
+  BNO055_MODE_NDOF_FMC_OFF = 0x0B,
+  /*! Full fusion, absolute heading. */
+  BNO055_MODE_NDOF = 0x0C
+} bno055_mode_t;
+
+/**
+ * How the BNO055 is set up and read.
+ */
+typedef struct {
+  bno055_mode_t mode;
+
+  /*! Output data rate in the raw modes. The sensor bandwidths are set to
+      give at least this rate; the fusion modes always run at
+      BNO055_FUSION_RATE_HZ. */
+  uint32_t raw_rate_hz;
+
+  /*! Raise the INT pin each time new data is ready. */
+  bool data_ready_int;
+} bno055_config_t;
+
+/**
+ * Reads of the data registers, to compare with the rate data is produced.
+ */
+typedef struct {
+  uint32_t samples;
+
+  /*! Reads that returned exactly the previous sample, because the sensor
+      had not updated yet. */
+  uint32_t duplicates;
+
+  /*! New samples over the last whole second. */
+  uint32_t samples_per_sec;
+} bno055_stats_t;
 
 typedef struct
 {
@@ -57,21 +120,6 @@ typedef struct
     int sys;
 } calib_status_t;
 
-typedef struct {
-  union {
-    struct {
-      float heading;
-      float pitch;
-      float roll;
-    };
-    struct {
-      float x;
-      float y;
-      float z;
-    };
-  };
-} euler_t;
-
 
 void bno055_write_reg(int regAddr, char value);
 
@@ -81,11 +129,64 @@ calib_status_t bno055_read_calibration_status();
 
 bool bno055_healthy();
 
-bool bno055_init();
-
-euler_t bno055_read_euler_angles();
-euler_t bno055_read_accel();
-
-uint8_t bno055_read_temp();
+/**
+* @brief Check the sensor is present and set its operating mode.
+* @param [in] engine Bus the sensor is on.
+* @param [in] config Operating mode, data rate and interrupt use.
+* @return true on success, false if the sensor did not respond correctly.
+*/
+bool bno055_init(i2c_engine_t *engine, const bno055_config_t *config);
+
+/**
+* @param [in] config Operating mode and data rate.
+* @return Rate at which the sensor produces new data (Hz).
+*/
+uint32_t bno055_data_rate_hz(const bno055_config_t *config);
+
+/**
+* @param [in] config Operating mode.
+* @return true if the mode fuses the sensors into a heading, false for the
+*         raw modes, whose Euler angle registers are not updated.
+*/
+bool bno055_fusion_mode(const bno055_config_t *config);
+
+/**
+* @brief Clear a latched interrupt, so INT is raised for the next sample.
+*/
+void bno055_clear_interrupt();
+
+/**
+ * A burst read of the data registers in progress.
+ */
+typedef struct {
+  i2c_transaction_t transaction;
+  char reg;
+  char data[BNO055_DATA_LEN];
+} bno055_read_t;
+
+/**
+* @brief Queue a burst read of every measurement without waiting for it.
+* @param [out] read Read in progress, must stay valid until it finishes.
+* @param [in] notify Thread to signal when the read finishes, may be NULL.
+* @param [in] signal Signal flags to set.
+* @return RET_OK if queued, RET_ERROR if the bus queue is full.
+*/
+int bno055_request_sample(bno055_read_t *read, Thread *notify, int32_t signal);
+
+/**
+* @brief Decode a read queued by bno055_request_sample() once it finishes.
+* @param [in] read Finished read.
+* @param [out] sample Decoded measurements.
+* @return true on success, false if the read failed or has not finished.
+*/
+bool bno055_sample_result(const bno055_read_t *read, bno055_sample_t *sample);
+
+/**
+* @brief Read every measurement in one burst of the data registers, sleeping
+*        until the read has finished.
+* @param [out] sample Decoded measurements.
+* @return true on success, false if the sensor did not respond.
+*/
+bool bno055_read_sample(bno055_sample_t *sample);
 
 #endif //TC_BNO055_H
@@ -0,0 +1,111 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file bno055_decode.h
+ * @author Cameron A. Craig
+ * @date 10 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Decodes the BNO055 data registers. Nothing here depends on mbed,
+ *        so register dumps can be decoded off target.
+ */
+
+#ifndef TC_BNO055_DECODE_H
+#define TC_BNO055_DECODE_H
+
+#include <stdint.h>
+
+/* The data registers run contiguously from the accelerometer X LSB to the
+   temperature, so one burst read returns every measurement. */
+#define BNO055_DATA_START_ADDR 0x08
+#define BNO055_DATA_LEN (0x34 - BNO055_DATA_START_ADDR + 1)
+
+/* Offsets of each measurement within a burst read. */
+#define BNO055_DATA_ACCEL 0x00
+#define BNO055_DATA_MAG 0x06
+#define BNO055_DATA_GYRO 0x0C
+#define BNO055_DATA_EULER 0x12
+#define BNO055_DATA_QUATERNION 0x18
+#define BNO055_DATA_LINEAR_ACCEL 0x20
+#define BNO055_DATA_GRAVITY 0x26
+#define BNO055_DATA_TEMP 0x2C
+
+/* LSBs per unit with the power on default unit selection. */
+#define BNO055_ACCEL_LSB_PER_MPSPS 100.0f
+#define BNO055_MAG_LSB_PER_UT 16.0f
+#define BNO055_GYRO_LSB_PER_DPS 16.0f
+#define BNO055_EULER_LSB_PER_DEGREE 16.0f
+#define BNO055_QUATERNION_LSB 16384.0f
+
+typedef struct {
+  union {
+    struct {
+      float heading;
+      float pitch;
+      float roll;
+    };
+    struct {
+      float x;
+      float y;
+      float z;
+    };
+  };
+} euler_t;
+
+typedef struct {
+  float w;
+  float x;
+  float y;
+  float z;
+} quaternion_t;
+
+/**
+ * Every measurement from one burst read of the data registers.
+ */
+typedef struct {
+  /*! Acceleration including gravity (m/s/s). */
+  euler_t accel;
+
+  /*! Magnetic field (micro Tesla). */
+  euler_t mag;
+
+  /*! Rate of rotation (degrees per second). */
+  euler_t gyro;
+
+  /*! Fused orientation (degrees). */
+  euler_t euler;
+
+  /*! Fused orientation (unit quaternion). */
+  quaternion_t quaternion;
+
+  /*! Acceleration with gravity removed (m/s/s). */
+  euler_t linear_accel;
+
+  /*! Gravity vector (m/s/s). */
+  euler_t gravity;
+
+  /*! Temperature (degrees Celsius). */
+  int8_t temp;
+} bno055_sample_t;
+
+/**
+* @brief Decode a burst read of the data registers.
+* @param [in] data BNO055_DATA_LEN bytes read from BNO055_DATA_START_ADDR.
+* @param [out] sample Decoded measurements.
+*/
+void bno055_decode_sample(const uint8_t *data, bno055_sample_t *sample);
+
+#endif  // TC_BNO055_DECODE_H
@@ -0,0 +1,47 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file clock.h
+ * @author Cameron A. Craig
+ * @date 17 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Monotonic 64 bit microsecond time base.
+ */
+
+#ifndef TC_CLOCK_H
+#define TC_CLOCK_H
+
+#include <stdint.h>
+
+/**
+* @brief Read the time since start up, extending the 32 bit microsecond
+*        ticker so it doesn't wrap. Safe to call from interrupts.
+* @note Must be called at least once every 2^32 us (71 minutes) to notice
+*       each wrap of the ticker, the receiver interrupts and motor drive
+*       loop make sure of this.
+* @return Time since start up (microseconds).
+*/
+uint64_t clock_now_us(void);
+
+/**
+* @brief Read a 64 bit time written by an interrupt, without tearing.
+* @param [in] stamp Time to read.
+* @return Value of stamp.
+*/
+uint64_t clock_read_stamp(const volatile uint64_t *stamp);
+
+#endif  // TC_CLOCK_H
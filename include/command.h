@@ -26,7 +26,9 @@
 #ifndef INCLUDE_COMMAND_H_
 #define INCLUDE_COMMAND_H_
 
+#include <stdint.h>
 #include "./tele_param.h"
+#include "./loop_stats.h"
 
 /**
  * Available commands (used for serial interface).
@@ -39,7 +41,18 @@ typedef enum  {
   STATUS,
   GET_PARAM,
   SET_PARAM,
-  CALIBRATE_CHANNELS
+  CALIBRATE_CHANNELS,
+  LOOP_TIMING,
+  FILTER_STATS,
+  QUEUE_STATS,
+  TELEMETRY_META,
+  TELEMETRY_LINK_STATS,
+  HEADING_LOCK,
+  HEADING_STATUS,
+  ORIENTATION_OVERRIDE,
+  BLACKBOX_DUMP,
+  BLACKBOX_REPLAY,
+  CPU_TOP
 } command_id_t;
 
 /**
@@ -64,6 +77,33 @@ typedef struct {
     bool b;
     const char *s;
   } value;
+
+  /*! Time the command was placed on the command queue (microseconds). */
+  uint32_t enqueued_us;
+
+  /*! Time the command executor took the command off the queue
+      (microseconds). */
+  uint32_t executed_us;
 } command_t;
 
+/**
+ * Queue depth and latency of commands passed to the command executor.
+ */
+typedef struct {
+  /*! Commands currently waiting on the queue. */
+  volatile uint32_t depth;
+
+  /*! Largest number of commands seen waiting on the queue. */
+  uint32_t max_depth;
+
+  /*! Commands dropped because the queue was full. */
+  uint32_t rejected;
+
+  /*! Time from enqueue to the executor picking the command up. */
+  timing_histogram_t wait;
+
+  /*! Time from enqueue to the command completing. */
+  timing_histogram_t latency;
+} command_stats_t;
+
 #endif  // INCLUDE_COMMAND_H_
@@ -0,0 +1,126 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file command_parser.h
+ * @author Cameron A. Craig
+ * @date 14 Feb 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Parses command strings into command_t structures. Independent of mbed
+ *        so that the parser can be built and timed off target.
+ */
+
+#ifndef TC_COMMAND_PARSER_H
+#define TC_COMMAND_PARSER_H
+
+#include <stdint.h>
+#include "command.h"
+
+static const command_t available_commands[] = {
+  {.id = FULLY_DISARM, .name = "disarm"},
+  {.id = PARTIAL_DISARM, .name = "decarm"},
+  {.id = PARTIAL_ARM, .name = "incarm"},
+  {.id = FULLY_ARM, .name = "arm"},
+  {.id = STATUS, .name = "status"},
+  {.id = GET_PARAM, .name = "get"},
+  {.id = SET_PARAM, .name = "set"},
+  {.id = CALIBRATE_CHANNELS, .name = "calibrate"},
+  {.id = LOOP_TIMING, .name = "timing"},
+  {.id = FILTER_STATS, .name = "filter"},
+  {.id = QUEUE_STATS, .name = "queue"},
+  {.id = TELEMETRY_META, .name = "meta"},
+  {.id = TELEMETRY_LINK_STATS, .name = "link"},
+  {.id = HEADING_LOCK, .name = "lock"},
+  {.id = HEADING_STATUS, .name = "heading"},
+  {.id = ORIENTATION_OVERRIDE, .name = "orient"},
+  {.id = BLACKBOX_DUMP, .name = "dump"},
+  {.id = BLACKBOX_REPLAY, .name = "replay"},
+  {.id = CPU_TOP, .name = "top"}
+};
+
+#define NUM_COMMANDS (sizeof(available_commands) / sizeof(command_t))
+
+/* Slots in a name index, a power of 2 comfortably larger than the number of
+   names so that a collision free seed is quick to find. */
+#define NAME_INDEX_SLOTS 128
+#define NAME_INDEX_EMPTY 0xFF
+
+/* Seeds tried when building a name index before giving up. */
+#define NAME_INDEX_MAX_SEEDS 10000
+
+/**
+ * A perfect hash from names to their position in a table: every name hashes
+ * to its own slot, so a lookup is one hash and one string compare.
+ */
+typedef struct {
+  uint32_t seed;
+  uint8_t slot[NAME_INDEX_SLOTS];
+} name_index_t;
+
+/**
+ * A word within a command string. Points into the string, which is not
+ * modified, so text is not NUL terminated.
+ */
+typedef struct {
+  const char *text;
+  uint32_t length;
+} command_token_t;
+
+/**
+* @brief Build the command and telemetry parameter name indexes. Must be
+*        called before command_generate().
+* @return RET_OK on success, RET_ERROR if no perfect hash could be found.
+*/
+int command_parser_init(void);
+
+/**
+* @brief Return command as a string (meaningful name)
+* @param [in] id Identifier for command being dealt with.
+*/
+const char * command_get_str(command_id_t id);
+
+/**
+* @brief Read the next space separated word from a command string.
+* @param [in/out] cursor Position in the string, moved past the word.
+* @param [out] token The word.
+* @return true if a word was found, false at the end of the string.
+*/
+bool command_next_token(const char **cursor, command_token_t *token);
+
+/**
+* @brief Find a command by its full name.
+* @param [in] token Name of the command.
+* @return Position in available_commands, or -1 if there is no such command.
+*/
+int command_find(const command_token_t *token);
+
+/**
+* @brief Find a telemetry parameter by its full name.
+* @param [in] token Name of the parameter.
+* @return Position in tele_commands, or -1 if there is no such parameter.
+*/
+int tele_param_find(const command_token_t *token);
+
+/**
+* @brief Produce a command_t from a raw command string.
+* @param [out] command The command to populate.
+* @param [in] buffer NUL terminated command string, not modified.
+* @return RET_OK on success, RET_ERROR if the command or parameter is not
+*         recognised or the value can not be read.
+*/
+int command_generate(command_t *command, const char *buffer);
+
+#endif  // TC_COMMAND_PARSER_H
@@ -27,32 +27,7 @@
 
 #include "thread_args.h"
 #include "command.h"
-
-static const command_t available_commands[] = {
-  {.id = FULLY_DISARM, .name = "disarm"},
-  {.id = PARTIAL_DISARM, .name = "decarm"},
-  {.id = PARTIAL_ARM, .name = "incarm"},
-  {.id = FULLY_ARM, .name = "arm"},
-  {.id = STATUS, .name = "status"},
-  {.id = GET_PARAM, .name = "get"},
-  {.id = SET_PARAM, .name = "set"},
-  {.id = CALIBRATE_CHANNELS, .name = "calibrate"}
-};
-
-#define NUM_COMMANDS (sizeof(available_commands) / sizeof(command_t))
-
-/**
-* @brief Return command as a string (meaningful name)
-* @param [in] id Identifier for command being dealt with.
-*/
-const char * command_get_str(command_id_t id);
-
-/**
-* @brief Produce a command_t from a raw command string.
-* @param [out] command The command to populate.
-* @param [in] buffer Command string.
-*/
-int command_generate(command_t *command, char *buffer);
+#include "command_parser.h"
 
 /**
 * @brief Carry out the function intended by the command.
@@ -61,6 +36,14 @@ int command_generate(command_t *command, char *buffer);
 */
 int command_execute(command_t *command, thread_args_t *targs);
 
+/**
+* @brief Timestamp a command and place a copy of it on the command queue.
+* @param [in] command The command to queue.
+* @param [in/out] targs Holds the command queue and its statistics.
+* @return RET_OK on success, RET_ERROR if the queue is full.
+*/
+int command_enqueue(const command_t *command, thread_args_t *targs);
+
 /**
 * @brief Disable drive motors and weapon motors.
 * @param [in] command The command being executed.
@@ -117,4 +100,93 @@ int command_set_param(command_t *command, thread_args_t *targs);
 */
 int command_calibrate_channels(command_t *command, thread_args_t *targs);
 
+/**
+* @brief Print and clear timing histograms of the motor drive loop.
+* @param [in] command The command being executed.
+* @param [in] targs Thread arguments holding the loop statistics.
+* @return RET_OK on success, RET_ERROR on error.
+*/
+int command_loop_timing(command_t *command, thread_args_t *targs);
+
+/**
+* @brief Print the number of receiver inputs rejected by the input filter.
+* @param [in] command The command being executed.
+* @return RET_OK on success, RET_ERROR on error.
+*/
+int command_filter_stats(command_t *command, thread_args_t *targs);
+
+/**
+* @brief Print the depth of the command queue and the latency of commands.
+* @param [in] command The command being executed.
+* @return RET_OK on success, RET_ERROR on error.
+*/
+int command_queue_stats(command_t *command, thread_args_t *targs);
+
+/**
+* @brief Have the name, type and unit of every telemetry parameter resent.
+* @param [in] command The command being executed.
+* @return RET_OK on success, RET_ERROR on error.
+*/
+int command_telemetry_meta(command_t *command, thread_args_t *targs);
+
+/**
+* @brief Print how many telemetry values and bytes have been sent to the
+*        ESP8266, and how many were saved by only sending changes.
+* @param [in] command The command being executed.
+* @return RET_OK on success, RET_ERROR on error.
+*/
+int command_telemetry_link_stats(command_t *command, thread_args_t *targs);
+
+/**
+* @brief Turn the heading lock on or off. It holds the heading the robot has
+*        when the driver stops rotating.
+* @param [in] command The command being executed.
+* @return RET_OK on success, RET_ERROR on error.
+*/
+int command_heading_lock(command_t *command, thread_args_t *targs);
+
+/**
+* @brief Print the heading controller state and gains, and print and clear
+*        the timing of its loop.
+* @param [in] command The command being executed.
+* @return RET_OK on success, RET_ERROR on error.
+*/
+int command_heading_status(command_t *command, thread_args_t *targs);
+
+/**
+* @brief Step the orientation override from auto, to upright, to inverted
+*        and back to auto. The controls are remapped for the overridden
+*        orientation rather than the detected one, unless it is auto.
+* @param [in] command The command being executed.
+* @return RET_OK on success, RET_ERROR on error.
+*/
+int command_orientation_override(command_t *command, thread_args_t *targs);
+
+/**
+* @brief Print every record in the flight recorder as a line of hex, oldest
+*        first, for tools/blackbox_csv.py to convert. Recording stops while
+*        the records are printed.
+* @param [in] command The command being executed.
+* @return RET_OK on success, RET_ERROR on error.
+*/
+int command_blackbox_dump(command_t *command, thread_args_t *targs);
+
+/**
+* @brief Replay the flight recorder through the control pipeline in virtual
+*        time and check that it reproduces the recorded channel values,
+*        outputs and arm state. Recording stops during the replay.
+* @param [in] command The command being executed.
+* @return RET_OK if the replay matched, RET_ERROR otherwise.
+*/
+int command_blackbox_replay(command_t *command, thread_args_t *targs);
+
+/**
+* @brief Print the processor time used by each task and spent idle since the
+*        last top (since start up the first time), with each task's worst
+*        run time and deadline misses.
+* @param [in] command The command being executed.
+* @return RET_OK on success, RET_ERROR on error.
+*/
+int command_cpu_top(command_t *command, thread_args_t *targs);
+
 #endif //TC_COMMANDS_H
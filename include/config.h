@@ -30,18 +30,21 @@
 /* The following macros are used to enable and disable tasks at
    preprocessing time. */
 
-// #define TASK_READ_SERIAL
-// #define TASK_PROCESS_COMMANDS
+#define TASK_READ_SERIAL
+#define TASK_PROCESS_COMMANDS
 #define TASK_LED_STATE
 #define TASK_MOTOR_DRIVE
 #define TASK_ARMING
-#define TASK_FAILSAFE
 #define TASK_CALC_ORIENTATION
 #define TASK_COLLECT_TELEMETRY
 #define TASK_STREAM_TELEMETRY
 #define TASK_CALIBRATE_CHANNELS
 //#define TASK_DEBUG
 
+/* Use Q16.16 fixed point instead of float for channel values and the drive
+   and weapon modes (see fixed.h). */
+// #define CONTROL_FIXED_POINT
+
 // #define DEVICE_BNO055
 // #define DEVICE_ESP8266
 
@@ -60,6 +63,18 @@
 #define RECV_W_CHAN_5_PIN p11
 #define RECV_W_CHAN_6_PIN p12
 
+/* Type of receiver used by each controller: receiver_impl_pwm (a pin per
+   channel above), receiver_impl_ppm or receiver_impl_sbus (a single signal
+   pin below). The default signal pins, p29 and p30, are free and suit PPM,
+   which can use any pin but p19 and p20. SBUS needs a UART RX pin: p14 once
+   the drive receiver no longer uses its channel pins, or p10 without the
+   BNO055. config_pins.h stops pins from being used twice. */
+#define RC_0_RECEIVER receiver_impl_pwm
+#define RC_1_RECEIVER receiver_impl_pwm
+
+#define RECV_W_SIGNAL_PIN p29
+#define RECV_D_SIGNAL_PIN p30
+
 #define ESP8266_READY_PIN p19
 
 #define DRIVE_ESC_OUT_1_PIN p21
@@ -73,13 +88,34 @@
 #define ESP_TX p28
 #define ESP_RX p27
 
+/* Sensor I2C bus (BNO055) */
+#define I2C_SDA_PIN p9
+#define I2C_SCL_PIN p10
+
+/* BNO055 INT output. When defined, orientation is read each time the sensor
+   has new data, otherwise on a timer matched to its data rate. Needs an
+   interrupt pin: p29 and p30 are the only free ones, unless a single wire
+   receiver is using it. */
+// #define BNO055_INT_PIN p30
+
 /* End of Pin Assignments */
 
+#include "config_pins.h"
+
 #define RC_NUMBER_CHANNELS 6
 #define RC_NUMBER_CONTROLLERS 2
 
+/* Most wheels any drive mode mixes for, and how many of them have an ESC. */
+#define MAX_DRIVE_WHEELS 4
+#define NUM_DRIVE_ESCS 3
+
+/* Stick deflection (as a fraction of full travel) ignored by the mixer. */
+#define DRIVE_STICK_DEADBAND 0.1f
+
 // 150ms increments
 #define NO_SIGNAL_TIMEOUT 70
+/* A receiver is stalled when any channel has had no valid pulse for this long. */
+#define RC_STALL_TIMEOUT_US 200000
 #define WATCHDOG_TIME_SECONDS 1.0
 
 #define RC_ARM_CHANNEL_1 90
@@ -88,6 +124,9 @@
 #define RC_ARM_CHANNEL_4 10
 #define RC_ARM_DELAY 5
 
+/* Period between checks of the arming switches. */
+#define ARMING_PERIOD_MS 1000
+
 #define CHANNEL_MAX 85 //85
 #define CHANNEL_MIN 3  //3
 #define RC_ON_THRES 70 // ON threshold for switches
@@ -98,6 +137,106 @@
 
 #define COMMAND_QUEUE_LEN 100
 
+/* Sensor I2C bus clock, and transactions that can wait for the bus. */
+#define I2C_FREQUENCY_HZ 400000
+#define I2C_QUEUE_LEN 8
+#define I2C_STACK_SIZE 768
+
+/* Period between checks of the BNO055 system status and error registers. */
+#define BNO055_HEALTH_CHECK_MS 500
+
+/* Thread signal set when a BNO055 read queued by the orientation task
+   finishes. */
+#define BNO055_SAMPLE_SIGNAL 0x01
+
+/* Thread signal set from the BNO055 INT pin. */
+#define BNO055_DATA_READY_SIGNAL 0x02
+
+/* BNO055 operating mode, one of BNO055_MODE_* in bno055.h. The fusion modes
+   (IMU, NDOF, NDOF_FMC_OFF) run at 100 Hz. ACCGYRO gives raw data only, at
+   BNO055_RAW_RATE_HZ, and no Euler angles. */
+#define BNO055_MODE BNO055_MODE_NDOF
+#define BNO055_RAW_RATE_HZ 100
+
+/* Heading lock defaults, the gains can be changed with the heading_kp,
+   heading_ki and heading_kd parameters. If the robot turns away from the
+   locked heading rather than back to it, the rotate axis of the drive mode
+   runs the other way round and the gains need to be negative. */
+#define HEADING_LOCK_KP 0.02f
+#define HEADING_LOCK_KI 0.0f
+#define HEADING_LOCK_KD 0.002f
+#define HEADING_LOCK_SPEED 50
+#define HEADING_LOCK_DEADBAND 2
+
+/* The BNO055 reports a roll of about -60 degrees when the robot is upside
+   down. It is taken as inverted within ORIENTATION_ENTER_DEG of that, and
+   as upright again once more than ORIENTATION_LEAVE_DEG away, after
+   ORIENTATION_SETTLE_SAMPLES samples in a row agree. */
+#define ORIENTATION_INVERTED_ROLL -60.0f
+#define ORIENTATION_ENTER_DEG 25.0f
+#define ORIENTATION_LEAVE_DEG 35.0f
+#define ORIENTATION_SETTLE_SAMPLES 3
+
+/* Period between binary telemetry frames sent to the ESP8266. Frames in
+   between keyframes only hold the parameters that have changed, so most
+   are a few bytes or not sent at all. */
+#define TELEMETRY_STREAM_PERIOD_MS 100
+
+/* Frames between keyframes, which send every parameter. */
+#define TELEMETRY_KEYFRAME_INTERVAL 10
+
+/* Longest the collect telemetry task sleeps, so that it notices being
+   activated. Each parameter sets its own sample period in tele_params.cpp. */
+#define TELEMETRY_COLLECT_IDLE_MS 100
+
+/* Complete command lines buffered between the serial interrupt and the read
+   serial task, must be a power of 2. */
+#define CONSOLE_NUM_LINES 4
+#define CONSOLE_LINE_SIGNAL 0x01
+
+/* Rate at which the motor drive task reads inputs and updates the ESCs. */
+#define CONTROL_LOOP_RATE_HZ 500
+#define CONTROL_LOOP_PERIOD_US (1000000 / CONTROL_LOOP_RATE_HZ)
+
+/* Thread signal used to release the motor drive task each period. */
+#define CONTROL_LOOP_SIGNAL 0x01
+
+/* Release the motor drive task each time the drive receiver completes a
+   frame, rather than from a ticker, so outputs follow inputs as closely as
+   possible. If no frame arrives within RC_FRAME_TIMEOUT_MS the loop runs
+   anyway. CONTROL_LOOP_PERIOD_US is not used in this mode. */
+#define CONTROL_LOOP_FRAME_SYNC
+#define RC_FRAME_SYNC_CONTROLLER 1
+#define RC_FRAME_PERIOD_US 20000
+#define RC_FRAME_TIMEOUT_MS 50
+
+/* Pulses buffered per receiver between loop cycles, must be a power of 2. */
+#define RC_CAPTURE_RING_LEN 32
+/* Longest pulse accepted from a receiver channel. */
+#define RC_PULSE_MAX_US 3000
+
+/* Filter stages applied to receiver pulses, see rc_input.h */
+#define RC_FILTER_STAGES (RC_FILTER_RANGE | RC_FILTER_STEP | RC_FILTER_MEDIAN)
+#define RC_FILTER_MIN_US 800
+#define RC_FILTER_MAX_US 2200
+/* A larger jump is held for one frame, and passed on if the next width
+   confirms it. Arm switches and throttles closing are never held. */
+#define RC_FILTER_MAX_STEP_US 400
+/* Low pass filter weight of each new width is 1 / 2^RC_FILTER_IIR_SHIFT */
+#define RC_FILTER_IIR_SHIFT 1
+
+/* Records replayed before the replay is compared with the trace, while the
+   input filter history fills. */
+#define REPLAY_SETTLE_CYCLES 3
+
+/* Histograms of loop timing, see loop_stats.h */
+#define LOOP_STATS_NUM_BINS 16
+#define LOOP_STATS_BIN_WIDTH_US 25
+
+/* Tasks that the CPU usage monitor can track, at least NUM_TASKS. See
+   cpu_usage.h */
+#define CPU_USAGE_MAX_TASKS 10
+
 #define MAIL_TIMEOUT_MS 1
 
 #define NUM_SURFACE_LEDS 4
@@ -0,0 +1,136 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * @file config_pins.h
+ * @author Cameron A. Craig
+ * @date 21 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Compile time checks of the pin assignments in config.h, so two
+ *        drivers can't be given the same pin.
+ */
+
+#ifndef TC_CONFIG_PINS_H
+#define TC_CONFIG_PINS_H
+
+/* Pin numbers usable in #if, 0 for anything that isn't a DIP pin. The
+   extra level of macros expands a pin assignment before pasting it. */
+#define PIN_NUMBER(pin) PIN_NUMBER_(pin)
+#define PIN_NUMBER_(pin) PIN_NUMBER_##pin
+#define PIN_NUMBER_p5 5
+#define PIN_NUMBER_p6 6
+#define PIN_NUMBER_p7 7
+#define PIN_NUMBER_p8 8
+#define PIN_NUMBER_p9 9
+#define PIN_NUMBER_p10 10
+#define PIN_NUMBER_p11 11
+#define PIN_NUMBER_p12 12
+#define PIN_NUMBER_p13 13
+#define PIN_NUMBER_p14 14
+#define PIN_NUMBER_p15 15
+#define PIN_NUMBER_p16 16
+#define PIN_NUMBER_p17 17
+#define PIN_NUMBER_p18 18
+#define PIN_NUMBER_p19 19
+#define PIN_NUMBER_p20 20
+#define PIN_NUMBER_p21 21
+#define PIN_NUMBER_p22 22
+#define PIN_NUMBER_p23 23
+#define PIN_NUMBER_p24 24
+#define PIN_NUMBER_p25 25
+#define PIN_NUMBER_p26 26
+#define PIN_NUMBER_p27 27
+#define PIN_NUMBER_p28 28
+#define PIN_NUMBER_p29 29
+#define PIN_NUMBER_p30 30
+
+#define PIN_EQUAL(a, b) (PIN_NUMBER(a) != 0 && PIN_NUMBER(a) == PIN_NUMBER(b))
+
+/* p19 and p20 are on GPIO port 1, which has no edge interrupts. */
+#define PIN_HAS_INTERRUPT(pin) (PIN_NUMBER(pin) != 0 && PIN_NUMBER(pin) != 19 && PIN_NUMBER(pin) != 20)
+
+/* RX pins of UART1, UART2 and UART3. */
+#define PIN_IS_UART_RX(pin) (PIN_EQUAL(pin, p14) || PIN_EQUAL(pin, p27) || PIN_EQUAL(pin, p10))
+
+/* Whether a receiver implementation uses a single signal pin rather than a
+   pin per channel, and whether that pin must be a UART RX pin. */
+#define RECEIVER_SINGLE_WIRE(impl) RECEIVER_SINGLE_WIRE_(impl)
+#define RECEIVER_SINGLE_WIRE_(impl) RECEIVER_SINGLE_WIRE_##impl
+#define RECEIVER_SINGLE_WIRE_receiver_impl_pwm 0
+#define RECEIVER_SINGLE_WIRE_receiver_impl_ppm 1
+#define RECEIVER_SINGLE_WIRE_receiver_impl_sbus 1
+
+#define RECEIVER_UART(impl) RECEIVER_UART_(impl)
+#define RECEIVER_UART_(impl) RECEIVER_UART_##impl
+#define RECEIVER_UART_receiver_impl_pwm 0
+#define RECEIVER_UART_receiver_impl_ppm 0
+#define RECEIVER_UART_receiver_impl_sbus 1
+
+/* Pins used by the weapon (RC_0) and drive (RC_1) receivers. */
+#define PIN_USED_BY_RECV_W(pin) (RECEIVER_SINGLE_WIRE(RC_0_RECEIVER) ? \
+  PIN_EQUAL(pin, RECV_W_SIGNAL_PIN) : \
+  (PIN_EQUAL(pin, RECV_W_CHAN_1_PIN) || PIN_EQUAL(pin, RECV_W_CHAN_2_PIN) || \
+   PIN_EQUAL(pin, RECV_W_CHAN_3_PIN) || PIN_EQUAL(pin, RECV_W_CHAN_4_PIN) || \
+   PIN_EQUAL(pin, RECV_W_CHAN_5_PIN) || PIN_EQUAL(pin, RECV_W_CHAN_6_PIN)))
+
+#define PIN_USED_BY_RECV_D(pin) (RECEIVER_SINGLE_WIRE(RC_1_RECEIVER) ? \
+  PIN_EQUAL(pin, RECV_D_SIGNAL_PIN) : \
+  (PIN_EQUAL(pin, RECV_D_CHAN_1_PIN) || PIN_EQUAL(pin, RECV_D_CHAN_2_PIN) || \
+   PIN_EQUAL(pin, RECV_D_CHAN_3_PIN) || PIN_EQUAL(pin, RECV_D_CHAN_4_PIN) || \
+   PIN_EQUAL(pin, RECV_D_CHAN_5_PIN) || PIN_EQUAL(pin, RECV_D_CHAN_6_PIN)))
+
+/* Pins used by everything else. The ESP8266 serial port and ready pin are
+   set up whether or not DEVICE_ESP8266 is defined. */
+#ifdef DEVICE_BNO055
+#define PIN_USED_BY_I2C(pin) (PIN_EQUAL(pin, I2C_SDA_PIN) || PIN_EQUAL(pin, I2C_SCL_PIN))
+#else
+#define PIN_USED_BY_I2C(pin) 0
+#endif
+
+#define PIN_USED_BY_OTHERS(pin) (PIN_USED_BY_I2C(pin) || \
+  PIN_EQUAL(pin, ESP_TX) || PIN_EQUAL(pin, ESP_RX) || PIN_EQUAL(pin, ESP8266_READY_PIN) || \
+  PIN_EQUAL(pin, DRIVE_ESC_OUT_1_PIN) || PIN_EQUAL(pin, DRIVE_ESC_OUT_2_PIN) || \
+  PIN_EQUAL(pin, DRIVE_ESC_OUT_3_PIN) || PIN_EQUAL(pin, WEAPON_ESC_OUT_1_PIN) || \
+  PIN_EQUAL(pin, WEAPON_ESC_OUT_2_PIN) || PIN_EQUAL(pin, WEAPON_ESC_OUT_3_PIN))
+
+#if RECEIVER_SINGLE_WIRE(RC_0_RECEIVER)
+#if PIN_USED_BY_RECV_D(RECV_W_SIGNAL_PIN) || PIN_USED_BY_OTHERS(RECV_W_SIGNAL_PIN)
+#error "RECV_W_SIGNAL_PIN is already in use, see config.h"
+#endif
+#if RECEIVER_UART(RC_0_RECEIVER) ? !PIN_IS_UART_RX(RECV_W_SIGNAL_PIN) : !PIN_HAS_INTERRUPT(RECV_W_SIGNAL_PIN)
+#error "RECV_W_SIGNAL_PIN can't be used by this type of receiver, see config.h"
+#endif
+#endif
+
+#if RECEIVER_SINGLE_WIRE(RC_1_RECEIVER)
+#if PIN_USED_BY_RECV_W(RECV_D_SIGNAL_PIN) || PIN_USED_BY_OTHERS(RECV_D_SIGNAL_PIN)
+#error "RECV_D_SIGNAL_PIN is already in use, see config.h"
+#endif
+#if RECEIVER_UART(RC_1_RECEIVER) ? !PIN_IS_UART_RX(RECV_D_SIGNAL_PIN) : !PIN_HAS_INTERRUPT(RECV_D_SIGNAL_PIN)
+#error "RECV_D_SIGNAL_PIN can't be used by this type of receiver, see config.h"
+#endif
+#endif
+
+#ifdef BNO055_INT_PIN
+#if PIN_USED_BY_RECV_W(BNO055_INT_PIN) || PIN_USED_BY_RECV_D(BNO055_INT_PIN) || \
+    PIN_USED_BY_OTHERS(BNO055_INT_PIN)
+#error "BNO055_INT_PIN is already in use, see config.h"
+#endif
+#if !PIN_HAS_INTERRUPT(BNO055_INT_PIN)
+#error "BNO055_INT_PIN has no edge interrupt, see config.h"
+#endif
+#endif
+
+#endif  // TC_CONFIG_PINS_H
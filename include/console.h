@@ -0,0 +1,78 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file console.h
+ * @author Cameron A. Craig
+ * @date 31 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Interrupt driven command line on the USB serial port.
+ */
+
+#ifndef TC_CONSOLE_H
+#define TC_CONSOLE_H
+
+#include <stdint.h>
+#include "mbed.h"
+#include "rtos.h"
+#include "config.h"
+#include "line_buffer.h"
+#include "spsc_ring.h"
+
+/**
+ * A complete command line.
+ */
+typedef struct {
+  char text[LINE_BUFFER_LEN];
+} console_line_t;
+
+/**
+ * The receive interrupt assembles typed characters into lines and echoes
+ * them as they arrive. Only complete lines are passed on, so the thread
+ * reading them sleeps until a whole command has been typed.
+ */
+typedef struct {
+  RawSerial *serial;
+  line_buffer_t line;
+  SpscRing<console_line_t, CONSOLE_NUM_LINES> lines;
+  Thread *notify;
+  int32_t signal;
+} console_t;
+
+/**
+* @brief Start assembling lines typed on a serial port.
+* @param [out] console Console state.
+* @param [in] serial Serial port, used from interrupt context.
+*/
+void console_init(console_t *console, RawSerial *serial);
+
+/**
+* @brief Signal a thread each time a line is complete.
+* @param [in/out] console Console state.
+* @param [in] thread Thread to signal, NULL to stop signalling.
+* @param [in] signal Signal flags to set.
+*/
+void console_notify(console_t *console, Thread *thread, int32_t signal);
+
+/**
+* @brief Take the oldest complete line.
+* @param [in/out] console Console state.
+* @param [out] line Line read.
+* @return true if a line was read, false if there are none waiting.
+*/
+bool console_read_line(console_t *console, console_line_t *line);
+
+#endif  // TC_CONSOLE_H
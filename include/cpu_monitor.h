@@ -0,0 +1,71 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * @file cpu_monitor.h
+ * @author Cameron A. Craig
+ * @date 20 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Measures the processor time used by each task with the DWT cycle
+ *        counter, and the time spent idle from the RTOS idle thread.
+ *
+ * RTX in mbed OS 5 does not call out on a thread switch, so each task
+ * reports the points where it blocks and wakes instead, through task_wait()
+ * and task_signal_wait() in task_utils.h. Time spent in interrupts is
+ * charged to the task they interrupt.
+ */
+
+#ifndef TC_CPU_MONITOR_H
+#define TC_CPU_MONITOR_H
+
+#include <stdint.h>
+#include "task.h"
+#include "cpu_usage.h"
+
+/**
+* @brief Start the cycle counter and the idle hook. Must be called before
+*        the tasks are started.
+* @param [in] tasks Tasks to track, in task ID order.
+* @param [in] num_tasks Number of tasks.
+*/
+void cpu_monitor_init(const task_t *tasks, unsigned num_tasks);
+
+/**
+* @brief Report that a task has woken and is running.
+* @param [in] task Task ID.
+* @param [in] release True if this wake starts a new run of the task, false
+*                     if it woke part way through one (such as waiting on
+*                     a bus transfer).
+*/
+void cpu_monitor_wake(unsigned task, bool release);
+
+/**
+* @brief Report that a task is about to block.
+* @param [in] task Task ID.
+*/
+void cpu_monitor_block(unsigned task);
+
+/**
+* @brief Take a consistent copy of the usage so far.
+* @param [out] usage Copy of the usage.
+*/
+void cpu_monitor_read(cpu_usage_t *usage);
+
+/**
+* @return cycles converted to microseconds.
+*/
+uint32_t cpu_monitor_us(uint64_t cycles);
+
+#endif  // TC_CPU_MONITOR_H
@@ -0,0 +1,156 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * @file cpu_usage.h
+ * @author Cameron A. Craig
+ * @date 20 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Charges processor time to the task running between each wake,
+ *        block and idle event. Times are processor clock cycles passed in
+ *        by the caller, so nothing here depends on mbed.
+ */
+
+#ifndef TC_CPU_USAGE_H
+#define TC_CPU_USAGE_H
+
+#include <stdint.h>
+#include "config.h"
+
+/* Running task when no tracked task is running. */
+#define CPU_USAGE_NONE -1
+
+/**
+ * Processor time used by one task. A run starts each time the task is
+ * released and lasts until it is next released, and only counts the time
+ * the task itself was running, not the time it was preempted or blocked.
+ */
+typedef struct {
+  /*! Period the task is released at, 0 if it is woken by events and each
+      wake is a new run (cycles). */
+  uint32_t period;
+
+  /*! Time spent running the task (cycles). */
+  uint64_t busy;
+
+  /*! Number of runs started. */
+  uint32_t runs;
+
+  /*! Time used by the current run so far (cycles). */
+  uint32_t run;
+
+  /*! Most time used by one run (cycles). */
+  uint32_t worst_run;
+
+  /*! Runs that had not blocked for the last time within one period of
+      being released. */
+  uint32_t misses;
+
+  /*! When the current run was released. */
+  uint32_t released_at;
+
+  /*! When the task last blocked. */
+  uint32_t blocked_at;
+
+  /*! Task that was running when this one woke, it carries on when this one
+      blocks. */
+  int preempted;
+} cpu_task_usage_t;
+
+/**
+ * Processor time used by each task, and spent idle, since start up.
+ */
+typedef struct {
+  cpu_task_usage_t tasks[CPU_USAGE_MAX_TASKS];
+  unsigned num_tasks;
+
+  /*! Task being charged for the processor, or CPU_USAGE_NONE. */
+  int running;
+
+  /*! Cycle counter when time was last charged. */
+  uint32_t charged_at;
+
+  /*! Time since start up (cycles). */
+  uint64_t elapsed;
+
+  /*! Time the processor was asleep in the idle thread (cycles). */
+  uint64_t idle;
+} cpu_usage_t;
+
+/**
+* @brief Clear all usage, with no task running.
+* @param [out] cpu Usage to initialise.
+* @param [in] num_tasks Number of tasks to track, at most CPU_USAGE_MAX_TASKS.
+* @param [in] now Current cycle counter.
+*/
+void cpu_usage_init(cpu_usage_t *cpu, unsigned num_tasks, uint32_t now);
+
+/**
+* @brief Set the period a task is released at.
+* @param [in/out] cpu Usage.
+* @param [in] task Task index.
+* @param [in] period Period (cycles), 0 if the task is woken by events.
+*/
+void cpu_usage_set_period(cpu_usage_t *cpu, unsigned task, uint32_t period);
+
+/**
+* @brief Charge the running task for the time since the last event.
+* @param [in/out] cpu Usage.
+* @param [in] now Current cycle counter.
+*/
+void cpu_usage_update(cpu_usage_t *cpu, uint32_t now);
+
+/**
+* @brief A task has woken from a blocking call and is now running,
+*        preempting whichever task was running before.
+* @param [in/out] cpu Usage.
+* @param [in] task Task index.
+* @param [in] now Current cycle counter.
+* @param [in] release True if this wake starts a new run of a periodic task.
+*                     Every wake of a task without a period starts a run.
+*/
+void cpu_usage_wake(cpu_usage_t *cpu, unsigned task, uint32_t now, bool release);
+
+/**
+* @brief A task is about to block, the task it preempted carries on.
+* @param [in/out] cpu Usage.
+* @param [in] task Task index.
+* @param [in] now Current cycle counter.
+*/
+void cpu_usage_block(cpu_usage_t *cpu, unsigned task, uint32_t now);
+
+/**
+* @brief The idle thread slept. Every task must be blocked for it to run, so
+*        no task is running afterwards.
+* @param [in/out] cpu Usage.
+* @param [in] start Cycle counter when the processor went to sleep.
+* @param [in] end Cycle counter when it woke.
+* @param [in] stopped Time asleep that the cycle counter missed, as it stops
+*                     with the processor clock (cycles).
+*/
+void cpu_usage_idle(cpu_usage_t *cpu, uint32_t start, uint32_t end, uint32_t stopped);
+
+/**
+* @return Time not spent idle or in a tracked task, in interrupts that
+*         arrived while idle and in untracked threads (cycles).
+*/
+uint64_t cpu_usage_other(const cpu_usage_t *cpu);
+
+/**
+* @return part as a percentage of whole.
+*/
+float cpu_usage_percent(uint64_t part, uint64_t whole);
+
+#endif  // TC_CPU_USAGE_H
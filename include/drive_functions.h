@@ -19,29 +19,22 @@
  * @author Cameron A. Craig
  * @date 26 Aug 2017
  * @copyright 2017 Cameron A. Craig
- * @brief Function prototypes for drive/weapon control functions.
+ * @brief Function prototypes for weapon control functions. Drive modes
+ *        are mixed by mixer.h.
  */
 
 #ifndef TC_DRIVE_FUNCTIONS_H
 #define TC_DRIVE_FUNCTIONS_H
 
-/* Drive */
-
-/**
-* @brief Run a tick of holonomic drive mode.
-*/
-void drive_3_wheel_holonomic(const void * targs);
-
-/**
-* @brief Run a tick of differential drive mode.
-*/
-void drive_2_wheel_differential(const void * targs);
+#include "types.h"
 
 /* Weapon */
 
 /**
 * @brief Run a tick of manual throttle weapon mode.
+* @param [in] frame Controller channel values.
+* @param [in/out] outputs ESC outputs to update.
 */
-void weapon_manual_throttle(const void * targs);
+void weapon_manual_throttle(const rc_frame_t *frame, struct rc_outputs_t *outputs);
 
 #endif
@@ -25,6 +25,8 @@
 #ifndef TC_DRIVE_MODE_H_
 #define TC_DRIVE_MODE_H_
 
+#include "types.h"
+
 /* Drive */
 
 /**
@@ -32,17 +34,37 @@
  */
 typedef enum {
   DM_3_WHEEL_HOLONOMIC = 0,
-  DM_2_WHEEL_DIFFERENTIAL
+  DM_2_WHEEL_DIFFERENTIAL,
+  DM_4_WHEEL_MECANUM,
+  DM_4_WHEEL_TANK
 } drive_mode_id_t;
 
+/**
+ * Columns of a mixing matrix, the components of the stick vector.
+ */
+typedef enum {
+  MIX_THROTTLE = 0,
+  MIX_STRAFE,
+  MIX_ROTATE,
+  MIX_NUM_AXES
+} mix_axis_t;
+
 /**
  * Stores the parameters of a drive mode.
+ * Wheel i is driven at mix[i][MIX_THROTTLE] * throttle +
+ * mix[i][MIX_STRAFE] * strafe + mix[i][MIX_ROTATE] * rotate,
+ * see mixer.h.
  */
 typedef struct {
   drive_mode_id_t id;
   const char *name;
   int wheels;
-  void (*drive)(const void*);
+  /* Drive controller channel read for each axis of the stick vector. */
+  int channel[MIX_NUM_AXES];
+  /* Mixing matrix, one row per wheel. */
+  control_t mix[MAX_DRIVE_WHEELS][MIX_NUM_AXES];
+  /* Sign of each axis of the stick vector while the robot is upside down. */
+  control_t inverted[MIX_NUM_AXES];
 } drive_mode_t;
 
 /* Weapon */
@@ -60,7 +82,7 @@ typedef enum {
 typedef struct {
   weapon_mode_id_t id;
   const char *name;
-  void (*weapon)(const void*);
+  void (*weapon)(const rc_frame_t *frame, struct rc_outputs_t *outputs);
 } weapon_mode_t;
 
 #endif //TC_DRIVE_MODE_H_
@@ -32,10 +32,60 @@
 
 /* Drive */
 
-/* The various drive configurations are available in docs/drive_modes. */
+/* The various drive configurations are available in docs/drive_modes.
+   Mixing matrix rows are {throttle, strafe, rotate} for each wheel. Only the
+   first NUM_DRIVE_ESCS wheels have an ESC, the 4-wheel modes need a fourth
+   drive output to be added before they can be used.
+   Upside down, every wheel touches the floor on the other side of its axle,
+   so it drives the other way. Flipped over the roll axis, left and right
+   also swap, which cancels that out for the strafe and rotate axes, leaving
+   only throttle to reverse. */
 static volatile drive_mode_t drive_modes[] = {
-  {.id = DM_3_WHEEL_HOLONOMIC, .name = "3-Wheel Holonomic Drive", .wheels = 3, .drive = drive_3_wheel_holonomic },
-  {.id = DM_2_WHEEL_DIFFERENTIAL, .name = "2-Wheel Differential Drive", .wheels = 2, .drive = drive_2_wheel_differential }
+  {
+    .id = DM_3_WHEEL_HOLONOMIC, .name = "3-Wheel Holonomic Drive", .wheels = 3,
+    .channel = {RC_1_ELEVATION, RC_1_AILERON, RC_1_RUDDER},
+    /* Wheels at 120 degree spacing, wheel 1 pointing along the strafe axis */
+    .mix = {
+      {CONTROL(0.0),        CONTROL(-1.0), CONTROL(1.0)},
+      {CONTROL(-0.8660254), CONTROL(0.5),  CONTROL(1.0)},
+      {CONTROL(0.8660254),  CONTROL(0.5),  CONTROL(1.0)}
+    },
+    .inverted = {CONTROL(-1.0), CONTROL(1.0), CONTROL(1.0)}
+  },
+  {
+    .id = DM_2_WHEEL_DIFFERENTIAL, .name = "2-Wheel Differential Drive", .wheels = 2,
+    .channel = {RC_1_ELEVATION, RC_1_AILERON, RC_1_AILERON},
+    /* Left, right */
+    .mix = {
+      {CONTROL(1.0), CONTROL(0.0), CONTROL(1.0)},
+      {CONTROL(1.0), CONTROL(0.0), CONTROL(-1.0)}
+    },
+    .inverted = {CONTROL(-1.0), CONTROL(1.0), CONTROL(1.0)}
+  },
+  {
+    .id = DM_4_WHEEL_MECANUM, .name = "4-Wheel Mecanum Drive", .wheels = 4,
+    .channel = {RC_1_ELEVATION, RC_1_AILERON, RC_1_RUDDER},
+    /* Front left, front right, rear left, rear right */
+    .mix = {
+      {CONTROL(1.0), CONTROL(1.0),  CONTROL(1.0)},
+      {CONTROL(1.0), CONTROL(-1.0), CONTROL(-1.0)},
+      {CONTROL(1.0), CONTROL(-1.0), CONTROL(1.0)},
+      {CONTROL(1.0), CONTROL(1.0),  CONTROL(-1.0)}
+    },
+    .inverted = {CONTROL(-1.0), CONTROL(1.0), CONTROL(1.0)}
+  },
+  {
+    .id = DM_4_WHEEL_TANK, .name = "4-Wheel Tank Drive", .wheels = 4,
+    .channel = {RC_1_ELEVATION, RC_1_AILERON, RC_1_AILERON},
+    /* Front left, front right, rear left, rear right */
+    .mix = {
+      {CONTROL(1.0), CONTROL(0.0), CONTROL(1.0)},
+      {CONTROL(1.0), CONTROL(0.0), CONTROL(-1.0)},
+      {CONTROL(1.0), CONTROL(0.0), CONTROL(1.0)},
+      {CONTROL(1.0), CONTROL(0.0), CONTROL(-1.0)}
+    },
+    .inverted = {CONTROL(-1.0), CONTROL(1.0), CONTROL(1.0)}
+  }
 };
 
 /* Weapon */
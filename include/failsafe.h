@@ -0,0 +1,62 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file failsafe.h
+ * @author Cameron A. Craig
+ * @date 24 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Disarms the outputs of a receiver as soon as it stops sending frames.
+ */
+
+#ifndef TC_FAILSAFE_H
+#define TC_FAILSAFE_H
+
+#include <stdint.h>
+#include "thread_args.h"
+
+/**
+* @brief Start watching every receiver. Each complete frame re-arms a
+*        deadline of RC_STALL_TIMEOUT_US for its receiver. When a deadline
+*        expires the ESCs of that receiver are stopped and the arm state is
+*        lowered straight from the timer interrupt, without waiting for a
+*        task to notice.
+* @param [in/out] args Thread arguments, receivers and comms must already
+*                 be initialised.
+* @note comms_impl->stop() is called from interrupt context.
+*/
+void failsafe_init(thread_args_t *args);
+
+/**
+* @brief Lower the arm state for any receiver that has stopped sending,
+*        in case its deadline interrupt was missed. Only reads the capture
+*        times, so it is cheap enough to call every control loop cycle.
+* @param [in/out] args Thread arguments.
+*/
+void failsafe_poll(thread_args_t *args);
+
+/**
+* @return Longest time from a receiver's last frame to its failsafe
+*         (microseconds).
+*/
+uint32_t failsafe_worst_latency_us(void);
+
+/**
+* @return Number of times a receiver has been failsafed.
+*/
+uint32_t failsafe_trips(void);
+
+#endif  // TC_FAILSAFE_H
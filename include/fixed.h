@@ -0,0 +1,156 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file fixed.h
+ * @author Cameron A. Craig
+ * @date 17 Feb 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Q16.16 fixed point arithmetic.
+ *
+ * The LPC1768 (Cortex-M3) has no FPU, so every float operation is a call
+ * into the soft-float library. Q16.16 values are plain int32_t, so add and
+ * subtract are single instructions and multiply is one SMULL. The helpers
+ * saturate rather than wrap on overflow.
+ */
+
+#ifndef TC_FIXED_H
+#define TC_FIXED_H
+
+#include <stdint.h>
+
+/**
+ * Signed fixed point number with 16 integer bits and 16 fractional bits.
+ */
+typedef int32_t q16_t;
+
+#define Q16_SHIFT 16
+#define Q16_ONE ((q16_t) 1 << Q16_SHIFT)
+#define Q16_MAX ((q16_t) 0x7FFFFFFF)
+#define Q16_MIN (-Q16_MAX - 1)
+
+/**
+ * Convert a constant to Q16.16. Only use this with constant expressions so
+ * that the conversion happens at compile time.
+ */
+#define Q16(x) ((q16_t) ((x) * 65536.0 + ((x) >= 0 ? 0.5 : -0.5)))
+
+/**
+* @brief Limit a 64 bit intermediate result to the range of q16_t.
+*/
+static inline q16_t q16_saturate(int64_t v) {
+  if (v > Q16_MAX) {
+    return Q16_MAX;
+  }
+  if (v < Q16_MIN) {
+    return Q16_MIN;
+  }
+  return (q16_t) v;
+}
+
+/**
+* @brief Convert an integer to Q16.16, saturating outside +/-32767.
+*/
+static inline q16_t q16_from_int(int32_t i) {
+  return q16_saturate((int64_t) i << Q16_SHIFT);
+}
+
+/**
+* @brief Convert Q16.16 to the nearest integer.
+*/
+static inline int32_t q16_to_int(q16_t q) {
+  return (q16_saturate((int64_t) q + (Q16_ONE >> 1))) >> Q16_SHIFT;
+}
+
+/**
+* @brief Convert Q16.16 to float, for printing and telemetry only.
+*/
+static inline float q16_to_float(q16_t q) {
+  return (float) q / 65536.0f;
+}
+
+/**
+* @brief Add, saturating instead of overflowing.
+*/
+static inline q16_t q16_add(q16_t a, q16_t b) {
+  q16_t r = (q16_t) ((uint32_t) a + (uint32_t) b);
+  // Overflow occured if both operands have a different sign to the result
+  if (((a ^ r) & (b ^ r)) < 0) {
+    return (a < 0) ? Q16_MIN : Q16_MAX;
+  }
+  return r;
+}
+
+/**
+* @brief Subtract, saturating instead of overflowing.
+*/
+static inline q16_t q16_sub(q16_t a, q16_t b) {
+  q16_t r = (q16_t) ((uint32_t) a - (uint32_t) b);
+  // Overflow occured if the operands differ in sign and the result does not
+  // have the sign of a
+  if (((a ^ b) & (a ^ r)) < 0) {
+    return (a < 0) ? Q16_MIN : Q16_MAX;
+  }
+  return r;
+}
+
+/**
+* @brief Multiply, saturating instead of overflowing.
+*/
+static inline q16_t q16_mul(q16_t a, q16_t b) {
+  return q16_saturate(((int64_t) a * b) >> Q16_SHIFT);
+}
+
+/**
+* @brief Divide, saturating instead of overflowing. Division by zero
+*        saturates towards the sign of a.
+*/
+static inline q16_t q16_div(q16_t a, q16_t b) {
+  if (b == 0) {
+    return (a < 0) ? Q16_MIN : Q16_MAX;
+  }
+  return q16_saturate(((int64_t) a << Q16_SHIFT) / b);
+}
+
+/**
+* @brief Absolute value, saturating for Q16_MIN.
+*/
+static inline q16_t q16_abs(q16_t a) {
+  if (a == Q16_MIN) {
+    return Q16_MAX;
+  }
+  return (a < 0) ? -a : a;
+}
+
+/**
+* @brief Limit a value between min and max.
+*/
+static inline q16_t q16_clamp(q16_t d, q16_t min, q16_t max) {
+  const q16_t t = d < min ? min : d;
+  return t > max ? max : t;
+}
+
+/**
+* @brief Fixed point equivalent of map() in tmath.h.
+*/
+q16_t q16_map(q16_t in, q16_t inMin, q16_t inMax, q16_t outMin, q16_t outMax);
+
+/**
+* @brief Go from 0 -> 360 range to -180 to 180 range (degrees).
+*/
+q16_t q16_normalize(q16_t heading);
+
+#endif  // TC_FIXED_H
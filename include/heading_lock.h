@@ -0,0 +1,89 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * @file heading_lock.h
+ * @author Cameron A. Craig
+ * @date 16 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief PID controller that holds the robot on a heading. Nothing here
+ *        depends on mbed, so the controller can be built and tuned off
+ *        target.
+ */
+
+#ifndef TC_HEADING_LOCK_H
+#define TC_HEADING_LOCK_H
+
+/**
+ * Controller gains, the output is a rotation command between -1 and 1.
+ */
+typedef struct {
+  /*! Rotation per degree of heading error. */
+  float kp;
+
+  /*! Rotation per degree second of accumulated heading error. */
+  float ki;
+
+  /*! Rotation per degree/second of yaw rate, opposing the turn. */
+  float kd;
+} pid_gains_t;
+
+/**
+ * State of the heading controller, kept between samples.
+ */
+typedef struct {
+  /*! Accumulated heading error (degree seconds). */
+  float integral;
+
+  /*! Heading error of the last update (degrees). */
+  float error;
+
+  /*! Rotation command of the last update. */
+  float output;
+} heading_pid_t;
+
+/**
+* @brief Clear the controller state, e.g. when a new heading is locked.
+* @param [out] pid Controller state.
+*/
+void heading_pid_reset(heading_pid_t *pid);
+
+/**
+* @brief Difference between the locked and measured heading, the shortest
+*        way round.
+* @param [in] setpoint Heading to hold (degrees).
+* @param [in] heading Measured heading (degrees).
+* @return Error between -180 and 180 degrees.
+*/
+float heading_error(float setpoint, float heading);
+
+/**
+* @brief Run one sample of the controller. The derivative term acts on the
+*        measured yaw rate rather than the error, so the gyro provides it
+*        directly and a new setpoint does not kick the output.
+* @param [in/out] pid Controller state.
+* @param [in] gains Controller gains.
+* @param [in] error Heading error from heading_error() (degrees).
+* @param [in] rate Yaw rate, positive in the direction the heading
+*             increases (degrees/second).
+* @param [in] dt Time since the last sample (seconds).
+* @param [in] deadband Errors smaller than this are treated as 0 (degrees).
+* @param [in] limit Largest rotation command, between 0 and 1.
+* @return Rotation command between -limit and limit.
+*/
+float heading_pid_update(heading_pid_t *pid, const pid_gains_t *gains, float error, float rate,
+                         float dt, float deadband, float limit);
+
+#endif  // TC_HEADING_LOCK_H
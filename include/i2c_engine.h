@@ -0,0 +1,122 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file i2c_engine.h
+ * @author Cameron A. Craig
+ * @date 11 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Queues I2C transactions from any number of devices and threads and
+ *        runs them one at a time on a bus thread.
+ */
+
+#ifndef TC_I2C_ENGINE_H
+#define TC_I2C_ENGINE_H
+
+#include <stdint.h>
+#include "mbed.h"
+#include "rtos.h"
+#include "config.h"
+
+/**
+ * State of a transaction.
+ */
+typedef enum {
+  I2C_PENDING = 0,
+  I2C_DONE,
+
+  /*! The device did not acknowledge. */
+  I2C_NACK
+} i2c_result_t;
+
+struct i2c_transaction_t;
+
+/**
+* @brief Called on the bus thread once a transaction has finished.
+* @param [in] transaction The finished transaction.
+*/
+typedef void (*i2c_callback_t)(struct i2c_transaction_t *transaction);
+
+/**
+ * A write, a read, or a write followed by a read with a repeated start
+ * (e.g. a register address then its contents). Owned by the submitter, and
+ * must stay valid until it has finished.
+ */
+typedef struct i2c_transaction_t {
+  /*! 8 bit device address. */
+  int address;
+
+  const char *tx;
+  uint32_t tx_len;
+  char *rx;
+  uint32_t rx_len;
+
+  volatile i2c_result_t result;
+
+  /*! Called when finished, may be NULL. */
+  i2c_callback_t callback;
+  void *context;
+
+  /*! Thread signalled when finished, may be NULL. */
+  Thread *notify;
+  int32_t signal;
+} i2c_transaction_t;
+
+/**
+ * One I2C bus and its queue of transactions.
+ */
+typedef struct {
+  I2C *bus;
+  Queue<i2c_transaction_t, I2C_QUEUE_LEN> *queue;
+  Thread *thread;
+
+  uint32_t completed;
+  uint32_t nacked;
+
+  /*! Transactions refused because the queue was full. */
+  uint32_t rejected;
+} i2c_engine_t;
+
+/**
+* @brief Set up a bus and start its bus thread.
+* @param [out] engine Engine state.
+* @param [in] sda Data pin.
+* @param [in] scl Clock pin.
+* @param [in] frequency_hz Bus clock.
+*/
+void i2c_engine_init(i2c_engine_t *engine, PinName sda, PinName scl, int frequency_hz);
+
+/**
+* @brief Queue a transaction without waiting for it. Safe to call from
+*        interrupts.
+* @param [in/out] engine Engine to run the transaction.
+* @param [in/out] transaction Transaction to run, its result is set to
+*                 I2C_PENDING.
+* @return RET_OK if queued, RET_ERROR if the queue is full.
+*/
+int i2c_submit(i2c_engine_t *engine, i2c_transaction_t *transaction);
+
+/**
+* @brief Queue a transaction and sleep until it has finished. For
+*        configuration and other callers that have nothing else to do.
+* @param [in/out] engine Engine to run the transaction.
+* @param [in/out] transaction Transaction to run, callback and notify are
+*                 overwritten.
+* @return Result of the transaction, I2C_PENDING if it could not be queued.
+*/
+i2c_result_t i2c_transfer(i2c_engine_t *engine, i2c_transaction_t *transaction);
+
+#endif  // TC_I2C_ENGINE_H
@@ -0,0 +1,65 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file line_buffer.h
+ * @author Cameron A. Craig
+ * @date 31 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Assembles command lines from typed characters. Nothing here depends
+ *        on mbed.
+ */
+
+#ifndef TC_LINE_BUFFER_H
+#define TC_LINE_BUFFER_H
+
+#include <stdint.h>
+
+/* Longest line, including the terminating NUL. */
+#define LINE_BUFFER_LEN 100
+
+/* Most characters line_buffer_add() asks to echo for one input character. */
+#define LINE_BUFFER_ECHO_LEN 3
+
+/**
+ * A line being typed.
+ */
+typedef struct {
+  char text[LINE_BUFFER_LEN];
+  uint32_t length;
+} line_buffer_t;
+
+/**
+* @brief Clear a line.
+* @param [out] line Line to clear.
+*/
+void line_buffer_clear(line_buffer_t *line);
+
+/**
+* @brief Add a typed character to a line. Printable characters are appended
+*        while there is space, backspace removes the last character and
+*        carriage return or newline complete a non-empty line.
+* @param [in/out] line Line being typed.
+* @param [in] c Typed character.
+* @param [out] echo Characters to echo back to the terminal,
+*              LINE_BUFFER_ECHO_LEN long.
+* @param [out] echo_len Number of characters in echo.
+* @return true if the line is complete, it is then NUL terminated in
+*         line->text and must be cleared once read.
+*/
+bool line_buffer_add(line_buffer_t *line, char c, char *echo, uint32_t *echo_len);
+
+#endif  // TC_LINE_BUFFER_H
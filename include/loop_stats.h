@@ -0,0 +1,116 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file loop_stats.h
+ * @author Cameron A. Craig
+ * @date 10 Feb 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Records timing of a periodic loop as histograms.
+ */
+
+#ifndef TC_LOOP_STATS_H
+#define TC_LOOP_STATS_H
+
+#include <stdint.h>
+#include "config.h"
+
+/**
+ * Histogram of a duration in microseconds. Each bin is
+ * LOOP_STATS_BIN_WIDTH_US wide, the last bin also counts every sample that
+ * is larger than the histogram range.
+ */
+typedef struct {
+  uint32_t bins[LOOP_STATS_NUM_BINS];
+  uint32_t min_us;
+  uint32_t max_us;
+  uint64_t total_us;
+  uint32_t samples;
+} timing_histogram_t;
+
+/**
+ * Timing statistics for a loop that should run once every period_us.
+ */
+typedef struct {
+  /*! Period the loop is expected to run at. */
+  uint32_t period_us;
+
+  /*! Start time of the previous cycle, used to measure the actual period. */
+  uint32_t last_start_us;
+
+  /*! Number of cycles completed. */
+  uint32_t cycles;
+
+  /*! Number of cycles that took longer than period_us to execute. */
+  uint32_t overruns;
+
+  /*! Difference between the measured and expected period. */
+  timing_histogram_t jitter;
+
+  /*! Time taken to execute each cycle. */
+  timing_histogram_t exec;
+
+  /*! Time from the event that released a cycle to the end of that cycle,
+      for loops released by an event such as a complete receiver frame. */
+  timing_histogram_t latency;
+
+  /*! Set by readers to have the loop clear its statistics. */
+  volatile bool reset_requested;
+} loop_stats_t;
+
+/**
+* @brief Clear all statistics and set the expected loop period.
+* @param [out] stats Statistics to initialise.
+* @param [in] period_us Expected period of the loop (microseconds).
+*/
+void loop_stats_init(loop_stats_t *stats, uint32_t period_us);
+
+/**
+* @brief Record the start of a loop cycle.
+* @param [in/out] stats Loop statistics.
+* @param [in] now_us Current time (microseconds).
+*/
+void loop_stats_cycle_start(loop_stats_t *stats, uint32_t now_us);
+
+/**
+* @brief Record the end of a loop cycle.
+* @param [in/out] stats Loop statistics.
+* @param [in] start_us Time passed to loop_stats_cycle_start (microseconds).
+* @param [in] now_us Current time (microseconds).
+*/
+void loop_stats_cycle_end(loop_stats_t *stats, uint32_t start_us, uint32_t now_us);
+
+/**
+* @brief Record the latency from an event to the end of the cycle it released.
+* @param [in/out] stats Loop statistics.
+* @param [in] event_us Time of the event (microseconds).
+* @param [in] now_us Current time (microseconds).
+*/
+void loop_stats_latency(loop_stats_t *stats, uint32_t event_us, uint32_t now_us);
+
+/**
+* @brief Add a sample to a histogram.
+* @param [in/out] hist Histogram to add to.
+* @param [in] value_us Duration to record (microseconds).
+*/
+void timing_histogram_add(timing_histogram_t *hist, uint32_t value_us);
+
+/**
+* @return Mean of all samples in the histogram (microseconds).
+*/
+uint32_t timing_histogram_mean(const timing_histogram_t *hist);
+
+#endif  // TC_LOOP_STATS_H
@@ -0,0 +1,93 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file mixer.h
+ * @author Cameron A. Craig
+ * @date 17 Feb 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Generic drive mixer, driven by the mixing matrix of a drive mode.
+ */
+
+#ifndef TC_MIXER_H
+#define TC_MIXER_H
+
+#include "types.h"
+#include "drive_mode.h"
+
+/**
+* @brief Read the stick vector of a drive mode from the drive controller.
+*        Each component is between -1 and 1, with DRIVE_STICK_DEADBAND
+*        removed around the centre.
+* @param [in] mode Drive mode, giving the channel for each axis.
+* @param [in] frame Controller channel values.
+* @param [out] sticks Stick vector.
+*/
+void mixer_read_sticks(const drive_mode_t *mode, const rc_frame_t *frame, struct direction_vector_t *sticks);
+
+/**
+* @brief Remap a stick vector for a robot that is upside down, so the
+*        driver's controls still move it the same way.
+* @param [in] mode Drive mode, giving the sign of each axis when inverted.
+* @param [in/out] sticks Stick vector.
+*/
+void mixer_invert(const drive_mode_t *mode, struct direction_vector_t *sticks);
+
+/**
+* @brief Mix a stick vector into wheel outputs. If any wheel would be asked
+*        for more than full speed, all wheels are scaled down together so
+*        the direction of travel is kept.
+* @param [in] mode Drive mode, giving the mixing matrix.
+* @param [in] sticks Stick vector.
+* @param [out] outputs Wheel outputs between 0 and 100, unused wheels are
+*              set to 50 (stopped).
+*/
+void mixer_mix(const drive_mode_t *mode, const struct direction_vector_t *sticks, struct rc_outputs_t *outputs);
+
+/**
+* @brief Run a tick of the given drive mode.
+* @param [in] mode Drive mode.
+* @param [in] frame Controller channel values.
+* @param [out] outputs ESC outputs to update.
+*/
+void mixer_drive(const drive_mode_t *mode, const rc_frame_t *frame, struct rc_outputs_t *outputs);
+
+/**
+* @brief Limit every output to the valid range of 0 to 100, whichever drive
+*        and weapon modes produced them.
+* @param [in/out] outputs ESC outputs.
+*/
+void mixer_clamp(struct rc_outputs_t *outputs);
+
+/**
+* @brief Work out every ESC output for one control loop cycle, from the
+*        channel values and what the other tasks know about the robot. The
+*        motor drive task and the trace replay both use this.
+* @param [in] drive_mode Drive mode.
+* @param [in] weapon_mode Weapon mode.
+* @param [in] frame Filtered controller channel values.
+* @param [in] heading_lock Whether the heading lock is on. While the driver
+*             is not rotating, heading_rotation replaces the rotate axis.
+* @param [in] heading_rotation Correction from the heading controller.
+* @param [in] inverted Whether the robot is upside down, see mixer_invert().
+* @param [out] outputs ESC outputs, clamped.
+* @return true if the driver is rotating the robot.
+*/
+bool control_cycle(const drive_mode_t *drive_mode, const weapon_mode_t *weapon_mode,
+  const rc_frame_t *frame, bool heading_lock, control_t heading_rotation, bool inverted,
+  struct rc_outputs_t *outputs);
+
+#endif  // TC_MIXER_H
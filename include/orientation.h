@@ -0,0 +1,68 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * @file orientation.h
+ * @author Cameron A. Craig
+ * @date 17 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Decides whether the robot is upright or inverted from its roll.
+ *        Nothing here depends on mbed, so detection can be checked off
+ *        target.
+ */
+
+#ifndef TC_ORIENTATION_H
+#define TC_ORIENTATION_H
+
+#include <stdint.h>
+#include "types.h"
+
+/**
+ * Debounced orientation, updated with each new roll measurement.
+ */
+typedef struct {
+  /*! Orientation the robot has settled in. */
+  orientation_t orientation;
+
+  /*! Samples in a row that have disagreed with orientation. */
+  uint32_t disagree;
+} orientation_detector_t;
+
+/**
+* @brief Start detection, assuming the robot is upright.
+* @param [out] detector Detector to initialise.
+*/
+void orientation_detector_init(orientation_detector_t *detector);
+
+/**
+* @brief Add a roll measurement. The robot is taken as inverted within
+*        ORIENTATION_ENTER_DEG of ORIENTATION_INVERTED_ROLL, and as upright
+*        again once more than ORIENTATION_LEAVE_DEG away, after
+*        ORIENTATION_SETTLE_SAMPLES measurements in a row agree.
+* @param [in/out] detector Detector state.
+* @param [in] roll Measured roll (degrees).
+* @return true if the orientation changed with this measurement.
+*/
+bool orientation_detect(orientation_detector_t *detector, float roll);
+
+/**
+* @brief Orientation to drive in.
+* @param [in] detected Orientation found by the detector.
+* @param [in] override Orientation set by the user, or ORIENTATION_AUTO.
+* @return override, or detected if override is ORIENTATION_AUTO.
+*/
+orientation_t orientation_effective(orientation_t detected, orientation_t override);
+
+#endif  // TC_ORIENTATION_H
@@ -0,0 +1,158 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file rc_capture.h
+ * @author Cameron A. Craig
+ * @date 24 Feb 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Buffers pulses captured from a receiver, and detects complete frames.
+ */
+
+#ifndef TC_RC_CAPTURE_H
+#define TC_RC_CAPTURE_H
+
+#include <stdint.h>
+#include "mbed.h"
+#include "rtos.h"
+#include "config.h"
+#include "spsc_ring.h"
+#include "receiver_decode.h"
+#include "clock.h"
+
+/**
+ * A single pulse measured on a receiver channel.
+ */
+typedef struct {
+  /*! Time of the falling edge that ended the pulse (microseconds). */
+  uint32_t timestamp_us;
+  /*! Pulse width (microseconds). */
+  uint16_t width_us;
+  /*! Receiver channel the pulse was measured on. */
+  uint8_t channel;
+} rc_pulse_t;
+
+struct rc_capture_t;
+
+/**
+ * State of one captured channel, written by the receiver interrupts.
+ */
+typedef struct {
+  struct rc_capture_t *capture;
+  uint32_t index;
+  /*! Used by PWM receivers, which have a pin per channel. */
+  InterruptIn *pin;
+  volatile uint32_t rise_us;
+  volatile uint32_t width_us;
+  /*! Time of the last pulse inside the filter range (see
+      rc_input_pulse_valid()), from clock_now_us(), 0 if none yet. */
+  volatile uint64_t valid_us;
+} rc_capture_channel_t;
+
+/**
+ * All channels of a receiver. The receiver implementation (see receiver.h)
+ * pushes each measured pulse into a ring from its interrupts, so the
+ * control loop only converts channels that have changed.
+ * When every channel has produced a pulse since the last frame, the frame
+ * is complete and the notify thread, if any, is signalled.
+ */
+typedef struct rc_capture_t {
+  rc_capture_channel_t channel[RC_NUMBER_CHANNELS];
+  SpscRing<rc_pulse_t, RC_CAPTURE_RING_LEN> pulses;
+
+  /*! Channels that have produced a pulse in range since the last complete
+      frame. */
+  volatile uint32_t fresh;
+
+  /*! Number of complete frames, and the time the last one completed. */
+  volatile uint32_t frames;
+  volatile uint64_t frame_us;
+
+  Thread *notify;
+  int32_t signal;
+
+  /*! Called from interrupt context each time a frame completes. */
+  void (*frame_hook)(void *context);
+  void *frame_context;
+
+  /*! Input used by single wire receivers, an InterruptIn or RawSerial. */
+  void *device;
+
+  /*! Protocol decoder of single wire receivers. */
+  union {
+    ppm_decoder_t ppm;
+    sbus_decoder_t sbus;
+  } decoder;
+} rc_capture_t;
+
+/**
+* @brief Set up the channels of a receiver, called by receiver
+*        implementations before enabling their interrupts.
+* @param [out] capture Receiver capture state.
+*/
+void rc_capture_init(rc_capture_t *capture);
+
+/**
+* @brief Record a pulse, called from receiver interrupts. A width outside
+*        the filter range reaches the loop, but doesn't count towards a
+*        frame or the channel's age.
+* @param [in/out] capture Receiver capture state.
+* @param [in] channel Channel index, pulses on other channels are ignored.
+* @param [in] width_us Pulse width (microseconds).
+* @param [in] now_us Time the pulse ended, from clock_now_us().
+*/
+void rc_capture_pulse(rc_capture_t *capture, uint32_t channel, uint32_t width_us, uint64_t now_us);
+
+/**
+* @brief Signal a thread each time the receiver completes a frame.
+* @param [in/out] capture Receiver capture state.
+* @param [in] thread Thread to signal, NULL to stop signalling.
+* @param [in] signal Signal flags to set.
+*/
+void rc_capture_notify(rc_capture_t *capture, Thread *thread, int32_t signal);
+
+/**
+* @brief Call a function from interrupt context each time the receiver
+*        completes a frame.
+* @param [in/out] capture Receiver capture state.
+* @param [in] hook Function to call, NULL to stop calling it.
+* @param [in] context Argument passed to hook.
+*/
+void rc_capture_on_frame(rc_capture_t *capture, void (*hook)(void *context), void *context);
+
+/**
+* @param [in] capture Receiver capture state.
+* @param [in] channel Channel index.
+* @return Width of the last pulse on a channel (microseconds).
+*/
+float rc_capture_pulsewidth(const rc_capture_t *capture, int channel);
+
+/**
+* @param [in] capture Receiver capture state.
+* @param [in] channel Channel index.
+* @return Time since the last valid pulse on a channel (microseconds),
+*         saturating at 0xFFFFFFFF if there has been none.
+*/
+uint32_t rc_capture_age_us(const rc_capture_t *capture, int channel);
+
+/**
+* @param [in] capture Receiver capture state.
+* @return Age of the oldest channel of a receiver (microseconds), so a
+*         receiver is only fresh if every channel is.
+*/
+uint32_t rc_capture_max_age_us(const rc_capture_t *capture);
+
+#endif  // TC_RC_CAPTURE_H
@@ -0,0 +1,119 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file rc_input.h
+ * @author Cameron A. Craig
+ * @date 10 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Turns raw receiver pulse widths into channel values, by filtering
+ *        and applying the calibrated channel limits. Nothing here depends on
+ *        mbed, so the filter kernel can be built and timed off target.
+ */
+
+#ifndef TC_RC_INPUT_H
+#define TC_RC_INPUT_H
+
+#include <stdint.h>
+#include "config.h"
+#include "types.h"
+
+/* Filter stages, set in input_filter_t::stages */
+#define RC_FILTER_RANGE  0x01  // Reject widths outside RC_FILTER_MIN_US -> RC_FILTER_MAX_US
+#define RC_FILTER_STEP   0x02  // Hold jumps larger than RC_FILTER_MAX_STEP_US for a second width
+#define RC_FILTER_MEDIAN 0x04  // Median of the last 3 accepted widths
+#define RC_FILTER_IIR    0x08  // One pole low pass, see RC_FILTER_IIR_SHIFT
+
+/**
+ * Pulse widths received from every controller during one loop cycle. Only
+ * channels with their bit set in fresh have a new width.
+ */
+typedef struct {
+  uint16_t width_us[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS];
+  uint32_t fresh[RC_NUMBER_CONTROLLERS];
+} rc_raw_frame_t;
+
+/**
+ * Filter state of a single channel.
+ */
+typedef struct {
+  /*! Last accepted widths, newest first. */
+  uint16_t history[3];
+  uint8_t samples;
+  /*! First width of a step, waiting for the next to confirm it, 0 if none. */
+  uint16_t step_us;
+  /*! Output of the low pass filter, in 1/16 microseconds. */
+  int32_t iir;
+  /*! Number of widths rejected. */
+  uint32_t rejected;
+} rc_filter_channel_t;
+
+/**
+ * Filter state of every channel.
+ */
+typedef struct {
+  /*! Enabled stages, RC_FILTER_* flags. */
+  uint32_t stages;
+  rc_filter_channel_t channel[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS];
+} input_filter_t;
+
+/**
+* @brief Check a width is one a working receiver sends, strictly between
+*        RC_FILTER_MIN_US and RC_FILTER_MAX_US. Only these widths complete
+*        frames and keep a channel's age current, so a receiver stuck out of
+*        range fails safe like one that has stopped.
+* @param [in] width_us Pulse width (microseconds).
+* @return true if the width is in range.
+*/
+bool rc_input_pulse_valid(uint32_t width_us);
+
+/**
+* @brief Clear filter state and counters.
+* @param [out] filter Filter to initialise.
+* @param [in] stages RC_FILTER_* flags of the stages to enable.
+*/
+void input_filter_init(input_filter_t *filter, uint32_t stages);
+
+/**
+* @brief Filter every fresh width of a frame in place. Rejected widths have
+*        their fresh bit cleared, so the channel keeps its previous value.
+* @param [in/out] filter Filter state.
+* @param [in/out] raw Widths to filter.
+*/
+void input_filter_run(input_filter_t *filter, rc_raw_frame_t *raw);
+
+/**
+* @brief Convert the fresh widths of a frame into channel values between 0
+*        and 100. Channels without a fresh width are left unchanged.
+* @param [in] raw Pulse widths.
+* @param [in] limits Calibrated limits of every channel.
+* @param [in/out] frame Channel values to update.
+*/
+void rc_input_to_controls(const rc_raw_frame_t *raw,
+  const channel_limits_t limits[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS], rc_frame_t *frame);
+
+/**
+* @brief Filter the widths received in one loop cycle and convert them into
+*        channel values, without changing the widths as received.
+* @param [in/out] filter Filter state.
+* @param [in] pulses Widths received this cycle.
+* @param [in] limits Calibrated limits of every channel.
+* @param [in/out] frame Channel values to update.
+*/
+void rc_input_update(input_filter_t *filter, const rc_raw_frame_t *pulses,
+  const channel_limits_t limits[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS], rc_frame_t *frame);
+
+#endif  // TC_RC_INPUT_H
@@ -0,0 +1,51 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file receiver.h
+ * @author Cameron A. Craig
+ * @date 3 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Receiver implementations, selected per controller in config.h.
+ */
+
+#ifndef TC_RECEIVER_H
+#define TC_RECEIVER_H
+
+#include "stdint.h"
+#include "mbed.h"
+#include "rc_capture.h"
+
+/**
+ * Allow up to 2^32 types of receiver!
+ */
+typedef uint32_t receiver_impl_id_t;
+
+/**
+ * Provides functions and parameters related to a particular receiver
+ * implementation. Every implementation fills an rc_capture_t with pulse
+ * widths in microseconds, so calibration and the control loop don't depend
+ * on the type of receiver.
+ */
+typedef struct {
+  receiver_impl_id_t impl_id;
+  const char *str;
+  /*! Start capturing. Receivers with a pin per channel use channel_pins,
+      single wire receivers use signal_pin. */
+  void (*init)(rc_capture_t *capture, const PinName *channel_pins, PinName signal_pin);
+} receiver_impl_t;
+
+#endif  // TC_RECEIVER_H
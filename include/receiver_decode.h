@@ -0,0 +1,94 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file receiver_decode.h
+ * @author Cameron A. Craig
+ * @date 3 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Decoders for single wire receiver protocols. Nothing here depends
+ *        on mbed, so recorded pulse trains and frames can be decoded off
+ *        target.
+ */
+
+#ifndef TC_RECEIVER_DECODE_H
+#define TC_RECEIVER_DECODE_H
+
+#include <stdint.h>
+
+/* PPM: a gap at least this long marks the start of a frame. */
+#define PPM_SYNC_MIN_US 2700
+
+/* SBUS: 25 byte frames of 16 channels, 11 bits each. */
+#define SBUS_FRAME_LEN 25
+#define SBUS_NUM_CHANNELS 16
+#define SBUS_HEADER 0x0F
+#define SBUS_FLAG_FRAME_LOST 0x04
+#define SBUS_FLAG_FAILSAFE 0x08
+/* Bytes of a frame arrive back to back, a longer gap starts a new frame. */
+#define SBUS_BYTE_GAP_US 2000
+
+/**
+ * State of a PPM sum decoder. Channel widths are the intervals between
+ * consecutive edges of the same polarity.
+ */
+typedef struct {
+  uint32_t edge_us;
+  uint32_t next_channel;
+  /*! Set once an edge has been seen, the first has no interval to measure. */
+  bool started;
+  bool synced;
+} ppm_decoder_t;
+
+/**
+ * State of an SBUS decoder, the frame being received.
+ */
+typedef struct {
+  uint8_t frame[SBUS_FRAME_LEN];
+  uint32_t length;
+  uint32_t byte_us;
+} sbus_decoder_t;
+
+/**
+* @brief Decode an edge of a PPM signal.
+* @param [in/out] ppm Decoder state.
+* @param [in] now_us Time of the edge (microseconds).
+* @param [out] width_us Width of the channel completed by this edge.
+* @return Index of the channel completed by this edge, or -1 if the edge
+*         ended a sync gap or the decoder has not seen one yet.
+*/
+int ppm_decode_edge(ppm_decoder_t *ppm, uint32_t now_us, uint32_t *width_us);
+
+/**
+* @brief Add a received byte to an SBUS frame.
+* @param [in/out] sbus Decoder state.
+* @param [in] byte Received byte.
+* @param [in] now_us Time the byte was received (microseconds).
+* @return true when the byte completes a frame, which is then in sbus->frame.
+*/
+bool sbus_decode_byte(sbus_decoder_t *sbus, uint8_t byte, uint32_t now_us);
+
+/**
+* @brief Unpack the channels of a complete SBUS frame as equivalent PWM
+*        pulse widths, so they share calibration with PWM and PPM receivers.
+* @param [in] frame SBUS_FRAME_LEN bytes.
+* @param [out] width_us Pulse width of each channel (microseconds).
+* @param [in] channels Number of channels to unpack, at most SBUS_NUM_CHANNELS.
+* @return false if the receiver has flagged failsafe, true otherwise.
+*/
+bool sbus_frame_channels(const uint8_t *frame, uint16_t *width_us, int channels);
+
+#endif  // TC_RECEIVER_DECODE_H
@@ -0,0 +1,38 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file receiver_ppm.h
+ * @author Cameron A. Craig
+ * @date 3 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Receiver with a PPM sum signal carrying every channel.
+ */
+
+#ifndef TC_RECEIVER_PPM_H
+#define TC_RECEIVER_PPM_H
+
+#include "receiver.h"
+
+//Make sure that IDs are unique when adding new receiver implementations!
+#define RECEIVER_IMPL_PPM 1
+
+/**
+* @brief Decode the PPM sum signal on a single pin.
+*/
+void receiver_impl_ppm_init(rc_capture_t *capture, const PinName *channel_pins, PinName signal_pin);
+
+#endif  // TC_RECEIVER_PPM_H
@@ -0,0 +1,39 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file receiver_sbus.h
+ * @author Cameron A. Craig
+ * @date 3 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Receiver with an SBUS serial output.
+ */
+
+#ifndef TC_RECEIVER_SBUS_H
+#define TC_RECEIVER_SBUS_H
+
+#include "receiver.h"
+
+//Make sure that IDs are unique when adding new receiver implementations!
+#define RECEIVER_IMPL_SBUS 2
+
+/**
+* @brief Decode SBUS frames received on a UART RX pin.
+* @note SBUS is an inverted signal, it needs an inverter in front of the pin.
+*/
+void receiver_impl_sbus_init(rc_capture_t *capture, const PinName *channel_pins, PinName signal_pin);
+
+#endif  // TC_RECEIVER_SBUS_H
@@ -0,0 +1,121 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * @file replay.h
+ * @author Cameron A. Craig
+ * @date 19 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Runs recorded receiver input back through the control pipeline in
+ *        virtual time, and checks it produces what was recorded. Nothing
+ *        here depends on mbed, so traces can be replayed off target.
+ */
+
+#ifndef TC_REPLAY_H
+#define TC_REPLAY_H
+
+#include <stdint.h>
+#include "config.h"
+#include "types.h"
+#include "states.h"
+#include "drive_mode.h"
+#include "rc_input.h"
+#include "blackbox.h"
+
+/**
+ * Differences found between a trace and its replay.
+ */
+typedef struct {
+  /*! Records replayed. */
+  uint32_t cycles;
+
+  /*! Records compared, the first REPLAY_SETTLE_CYCLES are not while the
+      input filter fills. */
+  uint32_t compared;
+
+  /*! Records whose channel values, outputs or arm state differed. */
+  uint32_t control_mismatches;
+  uint32_t output_mismatches;
+  uint32_t state_mismatches;
+
+  /*! Records with the heading lock on, whose wheel outputs depend on the
+      orientation task and are not compared. */
+  uint32_t unverified;
+
+  /*! Index of the first record that differed, -1 if none. */
+  int32_t first_mismatch;
+} replay_stats_t;
+
+/**
+ * Everything the robot's tasks keep between control loop cycles, driven
+ * by the records of a trace instead of the receivers and timers.
+ */
+typedef struct {
+  const channel_limits_t (*limits)[RC_NUMBER_CHANNELS];
+  const drive_mode_t *drive_mode;
+  const weapon_mode_t *weapon_mode;
+
+  input_filter_t filter;
+  rc_frame_t frame;
+  state_t state;
+
+  /*! Virtual time of each channel's last pulse, and of each receiver's
+      last complete frame (microseconds). */
+  uint32_t pulse_us[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS];
+  uint32_t frame_us[RC_NUMBER_CONTROLLERS];
+
+  /*! Channels with a pulse since each receiver's last frame. */
+  uint32_t frame_fresh[RC_NUMBER_CONTROLLERS];
+
+  /*! Set while a receiver's failsafe deadline is running. */
+  bool deadline[RC_NUMBER_CONTROLLERS];
+
+  /*! Virtual time of the next check of the arming switches, once it has
+      been lined up with the recorded arming task. */
+  uint32_t arm_us;
+  bool arm_synced;
+
+  /*! State recorded in the previous record. */
+  state_t recorded_state;
+
+  replay_stats_t stats;
+} replay_t;
+
+/**
+* @brief Start a replay with the robot's configuration. The state is taken
+*        from the first record.
+* @param [out] replay Replay to initialise.
+* @param [in] limits Calibrated limits of every channel.
+* @param [in] drive_mode Drive mode the trace was recorded with.
+* @param [in] weapon_mode Weapon mode the trace was recorded with.
+* @param [in] filter_stages RC_FILTER_* flags the trace was recorded with.
+*/
+void replay_init(replay_t *replay,
+  const channel_limits_t limits[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS],
+  const drive_mode_t *drive_mode, const weapon_mode_t *weapon_mode, uint32_t filter_stages);
+
+/**
+* @brief Run one record through the pipeline: failsafe deadlines, the
+*        arming switches, the input filter, the drive and weapon modes and
+*        the output limits, and compare the result with the record.
+* @param [in/out] replay Replay state.
+* @param [in] record Next record of the trace.
+* @param [out] result What the pipeline produced, in the same form as the
+*              record. May be NULL.
+* @return true if the result matches the record, or was not compared.
+*/
+bool replay_cycle(replay_t *replay, const blackbox_record_t *record, blackbox_record_t *result);
+
+#endif  // TC_REPLAY_H
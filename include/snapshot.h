@@ -0,0 +1,88 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file snapshot.h
+ * @author Cameron A. Craig
+ * @date 12 Feb 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Single writer, multiple reader snapshot of a structure.
+ */
+
+#ifndef TC_SNAPSHOT_H
+#define TC_SNAPSHOT_H
+
+#include <stdint.h>
+#include "mbed.h"
+
+/** @class Snapshot
+    @brief Publishes a copy of a structure from one writer to any number of
+           readers without locking.
+
+    The writer fills the buffer that readers are not using and then flips a
+    sequence counter to publish it, so a whole frame becomes visible in one
+    step. Readers copy the published buffer and retry only if the writer
+    published again while they were copying.
+
+    Readers never wait on the writer, so a high priority reader that
+    preempts the writer part way through publish() reads the previous frame
+    rather than spinning or inverting priorities.
+
+    @note Only one thread may call publish(). The object is valid when zero
+          initialised, so it can live in memset structures like thread_args_t.
+*/
+template <typename T>
+class Snapshot {
+  public:
+  /**
+  * @brief Make a new value visible to readers.
+  * @param [in] value Value to publish.
+  */
+  void publish(const T &value) {
+    uint32_t next = sequence_ + 1;
+    buffer_[next & 1] = value;
+    // The buffer must be complete before the sequence number says so.
+    __DMB();
+    sequence_ = next;
+  }
+
+  /**
+  * @brief Copy the most recently published value.
+  * @param [out] value Destination of the copy.
+  */
+  void read(T *value) const {
+    uint32_t sequence;
+    do {
+      sequence = sequence_;
+      __DMB();
+      *value = buffer_[sequence & 1];
+      __DMB();
+    } while (sequence != sequence_);
+  }
+
+  /**
+  * @return Number of values published so far.
+  */
+  uint32_t sequence(void) const {
+    return sequence_;
+  }
+
+  private:
+  T buffer_[2];
+  volatile uint32_t sequence_;
+};
+
+#endif  // TC_SNAPSHOT_H
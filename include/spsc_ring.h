@@ -0,0 +1,103 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file spsc_ring.h
+ * @author Cameron A. Craig
+ * @date 24 Feb 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Lock-free ring buffer with one producer and one consumer.
+ */
+
+#ifndef TC_SPSC_RING_H
+#define TC_SPSC_RING_H
+
+#include <stdint.h>
+#include "mbed.h"
+
+/** @class SpscRing
+    @brief Queue of fixed size elements passed from one producer, such as an
+           interrupt handler, to one consumer thread without locking.
+
+    The producer only writes head_ and the consumer only writes tail_, so
+    neither side ever waits for the other. When the ring is full new
+    elements are dropped and counted, the consumer always sees the oldest
+    elements it has not yet read.
+
+    @note N must be a power of two. The object is valid when zero
+          initialised.
+*/
+template <typename T, uint32_t N>
+class SpscRing {
+  public:
+  /**
+  * @brief Add an element, called only by the producer.
+  * @param [in] value Element to add.
+  * @return true if added, false if the ring was full.
+  */
+  bool push(const T &value) {
+    uint32_t head = head_;
+    if (head - tail_ >= N) {
+      dropped_++;
+      return false;
+    }
+    buffer_[head & (N - 1)] = value;
+    // The element must be complete before the consumer can see it.
+    __DMB();
+    head_ = head + 1;
+    return true;
+  }
+
+  /**
+  * @brief Remove the oldest element, called only by the consumer.
+  * @param [out] value Removed element.
+  * @return true if an element was removed, false if the ring was empty.
+  */
+  bool pop(T *value) {
+    uint32_t tail = tail_;
+    if (tail == head_) {
+      return false;
+    }
+    __DMB();
+    *value = buffer_[tail & (N - 1)];
+    // The element must be copied before the producer can reuse its slot.
+    __DMB();
+    tail_ = tail + 1;
+    return true;
+  }
+
+  /**
+  * @return Number of elements waiting to be read.
+  */
+  uint32_t count(void) const {
+    return head_ - tail_;
+  }
+
+  /**
+  * @return Number of elements dropped because the ring was full.
+  */
+  uint32_t dropped(void) const {
+    return dropped_;
+  }
+
+  private:
+  T buffer_[N];
+  volatile uint32_t head_;
+  volatile uint32_t tail_;
+  volatile uint32_t dropped_;
+};
+
+#endif  // TC_SPSC_RING_H
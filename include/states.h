@@ -25,6 +25,8 @@
 #ifndef TC_STATES_T
 #define TC_STATES_T
 
+#include "types.h"
+
 enum state_t {
   STATE_DISARMED = 0,
   STATE_DRIVE_ONLY,
@@ -37,4 +39,27 @@ enum state_t {
 */
 const char * state_to_str(state_t state);
 
+/**
+* @brief Work out the next arm state from the arming switches. A controller
+*        only arms when its sticks are centred and its throttle is closed,
+*        and never while its receiver is stalled. Disarming only needs the
+*        switch, and a stalled receiver disarms its controller as if the
+*        switch were off.
+* @param [in] state Current arm state.
+* @param [in] frame Controller channel values.
+* @param [in] drive_stalled true if the drive receiver has stopped sending.
+* @param [in] weapon_stalled true if the weapon receiver has stopped sending.
+* @return New arm state.
+*/
+state_t state_arm(state_t state, const rc_frame_t *frame, bool drive_stalled, bool weapon_stalled);
+
+/**
+* @brief Lower the arm state when a receiver misses its deadline.
+* @param [in] state Current arm state.
+* @param [in] controller Controller that failed, 0 for the weapon and 1 for
+*             the drive.
+* @return New arm state.
+*/
+state_t state_failsafe(state_t state, int controller);
+
 #endif //TC_STATES_T
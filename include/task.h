@@ -38,6 +38,9 @@ typedef struct {
   void * args;
   osPriority priority;
   uint32_t stack_size;
+  /*! Period the task is released at, 0 if it is woken by events. Runs that
+      take longer are counted as deadline misses, see cpu_monitor.h. */
+  uint32_t period_us;
   volatile bool active;
 } task_t;
 
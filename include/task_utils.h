@@ -25,11 +25,45 @@
 #include "thread_args.h"
 
 /**
-* @brief Read PWM values from receiver.
+* @brief Read PWM values from receiver, filter them (see rc_input.h) and
+*        publish them in args->controls.
+* @param [in/out] args Thread arguments.
+* @param [in/out] frame Channel values, updated with the pulses captured
+*                 since the previous call and then published.
 */
-void read_recv_pw(thread_args_t *args);
+void read_recv_pw(thread_args_t *args, rc_frame_t *frame);
 
 /**
-* @brief Set value of output ESC using configured comms method.
+* @brief Clamp outputs, publish them in args->outputs and set the value of
+*        output ESCs using configured comms method.
+* @param [in/out] args Thread arguments.
+* @param [in/out] outputs Outputs calculated by the drive and weapon modes.
 */
-void set_output_escs(thread_args_t *args);
+void set_output_escs(thread_args_t *args, struct rc_outputs_t *outputs);
+
+/**
+* @brief Write an encoded telemetry frame to the ESP8266.
+* @param [in] args Thread arguments.
+* @param [in] data Bytes to write.
+* @param [in] length Number of bytes in data.
+*/
+void esp_serial_write(thread_args_t *args, const uint8_t *data, uint32_t length);
+
+/**
+* @brief Block the calling task for a time, reporting to the CPU monitor
+*        that it blocked and that its next run starts when it wakes.
+* @param [in] task_id ID of the calling task.
+* @param [in] ms Time to wait (milliseconds).
+*/
+void task_wait(unsigned task_id, uint32_t ms);
+
+/**
+* @brief Wait for thread signals as Thread::signal_wait(), reporting to the
+*        CPU monitor that the task blocked and that its next run starts when
+*        it wakes.
+* @param [in] task_id ID of the calling task.
+* @param [in] signals Signals to wait for.
+* @param [in] ms Longest time to wait (milliseconds), or osWaitForever.
+* @return Event from Thread::signal_wait().
+*/
+osEvent task_signal_wait(unsigned task_id, int32_t signals, uint32_t ms);
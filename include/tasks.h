@@ -57,10 +57,6 @@ static const unsigned TASK_MOTOR_DRIVE_ID = __COUNTER__;
 static const unsigned TASK_ARMING_ID = __COUNTER__;
 #endif
 
-#ifdef TASK_FAILSAFE
-static const unsigned TASK_FAILSAFE_ID = __COUNTER__;
-#endif
-
 #if defined(TASK_CALC_ORIENTATION) && defined(DEVICE_BNO055)
 static const unsigned TASK_CALC_ORIENTATION_ID = __COUNTER__;
 #endif
@@ -84,6 +80,15 @@ static const unsigned TASK_DEBUG_ID = __COUNTER__;
 static const unsigned NUM_TASKS = __COUNTER__;
 
 
+/* Periods of the tasks that are released at a fixed rate. The motor drive
+   task runs once per receiver frame when CONTROL_LOOP_FRAME_SYNC is set.
+   main() sets the orientation task's period from the BNO055's data rate. */
+#ifdef CONTROL_LOOP_FRAME_SYNC
+#define TASK_MOTOR_DRIVE_PERIOD_US RC_FRAME_PERIOD_US
+#else
+#define TASK_MOTOR_DRIVE_PERIOD_US CONTROL_LOOP_PERIOD_US
+#endif
+
 /* Function signatures */
 
 void task_start(thread_args_t targs, unsigned task_id);
@@ -108,10 +113,6 @@ void task_motor_drive(const void *targs);
 void task_arming(const void *targs);
 #endif
 
-#ifdef TASK_FAILSAFE
-void task_failsafe(const void *targs);
-#endif
-
 #if defined(TASK_CALC_ORIENTATION) && defined(DEVICE_BNO055)
 // void task_calc_escs(const void *targs);
 void task_calc_orientation(const void *targs);
@@ -138,37 +139,34 @@ void task_print_channels(const void *targs);
 
 static volatile task_t tasks[] = {
 #ifdef TASK_READ_SERIAL
-  {.id = TASK_READ_SERIAL_ID,        .name = "Read Serial",        .func = task_read_serial,        .args = NULL, .priority = osPriorityRealtime, .stack_size = 1024, .active = true},
+  {.id = TASK_READ_SERIAL_ID,        .name = "Read Serial",        .func = task_read_serial,        .args = NULL, .priority = osPriorityBelowNormal, .stack_size = 1024, .period_us = 0, .active = true},
 #endif
 #ifdef TASK_PROCESS_COMMANDS
-  {.id = TASK_PROCESS_COMMANDS_ID,   .name = "Process Commands",   .func = task_process_commands,   .args = NULL, .priority = osPriorityHigh,     .stack_size = 2048, .active = true},
+  {.id = TASK_PROCESS_COMMANDS_ID,   .name = "Process Commands",   .func = task_process_commands,   .args = NULL, .priority = osPriorityBelowNormal, .stack_size = 2048, .period_us = 0, .active = true},
 #endif
 #ifdef TASK_LED_STATE
-  {.id = TASK_LED_STATE_ID,          .name = "LED State",          .func = task_state_leds,         .args = NULL, .priority = osPriorityNormal, .stack_size = 1024,   .active = true},
+  {.id = TASK_LED_STATE_ID,          .name = "LED State",          .func = task_state_leds,         .args = NULL, .priority = osPriorityNormal, .stack_size = 1024, .period_us = 100000,   .active = true},
 #endif
 #ifdef TASK_MOTOR_DRIVE
-  {.id = TASK_MOTOR_DRIVE_ID,        .name = "Motor Drive",        .func = task_motor_drive,        .args = NULL, .priority = osPriorityNormal, .stack_size = 1024,   .active = true},
+  {.id = TASK_MOTOR_DRIVE_ID,        .name = "Motor Drive",        .func = task_motor_drive,        .args = NULL, .priority = osPriorityNormal, .stack_size = 1024, .period_us = TASK_MOTOR_DRIVE_PERIOD_US,   .active = true},
 #endif
 #ifdef TASK_ARMING
-  {.id = TASK_ARMING_ID,             .name = "Arming" ,            .func = task_arming,             .args = NULL, .priority = osPriorityNormal, .stack_size = 1024,   .active = true},
-#endif
-#ifdef TASK_FAILSAFE
-  {.id = TASK_FAILSAFE_ID,           .name = "Failsafe" ,          .func = task_failsafe,           .args = NULL, .priority = osPriorityNormal, .stack_size = 1024,  .active = true},
+  {.id = TASK_ARMING_ID,             .name = "Arming" ,            .func = task_arming,             .args = NULL, .priority = osPriorityNormal, .stack_size = 1024, .period_us = ARMING_PERIOD_MS * 1000,   .active = true},
 #endif
 #if defined(TASK_CALC_ORIENTATION) && defined(DEVICE_BNO055)
-  {.id = TASK_CALC_ORIENTATION_ID,   .name = "Calc Orientation",   .func = task_calc_orientation,   .args = NULL, .priority = osPriorityNormal, .stack_size = 2048,  .active = false},
+  {.id = TASK_CALC_ORIENTATION_ID,   .name = "Calc Orientation",   .func = task_calc_orientation,   .args = NULL, .priority = osPriorityNormal, .stack_size = 2048, .period_us = 0,  .active = false},
 #endif
 #ifdef TASK_COLLECT_TELEMETRY
-  {.id = TASK_COLLECT_TELEMETRY_ID,  .name = "Collect Telemetry",  .func = task_collect_telemetry,  .args = NULL, .priority = osPriorityNormal, .stack_size = 1024,  .active = true},
+  {.id = TASK_COLLECT_TELEMETRY_ID,  .name = "Collect Telemetry",  .func = task_collect_telemetry,  .args = NULL, .priority = osPriorityNormal, .stack_size = 1024, .period_us = 0,  .active = true},
 #endif
 #if defined(TASK_STREAM_TELEMETRY) && defined(DEVICE_ESP8266)
-  {.id = TASK_STREAM_TELEMETRY_ID,   .name = "Stream Telemetry",   .func = task_stream_telemetry,   .args = NULL, .priority = osPriorityNormal, .stack_size = 1024,  .active = true},
+  {.id = TASK_STREAM_TELEMETRY_ID,   .name = "Stream Telemetry",   .func = task_stream_telemetry,   .args = NULL, .priority = osPriorityNormal, .stack_size = 2048, .period_us = TELEMETRY_STREAM_PERIOD_MS * 1000,  .active = true},
 #endif
 #ifdef TASK_CALIBRATE_CHANNELS
-  {.id = TASK_CALIBRATE_CHANNELS_ID, .name = "Calibrate Channels", .func = task_calibrate_channels, .args = NULL, .priority = osPriorityNormal, .stack_size = 1024,  .active = false},
+  {.id = TASK_CALIBRATE_CHANNELS_ID, .name = "Calibrate Channels", .func = task_calibrate_channels, .args = NULL, .priority = osPriorityNormal, .stack_size = 1024, .period_us = 0,  .active = false},
 #endif
 #ifdef TASK_DEBUG
-  {.id = TASK_DEBUG_ID, .name = "Debug", .func = task_debug, .args = NULL, .priority = osPriorityNormal, .stack_size = 1024,  .active = true}
+  {.id = TASK_DEBUG_ID, .name = "Debug", .func = task_debug, .args = NULL, .priority = osPriorityNormal, .stack_size = 1024, .period_us = 1000000,  .active = true}
 #endif
 };
 
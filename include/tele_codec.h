@@ -0,0 +1,283 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file tele_codec.h
+ * @author Cameron A. Craig
+ * @date 7 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Binary telemetry frames: varint packed values, a CRC and COBS
+ *        framing. Used to encode on the mbed and to decode on a host, so
+ *        nothing here depends on mbed.
+ */
+
+#ifndef TC_TELE_CODEC_H
+#define TC_TELE_CODEC_H
+
+#include <stdint.h>
+#include "tele_param.h"
+
+/* Longest frame before COBS framing, including the header and CRC. */
+#define TELE_FRAME_MAX_LEN 254
+
+/* Longest frame once COBS encoded, including the zero delimiter. COBS adds
+   one byte for every 254 bytes of data, plus the leading code byte. */
+#define TELE_ENCODED_MAX_LEN (TELE_FRAME_MAX_LEN + TELE_FRAME_MAX_LEN / 254 + 2)
+
+/* Floats are sent as integers in units of 1 / TELE_FLOAT_SCALE. */
+#define TELE_FLOAT_SCALE 100
+
+/* Bytes in the frame header: type, schema id and sequence number. */
+#define TELE_HEADER_LEN 4
+
+/* Longest parameter name carried in a metadata frame. */
+#define TELE_NAME_MAX_LEN 32
+
+/* Most parameters whose last sent value a delta encoder can track. */
+#define TELE_DELTA_MAX_PARAMS 32
+
+/**
+ * Kinds of telemetry frame, the first byte of every frame.
+ */
+typedef enum {
+  /*! The value of every parameter, in parameter order. */
+  TELE_FRAME_VALUES = 1,
+
+  /*! Name, type and unit of one parameter. */
+  TELE_FRAME_META,
+
+  /*! Index and value of each parameter that has changed since it was last
+      sent. */
+  TELE_FRAME_DELTA
+} tele_frame_type_t;
+
+/**
+ * A frame being built or one that has been decoded. Decoded frames have
+ * had the CRC checked and removed.
+ */
+typedef struct {
+  uint8_t data[TELE_FRAME_MAX_LEN];
+  uint32_t length;
+} tele_frame_t;
+
+/**
+ * Header present at the start of every frame.
+ */
+typedef struct {
+  tele_frame_type_t type;
+
+  /*! Identifies the parameter table the frame was encoded against. */
+  uint16_t schema;
+
+  /*! Incremented for every values frame, to count lost frames. */
+  uint8_t sequence;
+} tele_header_t;
+
+/**
+ * A decoded parameter value.
+ */
+typedef union {
+  float f;
+  int32_t i;
+  bool b;
+} tele_value_t;
+
+/**
+ * Tracks the last value sent for each parameter, so that only parameters
+ * that have moved past their deadband are sent between keyframes.
+ */
+typedef struct {
+  tele_value_t last[TELE_DELTA_MAX_PARAMS];
+
+  /*! Frames between keyframes, which send every value. */
+  uint32_t keyframe_interval;
+  uint32_t frames_since_keyframe;
+
+  /*! Send a keyframe next, e.g. after the receiver has reconnected. */
+  volatile bool keyframe_requested;
+
+  /*! Encoded length of the last keyframe, what each frame would cost if
+      every value was sent. */
+  uint32_t keyframe_len;
+
+  uint32_t keyframes;
+  uint32_t deltas;
+
+  /*! Values sent and values held back by their deadband. */
+  uint32_t values_sent;
+  uint32_t values_skipped;
+
+  /*! Bytes written to the link, and bytes saved by sending deltas rather
+      than keyframes. */
+  uint32_t bytes_sent;
+  uint32_t bytes_saved;
+} tele_delta_t;
+
+/**
+ * Reassembles frames from a stream of bytes.
+ */
+typedef struct {
+  uint8_t buffer[TELE_ENCODED_MAX_LEN];
+  uint32_t length;
+
+  /*! Frames dropped for being too long, badly framed or failing the CRC. */
+  uint32_t errors;
+} tele_decoder_t;
+
+/**
+* @brief Calculate a CRC-16/CCITT-FALSE over a block of data.
+* @param [in] crc CRC of the preceding data, 0xFFFF for the first block.
+* @param [in] data Data to add to the CRC.
+* @param [in] length Number of bytes in data.
+* @return Updated CRC.
+*/
+uint16_t tele_crc16(uint16_t crc, const uint8_t *data, uint32_t length);
+
+/**
+* @brief Identify a parameter table by the name, type and unit of each
+*        parameter, so that a decoder can tell its metadata is out of date.
+* @param [in] params Parameter table.
+* @param [in] count Number of parameters.
+* @return Schema id.
+*/
+uint16_t tele_schema_id(const tele_command_t *params, uint32_t count);
+
+/**
+* @brief Build a frame holding the current value of every parameter.
+* @param [out] frame Frame to build.
+* @param [in] header Header of the frame, type is set to TELE_FRAME_VALUES.
+* @param [in] params Parameter table.
+* @param [in] count Number of parameters.
+* @return true on success, false if the values do not fit in a frame.
+*/
+bool tele_encode_values(tele_frame_t *frame, tele_header_t header,
+  const tele_command_t *params, uint32_t count);
+
+/**
+* @brief Build a frame describing one parameter.
+* @param [out] frame Frame to build.
+* @param [in] header Header of the frame, type is set to TELE_FRAME_META.
+* @param [in] index Position of the parameter in the table.
+* @param [in] param Parameter to describe.
+* @return true on success, false if the name does not fit in a frame.
+*/
+bool tele_encode_meta(tele_frame_t *frame, tele_header_t header,
+  uint32_t index, const tele_command_t *param);
+
+/**
+* @brief Clear a delta encoder, so that the next frame is a keyframe.
+* @param [out] delta Delta encoder to clear.
+* @param [in] keyframe_interval Frames between keyframes.
+*/
+void tele_delta_init(tele_delta_t *delta, uint32_t keyframe_interval);
+
+/**
+* @brief Build a frame holding each parameter that has moved past its
+*        deadband since it was last sent, or every parameter if a keyframe
+*        is due. The sent values are remembered by the delta encoder.
+* @param [out] frame Frame to build, either a TELE_FRAME_VALUES keyframe or
+*              a TELE_FRAME_DELTA frame.
+* @param [in] header Header of the frame, type is set by the encoder.
+* @param [in/out] delta Delta encoder.
+* @param [in] params Parameter table.
+* @param [in] count Number of parameters, at most TELE_DELTA_MAX_PARAMS.
+* @return Number of values in the frame, 0 if nothing has changed and the
+*         frame need not be sent, or -1 if the values do not fit in a frame.
+*/
+int tele_encode_delta(tele_frame_t *frame, tele_header_t header,
+  tele_delta_t *delta, const tele_command_t *params, uint32_t count);
+
+/**
+* @brief Count a frame built by tele_encode_delta() in the link statistics.
+* @param [in/out] delta Delta encoder.
+* @param [in] frame Frame that was built.
+* @param [in] length Encoded length of the frame, 0 if nothing had changed
+*             and it was not sent.
+* @param [in] count Number of parameters.
+*/
+void tele_delta_sent(tele_delta_t *delta, const tele_frame_t *frame,
+  uint32_t length, uint32_t count);
+
+/**
+* @brief Append the CRC to a frame and COBS encode it for sending.
+* @param [in] frame Frame built by one of the tele_encode_* functions.
+* @param [out] out Encoded frame, TELE_ENCODED_MAX_LEN long, ending in a
+*              zero delimiter.
+* @return Number of bytes in out.
+*/
+uint32_t tele_frame_encode(const tele_frame_t *frame, uint8_t *out);
+
+/**
+* @brief Clear a decoder, dropping any partially received frame.
+* @param [out] decoder Decoder to clear.
+*/
+void tele_decoder_init(tele_decoder_t *decoder);
+
+/**
+* @brief Add a received byte to a decoder.
+* @param [in/out] decoder Decoder the byte was received by.
+* @param [in] c Received byte.
+* @param [out] frame Decoded frame, without the CRC.
+* @return true if c completed a frame that passed the CRC check.
+*/
+bool tele_decode_byte(tele_decoder_t *decoder, uint8_t c, tele_frame_t *frame);
+
+/**
+* @brief Read the header of a decoded frame.
+* @param [in] frame Decoded frame.
+* @param [out] header Header of the frame.
+* @return true on success, false if the frame is too short.
+*/
+bool tele_decode_header(const tele_frame_t *frame, tele_header_t *header);
+
+/**
+* @brief Read the values from a decoded values frame.
+* @param [in] frame Decoded frame.
+* @param [in] types Type of each parameter, learnt from metadata frames.
+* @param [out] values Value of each parameter.
+* @param [in] count Number of parameters the decoder knows about.
+* @return Number of values read, or -1 if the frame is malformed or holds
+*         a different number of values.
+*/
+int tele_decode_values(const tele_frame_t *frame,
+  const tele_command_type_t *types, tele_value_t *values, uint32_t count);
+
+/**
+* @brief Apply a delta frame to the values from earlier frames.
+* @param [in] frame Decoded frame.
+* @param [in] types Type of each parameter, learnt from metadata frames.
+* @param [in/out] values Value of each parameter, only those in the frame
+*                 are changed.
+* @param [in] count Number of parameters the decoder knows about.
+* @return Number of values changed, or -1 if the frame is malformed or
+*         refers to an unknown parameter.
+*/
+int tele_decode_delta(const tele_frame_t *frame,
+  const tele_command_type_t *types, tele_value_t *values, uint32_t count);
+
+/**
+* @brief Read a metadata frame.
+* @param [in] frame Decoded frame.
+* @param [out] index Position of the parameter in the table.
+* @param [out] type Type of the parameter.
+* @param [out] unit Unit of the parameter.
+* @param [out] name NUL terminated name, TELE_NAME_MAX_LEN + 1 long.
+* @return true on success, false if the frame is malformed.
+*/
+bool tele_decode_meta(const tele_frame_t *frame, uint32_t *index,
+  tele_command_type_t *type, tele_command_unit_t *unit, char *name);
+
+#endif  // TC_TELE_CODEC_H
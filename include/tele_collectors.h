@@ -0,0 +1,44 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file tele_collectors.h
+ * @author Cameron A. Craig
+ * @date 9 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Functions that read each group of telemetry parameters.
+ */
+
+#ifndef TC_TELE_COLLECTORS_H
+#define TC_TELE_COLLECTORS_H
+
+#include "tele_param.h"
+
+/* Each function is a tele_collector_t for the group of the same name. */
+
+void tele_collect_drive_rpm(const void *targs);
+void tele_collect_weapon_rpm(const void *targs);
+#ifdef DEVICE_BNO055
+void tele_collect_imu(const void *targs);
+void tele_collect_temp(const void *targs);
+#endif
+void tele_collect_arm_status(const void *targs);
+void tele_collect_rx_age(const void *targs);
+void tele_collect_failsafe(const void *targs);
+void tele_collect_orientation(const void *targs);
+void tele_collect_cpu(const void *targs);
+
+#endif  // TC_TELE_COLLECTORS_H
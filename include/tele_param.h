@@ -26,11 +26,7 @@
 #define INCLUDE_TELE_PARAM_H_
 
 #include "stdint.h"
-
-/* TODO(camieac): I want to refactor the commands to make it easy to add new
-   ones. I'll probably add a function for each command that updates the
-   telemetry value. And a pointer to this function stored in tele_command_t.
-*/
+#include "config.h"
 
 /**
  * Supported types that can be passed as a value in a telemetry parameter.
@@ -66,6 +62,8 @@ typedef enum {
   CU_CELCIUS,
   CU_VOLTS,
   CU_DEGREES,
+  CU_MICROSECONDS,
+  CU_PERCENT,
   CU_NONE
 } tele_command_unit_t;
 
@@ -76,6 +74,8 @@ static const char* tele_command_unit_str[] = {
   "celcius",
   "V",
   "degrees",
+  "us",
+  "%",
   ""
 };
 
@@ -89,7 +89,7 @@ const char* tele_command_unit_to_string(tele_command_unit_t tcid);
  * Note: For ease of access, the command ID (CID) value should correspond with its
  * position within the tele_commands array (tele_params.h).
  */
-typedef enum tele_command_id_t {
+enum tele_command_id_t {
   CID_DRIVE_RPM_1 = 0,
   CID_DRIVE_RPM_2,
   CID_DRIVE_RPM_3,
@@ -104,6 +104,9 @@ typedef enum tele_command_id_t {
   CID_ROLL,
   CID_YAW,
   CID_AMBIENT_TEMP,
+  CID_HEADING_KP,
+  CID_HEADING_KI,
+  CID_HEADING_KD,
 #endif
   CID_WEAPON_VOLTAGE_1,
   CID_WEAPON_VOLTAGE_2,
@@ -112,8 +115,48 @@ typedef enum tele_command_id_t {
   CID_DRIVE_VOLTAGE_2,
   CID_DRIVE_VOLTAGE_3,
   CID_ARM_STATUS,
+  CID_WEAPON_RX_AGE,
+  CID_DRIVE_RX_AGE,
+  CID_FAILSAFE_LATENCY,
+  CID_INVERTED,
+  CID_FLIP_LATENCY,
+  CID_CPU_IDLE,
+  CID_CPU_MOTOR_DRIVE,
+  CID_MOTOR_DRIVE_WORST_RUN,
+  CID_DEADLINE_MISSES,
+
+  /*! Number of parameters, not a parameter. */
+  CID_NUM_PARAMS
 };
 
+/**
+ * Parameters that are read together, in one bus transaction where they come
+ * from a sensor. Each group is collected by one call to its collector.
+ */
+typedef enum {
+  TG_DRIVE_RPM = 0,
+  TG_WEAPON_RPM,
+  TG_IMU,
+  TG_TEMP,
+  TG_VOLTAGE,
+  TG_ARM_STATUS,
+  TG_RX_AGE,
+  TG_FAILSAFE,
+  TG_HEADING_LOCK,
+  TG_ORIENTATION,
+  TG_CPU,
+
+  /*! Number of groups, not a group. */
+  TG_NUM_GROUPS
+} tele_group_id_t;
+
+/**
+* @brief Read the current value of every parameter in a group and publish
+*        them through tele_store.h.
+* @param [in] targs Thread arguments.
+*/
+typedef void (*tele_collector_t)(const void *targs);
+
 /**
  * This info stores the name and value of a parameter to be sent to ESP8266.
  */
@@ -124,6 +167,20 @@ typedef struct {
   tele_command_unit_t unit;
   tele_command_type_t type;
 
+  /*! Change in value, in the parameter's unit, needed before it is streamed
+      again between keyframes. 0 streams every change. */
+  float deadband;
+
+  /*! Parameters with the same group are collected by one call to collect,
+      and must share the same collector and sample period. */
+  tele_group_id_t group;
+
+  /*! Time between collections (milliseconds). */
+  uint32_t period_ms;
+
+  /*! Reads the group, NULL if nothing is collected for it yet. */
+  tele_collector_t collect;
+
   /**
    * Allow one of many types to be used.
    */
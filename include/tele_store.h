@@ -0,0 +1,84 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file tele_store.h
+ * @author Cameron A. Craig
+ * @date 8 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Lock-free publication of telemetry values into tele_commands.
+ */
+
+#ifndef TC_TELE_STORE_H
+#define TC_TELE_STORE_H
+
+#include <stdint.h>
+#include "tele_params.h"
+
+/*
+  Every value is one aligned word, so a single store publishes it and a
+  single load reads it; no reader can see half a value. Writers bracket
+  their stores with tele_store_begin() and tele_store_end(), which count
+  started and finished writes. A reader that copies the table and sees no
+  write started since the last one finished has a consistent copy, even
+  with several writers, and writers never wait on readers.
+*/
+
+/**
+* @brief Start writing one or more values that readers should see together,
+*        e.g. the three axes of one accelerometer reading.
+*/
+void tele_store_begin(void);
+
+/**
+* @brief Finish writing values started by tele_store_begin().
+*/
+void tele_store_end(void);
+
+/**
+* @brief Publish a value, on its own or between tele_store_begin() and
+*        tele_store_end().
+* @param [in] id Parameter to publish.
+* @param [in] value New value.
+*/
+void tele_store_set_f(tele_command_id_t id, float value);
+void tele_store_set_i(tele_command_id_t id, int value);
+void tele_store_set_b(tele_command_id_t id, bool value);
+
+/**
+* @brief Read the latest value of one parameter.
+* @param [in] id Parameter to read.
+* @return Latest value.
+*/
+float tele_store_get_f(tele_command_id_t id);
+int tele_store_get_i(tele_command_id_t id);
+bool tele_store_get_b(tele_command_id_t id);
+
+/**
+* @return Number of writes finished so far, changes whenever any value
+*         does.
+*/
+uint32_t tele_store_version(void);
+
+/**
+* @brief Copy every parameter, retrying until no value was written during
+*        the copy.
+* @param [out] params Copy of tele_commands, NUM_TELE_COMMANDS long.
+* @return Version of the copy, as returned by tele_store_version().
+*/
+uint32_t tele_store_snapshot(tele_command_t *params);
+
+#endif  // TC_TELE_STORE_H
@@ -29,14 +29,23 @@
 #include "rtos.h"
 #include "types.h"
 #include "config.h"
-#include "PwmIn.h"
 #include "states.h"
 #include "bno055.h"
+#include "heading_lock.h"
+#include "blackbox.h"
 #include "command.h"
 #include "task.h"
 #include "drive_mode.h"
 #include "comms.h"
 #include "watchdog.h"
+#include "loop_stats.h"
+#include "snapshot.h"
+#include "rc_capture.h"
+#include "receiver.h"
+#include "rc_input.h"
+#include "console.h"
+#include "tele_codec.h"
+#include "i2c_engine.h"
 
 /**
  * Shared variables between tasks, made availbale through the first and only
@@ -47,7 +56,8 @@ typedef struct {
   task_t *tasks;
   Thread *threads;
 
-  state_t state;
+  /*! Arm state, also lowered from the failsafe interrupt. */
+  volatile state_t state;
 
   /*! Drive mode in use. */
   drive_mode_t *drive_mode;
@@ -58,11 +68,28 @@ typedef struct {
   /*! Wrapper to allow selection of ESC comms method */
   comms_impl_t *comms_impl;
 
-  /*! Channel values for multiple controllers. */
-  rc_controls_t controls[RC_NUMBER_CONTROLLERS];
+  /*! Channel values for multiple controllers, published by the motor drive
+      task once per loop cycle. */
+  Snapshot<rc_frame_t> controls;
 
-  /*! Receiver inputs. */
-  rc_receiver_t receiver[RC_NUMBER_CONTROLLERS];
+  /*! Receiver inputs.
+      TODO: Currently limited to use two receivers with same number of
+      channels, remove this restriction. */
+  rc_capture_t receiver[RC_NUMBER_CONTROLLERS];
+
+  /*! Type of receiver used by each controller. */
+  receiver_impl_t *receiver_impl[RC_NUMBER_CONTROLLERS];
+
+  /*! Glitch rejection and smoothing of receiver inputs, owned by the motor
+      drive task. */
+  input_filter_t input_filter;
+
+  /*! Pulse widths read by the motor drive task in its last cycle, before
+      filtering. Channels without a new pulse keep their last width. */
+  rc_raw_frame_t raw_pulses;
+
+  /*! Flight recorder of the motor drive loop. */
+  blackbox_t blackbox;
 
   /*! Defines the upper and lower limits of each PWM input from a receiver. */
   channel_limits_t channel_limits[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS];
@@ -70,33 +97,69 @@ typedef struct {
   /*! Mail queue for commands from serial comms or RF RX */
   Mail<command_t, COMMAND_QUEUE_LEN> *command_queue;
 
+  /*! Depth of the command queue and latency of queued commands. */
+  command_stats_t command_stats;
+
   /*! USB serial port */
-  Serial *serial;
+  RawSerial *serial;
+
+  /*! Command lines typed on the USB serial port. */
+  console_t console;
 
   /*! Serial connection to ESP8266 */
   Serial *esp_serial;
   DigitalIn *esp_ready_pin;
 
-  /*! Stores telemetry values */
-  /* TODO(camieac): Telemetry parameters should only be accessible
-      through thread_args_t. */
+  /*! Set to have the stream telemetry task resend parameter metadata. */
+  volatile bool telemetry_meta_requested;
 
-  struct rc_outputs_t outputs;
+  /*! Last streamed value of each telemetry parameter and link byte counts,
+      owned by the stream telemetry task. */
+  tele_delta_t telemetry_delta;
+
+  /*! Latest ESC outputs, published by the motor drive task. */
+  Snapshot<struct rc_outputs_t> outputs;
 
   struct direction_vector_t direction;
 
+  /*! Period jitter and execution time of the motor drive loop. */
+  loop_stats_t motor_loop;
+
   /**
    * Drive and weapon ESCS.
    */
   struct {
-    comms_esc_t drive[3];
+    comms_esc_t drive[NUM_DRIVE_ESCS];
     comms_esc_t weapon[3];
   } escs;
 
-  orientation_t orientation_detected;
-  orientation_t orientation_override;
+  /*! Sensor I2C bus, shared by every device on it. */
+  i2c_engine_t i2c;
+
+  /*! How the BNO055 is set up, and how often the orientation task finds
+      new data when it reads it. */
+  bno055_config_t imu_config;
+  bno055_stats_t imu_stats;
+
+  /*! Latest new sample read by the orientation task. Telemetry is taken
+      from it, so nothing else reads the sensor. */
+  Snapshot<bno055_sample_t> imu_sample;
+
+  /*! Orientation found by the orientation task, and one set by the user
+      that takes its place unless it is ORIENTATION_AUTO. */
+  volatile orientation_t orientation_detected;
+  volatile orientation_t orientation_override;
   euler_t orientation;
-  bool inverted;
+
+  /*! Set while the motor drive task is remapping the controls for a robot
+      that is upside down. */
+  volatile bool inverted;
+
+  /*! Time the detected or overridden orientation last changed, and how long
+      the motor drive task then took to start driving with it
+      (microseconds). */
+  volatile uint32_t orientation_changed_us;
+  volatile uint32_t flip_latency_us;
   bool active;
 
   /**
@@ -107,18 +170,6 @@ typedef struct {
      * Mutual exclusion of serial port.
      */
     Mutex *pc_serial;
-    /**
-     * Protects accesses to controller values.
-     */
-    Mutex *controls;
-    /**
-     * Protects access to ESC outputs.
-     */
-    Mutex *outputs;
-    /**
-     * Protects accesses to telemetry parameters.
-    */
-    Mutex *telemetry;
   } mutex;
 
 
@@ -130,6 +181,19 @@ typedef struct {
   int heading_lock_speed; // percentage
   int heading_lock_deadband; // degrees / 2
 
+  /*! Heading controller, run by the orientation task at the sensor data
+      rate. */
+  heading_pid_t heading_pid;
+  loop_stats_t heading_loop;
+
+  /*! Rotation command from the heading controller, mixed by the motor drive
+      task while the driver is not rotating. */
+  volatile control_t heading_rotation;
+
+  /*! Set by the motor drive task while the driver is rotating, the heading
+      is locked again once they stop. */
+  volatile bool heading_lock_turning;
+
   Watchdog *wdt;
 
 } thread_args_t;
@@ -27,6 +27,16 @@
 
 #define BETWEEN(value, min, max) (value < max && value > min)
 
+#define MAX(a, b) \
+  ({ typeof (a) _a = (a); \
+     typeof (b) _b = (b); \
+   _a > _b ? _a : _b; })
+
+#define MIN(a, b) \
+  ({ typeof (a) _a = (a); \
+      typeof (b) _b = (b); \
+    _a < _b ? _a : _b; })
+
 /**
 * @brief Weird mapping function written by Euan.
 */
@@ -20,6 +20,8 @@
  * @date 9 Sep 2017
  * @copyright 2017 Cameron A. Craig
  * @brief Defines various structs, used throughout the project.
+ *        Nothing here depends on mbed, so the control maths that uses these
+ *        types can be built and timed off target.
  *
  * -- RULE_3_2_F_use_representitive_classname_for_cpp_filename
  */
@@ -27,41 +29,55 @@
 #ifndef TC_TYPES_H
 #define TC_TYPES_H
 
-#include "PwmIn.h"
 #include "config.h"
+#include "fixed.h"
+
+/**
+ * Number type used by the control path. Use CONTROL() to write constants.
+ */
+#ifdef CONTROL_FIXED_POINT
+typedef q16_t control_t;
+#define CONTROL(x) Q16(x)
+#else
+typedef float control_t;
+#define CONTROL(x) (x)
+#endif
+
+/**
+ * Value of a controller channel, between 0 and 100. Use RC_CHANNEL() to
+ * write constants that are compared against channel values.
+ */
+typedef control_t rc_channel_t;
+#define RC_CHANNEL(x) CONTROL(x)
 
 /**
  * Positions of controls
  */
 typedef struct {
-    float channel[RC_NUMBER_CHANNELS];
+    rc_channel_t channel[RC_NUMBER_CHANNELS];
 } rc_controls_t;
 
 /**
- * Stores all channels of a receiver.
- * TODO: Currently limited to use two receivers with same number of channels,
- * remove this restriction.
+ * Positions of controls on every controller, read in the same loop cycle.
  */
 typedef struct {
-  PwmIn *channel[RC_NUMBER_CHANNELS];
-} rc_receiver_t;
+    rc_controls_t controller[RC_NUMBER_CONTROLLERS];
+} rc_frame_t;
 
 /**
- * Current movement command
+ * Current movement command, each component between -1 and 1.
  */
 struct direction_vector_t {
-    float rotation;
-    float x_translation;
-    float y_translation;
+    control_t rotation;
+    control_t x_translation;
+    control_t y_translation;
 };
 
 /**
  * Outputs for devices
  */
 struct rc_outputs_t {
-    int wheel_1;
-    int wheel_2;
-    int wheel_3;
+    int wheel[MAX_DRIVE_WHEELS];
     int weapon_motor_1;
     int weapon_motor_2;
     int weapon_motor_3;
@@ -119,10 +135,13 @@ struct distance_sensor_t {
 /**
  * Supported orientations, unfortunately we can only operate upright or
  * inverted, anything in between is not yet supported :)
+ * ORIENTATION_AUTO is only used as an override, to follow the detected
+ * orientation.
  */
 enum orientation_t {
   UPRIGHT = 0,
-  INVERTED
+  INVERTED,
+  ORIENTATION_AUTO
 };
 
 /**
@@ -15,7 +15,7 @@
 #include "mbed.h"
 #include <stdarg.h>
 
-extern Serial *serial_ptr;
+extern RawSerial *serial_ptr;
 
 //Legacy function, TODO: remove
 #define LOG( args...) \
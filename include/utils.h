@@ -28,16 +28,7 @@
 
 #include "thread_args.h"
 #include "config.h"
-
-#define MAX(a, b) \
-  ({ typeof (a) _a = (a); \
-     typeof (b) _b = (b); \
-   _a > _b ? _a : _b; })
-
-#define MIN(a, b) \
-  ({ typeof (a) _a = (a); \
-      typeof (b) _b = (b); \
-    _a < _b ? _a : _b; })
+#include "tmath.h"
 
 /**
 * @brief Check if drive reciever is stalled.
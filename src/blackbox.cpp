@@ -0,0 +1,87 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * @file blackbox.cpp
+ * @author Cameron A. Craig
+ * @date 18 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Flight recorder, keeps what the control loop saw and commanded in
+ *        the last few seconds in a ring of compact binary records.
+ */
+
+#include <string.h>
+#include "blackbox.h"
+
+/* The linker script places these sections in the two AHB SRAM banks, which
+   are not cleared at startup. */
+static blackbox_record_t bank0[BLACKBOX_BANK_RECORDS] __attribute__((section("AHBSRAM0"), aligned(4)));
+static blackbox_record_t bank1[BLACKBOX_BANK_RECORDS] __attribute__((section("AHBSRAM1"), aligned(4)));
+
+static inline blackbox_record_t * slot(uint32_t index) {
+  return (index < BLACKBOX_BANK_RECORDS) ? &bank0[index] : &bank1[index - BLACKBOX_BANK_RECORDS];
+}
+
+void blackbox_init(blackbox_t *blackbox) {
+  blackbox->written = 0;
+  blackbox->paused = false;
+  memset(&blackbox->cost, 0x00, sizeof(timing_histogram_t));
+  blackbox->cost.min_us = 0xFFFFFFFF;
+}
+
+void blackbox_record(blackbox_t *blackbox, uint32_t time_us, const rc_raw_frame_t *raw,
+                     const rc_frame_t *frame, const struct rc_outputs_t *outputs, int state,
+                     const euler_t *orientation, uint8_t flags) {
+  blackbox_record_t *record;
+  int controller, wheel;
+
+  if (blackbox->paused) {
+    return;
+  }
+  record = slot(blackbox->written % BLACKBOX_RECORDS);
+
+  record->time_us = time_us;
+  memcpy(record->width_us, raw->width_us, sizeof(record->width_us));
+  record->fresh = 0;
+  for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
+    record->fresh |= (raw->fresh[controller] & ((1U << RC_NUMBER_CHANNELS) - 1))
+                     << (controller * RC_NUMBER_CHANNELS);
+  }
+  memcpy(record->controls, frame->controller, sizeof(record->controls));
+  record->orientation = *orientation;
+  for (wheel = 0; wheel < MAX_DRIVE_WHEELS; wheel++) {
+    record->wheel[wheel] = (uint8_t) outputs->wheel[wheel];
+  }
+  record->weapon[0] = (uint8_t) outputs->weapon_motor_1;
+  record->weapon[1] = (uint8_t) outputs->weapon_motor_2;
+  record->weapon[2] = (uint8_t) outputs->weapon_motor_3;
+  record->state = (uint8_t) state;
+  record->flags = flags;
+
+  blackbox->written++;
+}
+
+uint32_t blackbox_count(const blackbox_t *blackbox) {
+  return (blackbox->written < BLACKBOX_RECORDS) ? blackbox->written : BLACKBOX_RECORDS;
+}
+
+const blackbox_record_t * blackbox_get(const blackbox_t *blackbox, uint32_t index) {
+  uint32_t count = blackbox_count(blackbox);
+
+  if (index >= count) {
+    return NULL;
+  }
+  return slot((blackbox->written - count + index) % BLACKBOX_RECORDS);
+}
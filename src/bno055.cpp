@@ -25,10 +25,13 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 #include "mbed.h"
 #include "bno055.h"
+#include "return_codes.h"
+#include "tmath.h"
 
-I2C i2c(p9, p10);
+static i2c_engine_t *i2c;
 
 /**
  * Function to write to a single 8-bit register
@@ -36,19 +39,31 @@ I2C i2c(p9, p10);
 void bno055_write_reg(int regAddr, char value)
 {
     char wbuf[2];
+    i2c_transaction_t t = {0};
+
     wbuf[0] = regAddr;
     wbuf[1] = value;
-    i2c.write(bno055_addr, wbuf, 2, false);
+    t.address = bno055_addr;
+    t.tx = wbuf;
+    t.tx_len = 2;
+    i2c_transfer(i2c, &t);
 }
 
 /**
  * Function to read from a single 8-bit register
  */
 char bno055_read_reg(int regAddr) {
-    char rwbuf = regAddr;
-    i2c.write(bno055_addr, &rwbuf, 1, false);
-    i2c.read(bno055_addr, &rwbuf, 1, false);
-    return rwbuf;
+    char reg = regAddr;
+    char value = 0;
+    i2c_transaction_t t = {0};
+
+    t.address = bno055_addr;
+    t.tx = &reg;
+    t.tx_len = 1;
+    t.rx = &value;
+    t.rx_len = 1;
+    i2c_transfer(i2c, &t);
+    return value;
 }
 
 /**
@@ -71,26 +86,88 @@ calib_status_t bno055_read_calibration_status() {
  * Checks that there are no errors on the accelerometer
  */
 bool bno055_healthy() {
-    int sys_error = bno055_read_reg(BNO055_SYS_ERR_ADDR);
-    wait(0.001);
-    int sys_stat = bno055_read_reg(BNO055_SYS_STAT_ADDR);
-    wait(0.001);
-
-    if(sys_error == 0 && sys_stat == 5)
-        return true;
-    else
+    // SYS_STAT and SYS_ERR are adjacent, read both in one transaction.
+    char reg = BNO055_SYS_STAT_ADDR;
+    char buf[2];
+    i2c_transaction_t t = {0};
+
+    t.address = bno055_addr;
+    t.tx = &reg;
+    t.tx_len = 1;
+    t.rx = buf;
+    t.rx_len = 2;
+    if (i2c_transfer(i2c, &t) != I2C_DONE) {
         return false;
+    }
+
+    // Status 5 is fusion algorithm running, 6 is running without fusion.
+    return (buf[0] == 5 || buf[0] == 6) && buf[1] == 0;
 }
 
 
+/* Accelerometer bandwidths selectable in ACC_Config (Hz), the output data
+   rate is twice the bandwidth. */
+static const float acc_bandwidths[] = {7.81f, 15.63f, 31.25f, 62.5f, 125.0f, 250.0f, 500.0f, 1000.0f};
+
+/* Gyroscope output data rates for each bandwidth setting in GYR_Config_0
+   (Hz), in register order. */
+static const uint32_t gyr_rates[] = {2000, 1000, 1000, 400, 200, 100, 200, 100};
+
+/* Bits 2-4 of ACC_Config, leaving the default 4G range and normal mode. */
+static char bno055_acc_config(uint32_t rate_hz) {
+    unsigned i;
+
+    for (i = 0; i < sizeof(acc_bandwidths) / sizeof(acc_bandwidths[0]) - 1; i++) {
+        if (acc_bandwidths[i] * 2.0f >= rate_hz) {
+            break;
+        }
+    }
+    return (char) ((i << 2) | 0x01);
+}
+
+/* Bits 3-5 of GYR_Config_0, leaving the default 2000 dps range. Picks the
+   lowest rate that is fast enough, to keep the most filtering. */
+static char bno055_gyr_config(uint32_t rate_hz) {
+    unsigned i, best = 0;
+
+    for (i = 0; i < sizeof(gyr_rates) / sizeof(gyr_rates[0]); i++) {
+        if (gyr_rates[i] >= rate_hz && gyr_rates[i] < gyr_rates[best]) {
+            best = i;
+        }
+    }
+    return (char) (best << 3);
+}
+
+uint32_t bno055_data_rate_hz(const bno055_config_t *config) {
+    unsigned i;
+
+    if (config->mode != BNO055_MODE_ACCGYRO) {
+        return BNO055_FUSION_RATE_HZ;
+    }
+    // New data arrives at the slower of the two sensors' rates.
+    i = (bno055_acc_config(config->raw_rate_hz) >> 2) & 0x07;
+    return MIN((uint32_t) (acc_bandwidths[i] * 2.0f),
+        gyr_rates[(bno055_gyr_config(config->raw_rate_hz) >> 3) & 0x07]);
+}
+
+bool bno055_fusion_mode(const bno055_config_t *config) {
+    return config->mode != BNO055_MODE_CONFIG && config->mode != BNO055_MODE_ACCGYRO;
+}
+
+void bno055_clear_interrupt() {
+    bno055_write_reg(BNO055_SYS_TRIGGER_ADDR,
+        BNO055_SYS_TRIGGER_CLK_SEL | BNO055_SYS_TRIGGER_RST_INT);
+}
+
 /**
  * Configure and initialize the BNO055
  */
-bool bno055_init() {
+bool bno055_init(i2c_engine_t *engine, const bno055_config_t *config) {
     unsigned char regVal;
-    i2c.frequency(400000);
     bool startupPass = true;
 
+    i2c = engine;
+
     // Do some basic power-up tests
     regVal = bno055_read_reg(BNO055_ID_ADDR);
     if (regVal != 0xA0) {
@@ -114,11 +191,21 @@ bool bno055_init() {
     wait(0.1);
 
     // Set to external crystal
-    bno055_write_reg(BNO055_SYS_TRIGGER_ADDR, 0x80);
+    bno055_write_reg(BNO055_SYS_TRIGGER_ADDR, BNO055_SYS_TRIGGER_CLK_SEL);
     wait(0.2);
 
-    // Change mode to NDOF
-    bno055_write_reg(BNO055_OPR_MODE_ADDR, 0x0C);
+    // Sensor bandwidths and interrupts are on page 1, and can only be
+    // changed in CONFIG mode.
+    bno055_write_reg(BNO055_PAGE_ID_ADDR, 1);
+    if (config->mode == BNO055_MODE_ACCGYRO) {
+        bno055_write_reg(BNO055_ACC_CONFIG_ADDR, bno055_acc_config(config->raw_rate_hz));
+        bno055_write_reg(BNO055_GYR_CONFIG_0_ADDR, bno055_gyr_config(config->raw_rate_hz));
+    }
+    bno055_write_reg(BNO055_INT_MSK_ADDR, config->data_ready_int ? BNO055_INT_ACC_BSX_DRDY : 0);
+    bno055_write_reg(BNO055_INT_EN_ADDR, config->data_ready_int ? BNO055_INT_ACC_BSX_DRDY : 0);
+    bno055_write_reg(BNO055_PAGE_ID_ADDR, 0);
+
+    bno055_write_reg(BNO055_OPR_MODE_ADDR, config->mode);
     wait(0.2);
 
     regVal = bno055_read_reg(BNO055_OPR_MODE_ADDR);
@@ -127,49 +214,44 @@ bool bno055_init() {
     return startupPass;
 }
 
+static void bno055_prepare_sample(bno055_read_t *read) {
+    read->reg = BNO055_DATA_START_ADDR;
+    memset(&read->transaction, 0x00, sizeof(i2c_transaction_t));
+    read->transaction.address = bno055_addr;
+    read->transaction.tx = &read->reg;
+    read->transaction.tx_len = 1;
+    read->transaction.rx = read->data;
+    read->transaction.rx_len = BNO055_DATA_LEN;
+}
+
 /**
- * Reads the Euler angles, zeroed out
+ * Queues a burst read of every measurement
  */
-euler_t bno055_read_euler_angles() {
-    char buf[16];
-    euler_t e;
-
-    // Read in the Euler angles
-    buf[0] = BNO055_EULER_H_LSB_ADDR;
-    i2c.write(bno055_addr, buf, 1, false);
-    i2c.read(bno055_addr, buf, 6, false);
-
-    uint16_t euler_head = buf[0] + (buf[1] << 8);
-    uint16_t euler_roll = buf[2] + (buf[3] << 8);
-    uint16_t euler_pitch = buf[4] + (buf[5] << 8);
-
-    e.heading = ((float) euler_head) / 16.0;
-    e.roll = ((float) euler_roll) / 16.0;
-    e.pitch = ((float) euler_pitch) / 16.0;
-
-    return e;
+int bno055_request_sample(bno055_read_t *read, Thread *notify, int32_t signal) {
+    bno055_prepare_sample(read);
+    read->transaction.notify = notify;
+    read->transaction.signal = signal;
+    return i2c_submit(i2c, &read->transaction);
 }
 
-euler_t bno055_read_accel() {
-    char buf[16];
-    euler_t e;
-
-    // Read in the Euler angles
-    buf[0] = BNO055_ACCEL_DATA_X_LSB_ADDR;
-    i2c.write(bno055_addr, buf, 1, false);
-    i2c.read(bno055_addr, buf, 6, false);
-
-    uint16_t x = buf[0] + (buf[1] << 8);
-    uint16_t y = buf[2] + (buf[3] << 8);
-    uint16_t z = buf[4] + (buf[5] << 8);
-
-    e.x = ((float) x) / 100.0;
-    e.y = ((float) y) / 100.0;
-    e.z = ((float) z) / 100.0;
-
-    return e;
+/**
+ * Decodes a finished burst read
+ */
+bool bno055_sample_result(const bno055_read_t *read, bno055_sample_t *sample) {
+    if (read->transaction.result != I2C_DONE) {
+        return false;
+    }
+    bno055_decode_sample((const uint8_t *) read->data, sample);
+    return true;
 }
 
-uint8_t bno055_read_temp() {
-  return (uint8_t) bno055_read_reg(BNO055_TEMP_ADDR);
+/**
+ * Reads every measurement in one burst of the data registers
+ */
+bool bno055_read_sample(bno055_sample_t *sample) {
+    bno055_read_t read;
+
+    bno055_prepare_sample(&read);
+    i2c_transfer(i2c, &read.transaction);
+    return bno055_sample_result(&read, sample);
 }
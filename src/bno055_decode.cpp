@@ -0,0 +1,59 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file bno055_decode.cpp
+ * @author Cameron A. Craig
+ * @date 10 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Decodes the BNO055 data registers.
+ */
+
+#include "bno055_decode.h"
+
+/* Every measurement is a little endian two's complement 16 bit value. */
+static int16_t read_s16(const uint8_t *data) {
+  return (int16_t) (data[0] | (data[1] << 8));
+}
+
+static void decode_vector(const uint8_t *data, float lsb, euler_t *v) {
+  v->x = read_s16(&data[0]) / lsb;
+  v->y = read_s16(&data[2]) / lsb;
+  v->z = read_s16(&data[4]) / lsb;
+}
+
+void bno055_decode_sample(const uint8_t *data, bno055_sample_t *sample) {
+  const uint8_t *q = &data[BNO055_DATA_QUATERNION];
+  const uint8_t *e = &data[BNO055_DATA_EULER];
+
+  decode_vector(&data[BNO055_DATA_ACCEL], BNO055_ACCEL_LSB_PER_MPSPS, &sample->accel);
+  decode_vector(&data[BNO055_DATA_MAG], BNO055_MAG_LSB_PER_UT, &sample->mag);
+  decode_vector(&data[BNO055_DATA_GYRO], BNO055_GYRO_LSB_PER_DPS, &sample->gyro);
+  decode_vector(&data[BNO055_DATA_LINEAR_ACCEL], BNO055_ACCEL_LSB_PER_MPSPS, &sample->linear_accel);
+  decode_vector(&data[BNO055_DATA_GRAVITY], BNO055_ACCEL_LSB_PER_MPSPS, &sample->gravity);
+
+  // Euler angles are stored heading, roll, pitch.
+  sample->euler.heading = read_s16(&e[0]) / BNO055_EULER_LSB_PER_DEGREE;
+  sample->euler.roll = read_s16(&e[2]) / BNO055_EULER_LSB_PER_DEGREE;
+  sample->euler.pitch = read_s16(&e[4]) / BNO055_EULER_LSB_PER_DEGREE;
+
+  sample->quaternion.w = read_s16(&q[0]) / BNO055_QUATERNION_LSB;
+  sample->quaternion.x = read_s16(&q[2]) / BNO055_QUATERNION_LSB;
+  sample->quaternion.y = read_s16(&q[4]) / BNO055_QUATERNION_LSB;
+  sample->quaternion.z = read_s16(&q[6]) / BNO055_QUATERNION_LSB;
+
+  sample->temp = (int8_t) data[BNO055_DATA_TEMP];
+}
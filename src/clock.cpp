@@ -0,0 +1,54 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file clock.cpp
+ * @author Cameron A. Craig
+ * @date 17 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Monotonic 64 bit microsecond time base.
+ */
+
+#include "mbed.h"
+#include "clock.h"
+
+static uint32_t clock_last_us;
+static uint32_t clock_wraps;
+
+uint64_t clock_now_us(void) {
+  uint32_t now, wraps;
+
+  core_util_critical_section_enter();
+  now = us_ticker_read();
+  if (now < clock_last_us) {
+    clock_wraps++;
+  }
+  clock_last_us = now;
+  wraps = clock_wraps;
+  core_util_critical_section_exit();
+
+  return ((uint64_t) wraps << 32) | now;
+}
+
+uint64_t clock_read_stamp(const volatile uint64_t *stamp) {
+  uint64_t value;
+
+  // The M3 reads 64 bits as two words, an interrupt could update it between
+  core_util_critical_section_enter();
+  value = *stamp;
+  core_util_critical_section_exit();
+  return value;
+}
@@ -0,0 +1,186 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file command_parser.cpp
+ * @author Cameron A. Craig
+ * @date 14 Feb 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Parses command strings into command_t structures.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "command_parser.h"
+#include "return_codes.h"
+#include "tele_params.h"
+
+static name_index_t command_index;
+static name_index_t tele_param_index;
+
+static const char *command_name(uint32_t i) {
+  return available_commands[i].name;
+}
+
+static const char *tele_param_name(uint32_t i) {
+  return tele_commands[i].name;
+}
+
+/* FNV-1a, seeded so that a seed can be searched for that puts every name
+   in its own slot. */
+static uint32_t name_hash(uint32_t seed, const char *text, uint32_t length) {
+  uint32_t hash = 2166136261u ^ seed;
+  uint32_t i;
+
+  for (i = 0; i < length; i++) {
+    hash ^= (uint8_t) text[i];
+    hash *= 16777619u;
+  }
+  return (hash ^ (hash >> 16)) & (NAME_INDEX_SLOTS - 1);
+}
+
+static int name_index_build(name_index_t *index,
+  const char *(*name)(uint32_t), uint32_t count) {
+  uint32_t seed, i, slot;
+  const char *text;
+
+  if (count >= NAME_INDEX_EMPTY) {
+    return RET_ERROR;
+  }
+  for (seed = 0; seed < NAME_INDEX_MAX_SEEDS; seed++) {
+    memset(index->slot, NAME_INDEX_EMPTY, sizeof(index->slot));
+    for (i = 0; i < count; i++) {
+      text = name(i);
+      slot = name_hash(seed, text, strlen(text));
+      if (index->slot[slot] != NAME_INDEX_EMPTY) {
+        break;
+      }
+      index->slot[slot] = (uint8_t) i;
+    }
+    if (i == count) {
+      index->seed = seed;
+      return RET_OK;
+    }
+  }
+  return RET_ERROR;
+}
+
+static int name_index_find(const name_index_t *index,
+  const char *(*name)(uint32_t), const command_token_t *token) {
+  uint8_t i = index->slot[name_hash(index->seed, token->text, token->length)];
+  const char *text;
+
+  if (i == NAME_INDEX_EMPTY) {
+    return -1;
+  }
+  // The slot may belong to a different name with the same hash.
+  text = name(i);
+  if (strncmp(text, token->text, token->length) != 0 || text[token->length] != '\0') {
+    return -1;
+  }
+  return i;
+}
+
+int command_parser_init(void) {
+  if (name_index_build(&command_index, command_name, NUM_COMMANDS) != RET_OK ||
+      name_index_build(&tele_param_index, tele_param_name, NUM_TELE_COMMANDS) != RET_OK) {
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
+
+const char * command_get_str(command_id_t id) {
+  if (id < NUM_COMMANDS)
+    return available_commands[id].name;
+  else
+    return "INVALID COMMAND";
+}
+
+bool command_next_token(const char **cursor, command_token_t *token) {
+  const char *c = *cursor;
+
+  while (*c == ' ') {
+    c++;
+  }
+  token->text = c;
+  while (*c != ' ' && *c != '\0') {
+    c++;
+  }
+  token->length = (uint32_t) (c - token->text);
+  *cursor = c;
+  return token->length > 0;
+}
+
+int command_find(const command_token_t *token) {
+  return name_index_find(&command_index, command_name, token);
+}
+
+int tele_param_find(const command_token_t *token) {
+  return name_index_find(&tele_param_index, tele_param_name, token);
+}
+
+int command_generate(command_t *command, const char *buffer) {
+  const char *cursor = buffer;
+  command_token_t token;
+  char *end;
+  int i;
+
+  memset(command, 0x00, sizeof(command_t));
+
+  if (!command_next_token(&cursor, &token) || (i = command_find(&token)) < 0) {
+    return RET_ERROR;
+  }
+  command->id = available_commands[i].id;
+  command->name = available_commands[i].name;
+
+  if (command->id == GET_PARAM || command->id == SET_PARAM) {
+    if (!command_next_token(&cursor, &token) || (i = tele_param_find(&token)) < 0) {
+      printf("Unknown parameter\r\n");
+      return RET_ERROR;
+    }
+    command->tele_param = &tele_commands[i];
+  }
+
+  if (command->id == SET_PARAM) {
+    if (!command_next_token(&cursor, &token)) {
+      printf("Missing value\r\n");
+      return RET_ERROR;
+    }
+    // The value is followed by a space or the end of the string, either of
+    // which stops the conversion, so it can be converted in place.
+    switch (command->tele_param->type) {
+      case CT_INT:
+        command->value.i = strtol(token.text, &end, 10);
+        break;
+      case CT_FLOAT:
+        command->value.f = strtod(token.text, &end);
+        break;
+      case CT_BOOLEAN:
+        command->value.b = (strtol(token.text, &end, 10) == 1);
+        break;
+      case CT_STRING:
+      default:
+        printf("unsupported param\r\n");
+        return RET_ERROR;
+    }
+    if (end != token.text + token.length) {
+      printf("Conversion error\r\n");
+      return RET_ERROR;
+    }
+  }
+  return RET_OK;
+}
@@ -33,110 +33,11 @@
 #include "types.h"
 #include "tele_params.h"
 #include "tasks.h"
-
-const char * command_get_str(command_id_t id) {
-  if (id > 0 && id < NUM_COMMANDS)
-    return available_commands[id].name;
-  else
-    return "INVALID COMMAND";
-}
-
-int command_generate(command_t *command, char *buffer) {
-  // Get the size of the entire command string
-  size_t command_len = strlen(buffer);
-  char command_str[command_len];
-  memcpy(command_str, buffer, command_len);
-
-  // Seperate commands into parts
-  char param_part[2][10];
-  char command_part[10];
-
-  char * pch;
-  int part = 0;
-  pch = strtok (command_str," ");
-  while (pch != NULL){
-    if(part == 0){
-      strncpy(command_part, pch, strlen(pch));
-    } else {
-      strncpy(param_part[part-1], pch, strlen(pch));
-    }
-    pch = strtok (NULL, " ");
-    part++;
-  }
-
-  // Find a matching command for the given command string
-  int i;
-  for (i = 0; i < NUM_COMMANDS; i++) {
-    size_t cplen = strlen(command_part);
-    char *command_compare;
-    command_compare = (char *) command_get_str(available_commands[i].id);
-    size_t cclen = strlen(command_compare);
-
-    if (strncmp(command_compare, command_part, MIN(cclen, cplen)) == 0) {
-      // When a matching command is found, populate the command
-      command->id = available_commands[i].id;
-      command->name = available_commands[i].name;
-
-      if (command->id == GET_PARAM || command->id == SET_PARAM) {
-        int k;
-        for (k = 0; k < NUM_TELE_COMMANDS; k++) {
-          printf("Checking %s\r\n", tele_commands[k].name);
-          if (strncmp(param_part[0],
-            tele_commands[k].name,
-            MIN(strlen(param_part[0]), strlen(tele_commands[k].name))) == 0) {
-            command->tele_param = &tele_commands[k];
-            printf("%s %s\r\n", command_get_str(command->id), tele_commands[k].name);
-            break;
-          }
-        }
-      }
-
-      if (command->id == SET_PARAM) {
-        char *end;
-        switch (command->tele_param->type) {
-            case CT_INT:
-              command->value.i = strtol(param_part[1], &end, 10);
-              if (end == param_part[1]) {
-                printf("Conversion error\r\n");
-                return RET_ERROR;
-              }
-              printf("d: %d\r\n", command->value.i);
-              break;
-            case CT_FLOAT:
-              command->value.f = strtod(param_part[1], &end);
-              if (end == param_part[1]) {
-                printf("Conversion error\r\n");
-                return RET_ERROR;
-              }
-              printf("f: %f\r\n", command->value.f);
-              break;
-            case CT_BOOLEAN:
-              command->value.b = (strtod(param_part[1], &end) == 1);
-              if (param_part[1] == end) {
-                return RET_ERROR;
-              }
-              return RET_OK;
-            case CT_STRING:
-            default:
-              printf("unsupported param\r\n");
-              return RET_ERROR;
-        }
-      }
-
-      // Set command parameters for parameterised commands
-      // int i;
-      // for(i = 0; i < part; i++){
-      //   memcpy(command->param[i], param_part[i], strlen(param_part[i]));
-      // }
-
-      // return true if matching command is found
-      return RET_OK;
-    }
-  }
-
-  // Return false (0) if no match is found
-  return RET_ERROR;
-}
+#include "clock.h"
+#include "tele_codec.h"
+#include "tele_store.h"
+#include "replay.h"
+#include "cpu_monitor.h"
 
 int command_execute(command_t *command, thread_args_t *targs) {
   switch (command->id) {
@@ -158,11 +59,55 @@ int command_execute(command_t *command, thread_args_t *targs) {
     case CALIBRATE_CHANNELS:
       return command_calibrate_channels(command, targs);
 #endif  // TASK_CALIBRATE_CHANNELS
+    case LOOP_TIMING:
+      return command_loop_timing(command, targs);
+    case FILTER_STATS:
+      return command_filter_stats(command, targs);
+    case QUEUE_STATS:
+      return command_queue_stats(command, targs);
+    case TELEMETRY_META:
+      return command_telemetry_meta(command, targs);
+    case TELEMETRY_LINK_STATS:
+      return command_telemetry_link_stats(command, targs);
+    case HEADING_LOCK:
+      return command_heading_lock(command, targs);
+    case HEADING_STATUS:
+      return command_heading_status(command, targs);
+    case ORIENTATION_OVERRIDE:
+      return command_orientation_override(command, targs);
+    case BLACKBOX_DUMP:
+      return command_blackbox_dump(command, targs);
+    case BLACKBOX_REPLAY:
+      return command_blackbox_replay(command, targs);
+    case CPU_TOP:
+      return command_cpu_top(command, targs);
     default:
       return RET_ERROR;
   }
 }
 
+int command_enqueue(const command_t *command, thread_args_t *targs) {
+  command_stats_t *stats = &targs->command_stats;
+  command_t *command_q;
+  uint32_t depth;
+
+  if ((command_q = targs->command_queue->alloc()) == NULL) {
+    stats->rejected++;
+    return RET_ERROR;
+  }
+  memcpy(command_q, command, sizeof(command_t));
+  command_q->enqueued_us = (uint32_t) clock_now_us();
+
+  // Count the command before it becomes visible to the executor, which
+  // decrements the depth as soon as it takes the command off the queue.
+  depth = core_util_atomic_incr_u32(&stats->depth, 1);
+  if (depth > stats->max_depth) {
+    stats->max_depth = depth;
+  }
+  targs->command_queue->put(command_q);
+  return RET_OK;
+}
+
 int command_fully_disarm(command_t *command, thread_args_t *targs) {
   if (targs->state == STATE_DISARMED) {
     return RET_ALREADY_DISARMED;
@@ -218,9 +163,9 @@ int command_fully_arm(command_t *command, thread_args_t *targs) {
 int command_status(command_t *command, thread_args_t *targs) {
   LOG("\rStatus: %s\r\n", state_to_str(targs->state));
   // LOG("\r(ESCS) D1: %d, D2: %d, D3: %d, W1: %d, W2: %d\r\n",
-  //   targs->outputs.wheel_1,
-  //   targs->outputs.wheel_2,
-  //   targs->outputs.wheel_3,
+  //   targs->outputs.wheel[0],
+  //   targs->outputs.wheel[1],
+  //   targs->outputs.wheel[2],
   //   targs->outputs.weapon_motor_1,
   //   targs->outputs.weapon_motor_2,
   // );
@@ -230,75 +175,66 @@ int command_status(command_t *command, thread_args_t *targs) {
     orientation_to_str(targs->orientation_detected),
     orientation_to_str(targs->orientation_override)
   );
-  LOG("\r              heading: %d, pitch: %d, roll: %d\r\n", targs->orientation.heading, targs->orientation.pitch, targs->orientation.roll);
+  LOG("\r              driving: %s, flip latency: %d us\r\n",
+    targs->inverted ? "inverted" : "upright", targs->flip_latency_us);
+  LOG("\r              heading: %.1f, pitch: %.1f, roll: %.1f\r\n", targs->orientation.heading, targs->orientation.pitch, targs->orientation.roll);
+#ifdef DEVICE_BNO055
+  LOG("\r(I2C) completed: %d, nacked: %d, rejected: %d\r\n",
+    targs->i2c.completed, targs->i2c.nacked, targs->i2c.rejected);
+  LOG("\r(BNO055) mode: 0x%02x, data rate: %d Hz, read on: %s\r\n",
+    targs->imu_config.mode, bno055_data_rate_hz(&targs->imu_config),
+    targs->imu_config.data_ready_int ? "INT" : "timer");
+  LOG("\r         samples/sec: %d, samples: %d, duplicates: %d\r\n",
+    targs->imu_stats.samples_per_sec, targs->imu_stats.samples,
+    targs->imu_stats.duplicates);
+#endif
   return RET_OK;
 }
 
 int command_get_param(command_t *command, thread_args_t *targs) {
-  LOG("Getting param\r\n");
-  switch (command->tele_param->id) {
-    case CID_DRIVE_RPM_1:
-    case CID_DRIVE_RPM_2:
-    case CID_DRIVE_RPM_3:
-    case CID_WEAPON_RPM_1:
-    case CID_WEAPON_RPM_2:
-    case CID_WEAPON_RPM_3:
-#ifdef DEVICE_BNO055
-    case CID_ACCEL_X:
-    case CID_ACCEL_Y:
-    case CID_ACCEL_Z:
-    case CID_PITCH:
-    case CID_ROLL:
-    case CID_YAW:
-    case CID_AMBIENT_TEMP:
-#endif
-    case CID_WEAPON_VOLTAGE_1:
-    case CID_WEAPON_VOLTAGE_2:
-    case CID_WEAPON_VOLTAGE_3:
-    case CID_DRIVE_VOLTAGE_1:
-    case CID_DRIVE_VOLTAGE_2:
-    case CID_DRIVE_VOLTAGE_3:
-    case CID_ARM_STATUS:
-      printf(
-        "%s %s\r\n",
-        tele_commands[command->tele_param->id].name,
-        state_to_str(targs->state));
+  tele_command_t *param = command->tele_param;
+
+  switch (param->type) {
+    case CT_FLOAT:
+      LOG("\r%s %.2f %s\r\n", param->name, tele_store_get_f(param->id),
+        tele_command_unit_to_string(param->unit));
+      break;
+    case CT_INT:
+      LOG("\r%s %d %s\r\n", param->name, tele_store_get_i(param->id),
+        tele_command_unit_to_string(param->unit));
       break;
+    case CT_BOOLEAN:
+      LOG("\r%s %s\r\n", param->name, tele_store_get_b(param->id) ? "ON" : "OFF");
+      break;
+    default:
+      return RET_ERROR;
   }
   return RET_OK;
 }
+
 int command_set_param(command_t *command, thread_args_t *targs) {
-  LOG("Setting param\r\n");
-  switch (command->tele_param->id) {
-    case CID_DRIVE_RPM_1:
-    case CID_DRIVE_RPM_2:
-    case CID_DRIVE_RPM_3:
-    case CID_WEAPON_RPM_1:
-    case CID_WEAPON_RPM_2:
-    case CID_WEAPON_RPM_3:
-#ifdef DEVICE_BNO055
-    case CID_ACCEL_X:
-    case CID_ACCEL_Y:
-    case CID_ACCEL_Z:
-    case CID_PITCH:
-    case CID_ROLL:
-    case CID_YAW:
-    case CID_AMBIENT_TEMP:
-      tele_commands[command->tele_param->id].param.f = command->value.f;
+  tele_command_t *param = command->tele_param;
+
+  if (param->id == CID_ARM_STATUS) {
+    printf("Use arming commands to set arm_state!\r\n");
+    return RET_ERROR;
+  }
+  switch (param->type) {
+    case CT_FLOAT:
+      tele_store_set_f(param->id, command->value.f);
       break;
-#endif
-    case CID_WEAPON_VOLTAGE_1:
-    case CID_WEAPON_VOLTAGE_2:
-    case CID_WEAPON_VOLTAGE_3:
-    case CID_DRIVE_VOLTAGE_1:
-    case CID_DRIVE_VOLTAGE_2:
-    case CID_DRIVE_VOLTAGE_3:
-    case CID_ARM_STATUS:
-      printf("Use arming commands to set arm_state!\r\n");
+    case CT_INT:
+      tele_store_set_i(param->id, command->value.i);
+      break;
+    case CT_BOOLEAN:
+      tele_store_set_b(param->id, command->value.b);
+      break;
+    default:
       return RET_ERROR;
   }
   return RET_OK;
 }
+
 #ifdef TASK_CALIBRATE_CHANNELS
 int command_calibrate_channels(command_t *command, thread_args_t *targs) {
   if (targs->state != STATE_DISARMED) {
@@ -309,3 +245,296 @@ int command_calibrate_channels(command_t *command, thread_args_t *targs) {
   return RET_OK;
 }
 #endif  // TASK_CALIBRATE_CHANNELS
+
+int command_loop_timing(command_t *command, thread_args_t *targs) {
+  loop_stats_t *stats = &targs->motor_loop;
+  unsigned i;
+
+  LOG("\rMotor drive loop: %d Hz, %d cycles, %d overruns\r\n",
+    1000000 / stats->period_us, stats->cycles, stats->overruns);
+  LOG("\r%12s %10s %10s %10s\r\n", "us", "jitter", "exec", "latency");
+  for (i = 0; i < LOOP_STATS_NUM_BINS - 1; i++) {
+    LOG("\r%5d - %-4d %10d %10d %10d\r\n",
+      i * LOOP_STATS_BIN_WIDTH_US,
+      (i + 1) * LOOP_STATS_BIN_WIDTH_US - 1,
+      stats->jitter.bins[i],
+      stats->exec.bins[i],
+      stats->latency.bins[i]);
+  }
+  LOG("\r%5d +      %10d %10d %10d\r\n",
+    i * LOOP_STATS_BIN_WIDTH_US,
+    stats->jitter.bins[i],
+    stats->exec.bins[i],
+    stats->latency.bins[i]);
+  LOG("\r(jitter) min: %d, mean: %d, max: %d\r\n",
+    stats->jitter.samples ? stats->jitter.min_us : 0,
+    timing_histogram_mean(&stats->jitter),
+    stats->jitter.max_us);
+  LOG("\r(exec)   min: %d, mean: %d, max: %d\r\n",
+    stats->exec.samples ? stats->exec.min_us : 0,
+    timing_histogram_mean(&stats->exec),
+    stats->exec.max_us);
+  LOG("\r(latency) min: %d, mean: %d, max: %d\r\n",
+    stats->latency.samples ? stats->latency.min_us : 0,
+    timing_histogram_mean(&stats->latency),
+    stats->latency.max_us);
+  LOG("\rDropped pulses: %d (weapon), %d (drive)\r\n",
+    targs->receiver[0].pulses.dropped(),
+    targs->receiver[1].pulses.dropped());
+
+  // The motor drive task owns the statistics, so ask it to clear them.
+  stats->reset_requested = true;
+  return RET_OK;
+}
+
+int command_filter_stats(command_t *command, thread_args_t *targs) {
+  input_filter_t *filter = &targs->input_filter;
+  int controller, channel;
+
+  LOG("\rInput filter stages: %s%s%s%s\r\n",
+    (filter->stages & RC_FILTER_RANGE) ? "range " : "",
+    (filter->stages & RC_FILTER_STEP) ? "step " : "",
+    (filter->stages & RC_FILTER_MEDIAN) ? "median " : "",
+    (filter->stages & RC_FILTER_IIR) ? "iir" : "");
+  for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
+    LOG("\rController %d rejected:", controller + 1);
+    for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
+      LOG(" %d", filter->channel[controller][channel].rejected);
+    }
+    LOG("\r\n");
+  }
+  return RET_OK;
+}
+
+int command_queue_stats(command_t *command, thread_args_t *targs) {
+  command_stats_t *stats = &targs->command_stats;
+  unsigned i;
+
+  LOG("\rCommand queue: %d waiting, %d max (of %d), %d rejected\r\n",
+    stats->depth, stats->max_depth, COMMAND_QUEUE_LEN, stats->rejected);
+  LOG("\r%12s %10s %10s\r\n", "us", "wait", "latency");
+  for (i = 0; i < LOOP_STATS_NUM_BINS - 1; i++) {
+    LOG("\r%5d - %-4d %10d %10d\r\n",
+      i * LOOP_STATS_BIN_WIDTH_US,
+      (i + 1) * LOOP_STATS_BIN_WIDTH_US - 1,
+      stats->wait.bins[i],
+      stats->latency.bins[i]);
+  }
+  LOG("\r%5d +      %10d %10d\r\n",
+    i * LOOP_STATS_BIN_WIDTH_US,
+    stats->wait.bins[i],
+    stats->latency.bins[i]);
+  LOG("\r(wait)    min: %d, mean: %d, max: %d\r\n",
+    stats->wait.samples ? stats->wait.min_us : 0,
+    timing_histogram_mean(&stats->wait),
+    stats->wait.max_us);
+  LOG("\r(latency) min: %d, mean: %d, max: %d\r\n",
+    stats->latency.samples ? stats->latency.min_us : 0,
+    timing_histogram_mean(&stats->latency),
+    stats->latency.max_us);
+  return RET_OK;
+}
+
+int command_telemetry_meta(command_t *command, thread_args_t *targs) {
+  targs->telemetry_meta_requested = true;
+  return RET_OK;
+}
+
+int command_telemetry_link_stats(command_t *command, thread_args_t *targs) {
+  tele_delta_t *delta = &targs->telemetry_delta;
+
+  LOG("\rTelemetry frames: %d keyframes, %d deltas (every %d ms)\r\n",
+    delta->keyframes, delta->deltas, TELEMETRY_STREAM_PERIOD_MS);
+  LOG("\rValues: %d sent, %d within deadband\r\n",
+    delta->values_sent, delta->values_skipped);
+  LOG("\rBytes: %d sent, %d saved\r\n",
+    delta->bytes_sent, delta->bytes_saved);
+  return RET_OK;
+}
+
+int command_heading_lock(command_t *command, thread_args_t *targs) {
+#ifdef DEVICE_BNO055
+  // Without fusion the heading is never updated, so there is nothing to hold
+  if (!targs->heading_lock_enabled && !bno055_fusion_mode(&targs->imu_config)) {
+    LOG("\rHeading lock needs a fusion mode, see BNO055_MODE\r\n");
+    return RET_ERROR;
+  }
+  targs->heading_lock_enabled = !targs->heading_lock_enabled;
+  LOG("\rHeading lock %s\r\n", targs->heading_lock_enabled ? "on" : "off");
+  return RET_OK;
+#else
+  LOG("\rHeading lock needs the BNO055\r\n");
+  return RET_ERROR;
+#endif
+}
+
+int command_heading_status(command_t *command, thread_args_t *targs) {
+#ifdef DEVICE_BNO055
+  loop_stats_t *stats = &targs->heading_loop;
+  heading_pid_t *pid = &targs->heading_pid;
+
+  LOG("\rHeading lock: %s%s, heading: %.1f, locked: %.1f\r\n",
+    targs->heading_lock_enabled ? "on" : "off",
+    targs->heading_lock_turning ? " (turning)" : "",
+    targs->orientation.heading, targs->heading_lock);
+  LOG("\r(pid) kp: %.4f, ki: %.4f, kd: %.4f, speed: %d%%, deadband: %d\r\n",
+    tele_store_get_f(CID_HEADING_KP), tele_store_get_f(CID_HEADING_KI),
+    tele_store_get_f(CID_HEADING_KD), targs->heading_lock_speed,
+    targs->heading_lock_deadband);
+  LOG("\r(pid) error: %.2f, integral: %.2f, output: %.3f\r\n",
+    pid->error, pid->integral, pid->output);
+  LOG("\rHeading loop: %d Hz, %d cycles, %d overruns\r\n",
+    1000000 / stats->period_us, stats->cycles, stats->overruns);
+  LOG("\r(jitter) min: %d, mean: %d, max: %d\r\n",
+    stats->jitter.samples ? stats->jitter.min_us : 0,
+    timing_histogram_mean(&stats->jitter),
+    stats->jitter.max_us);
+  LOG("\r(exec)   min: %d, mean: %d, max: %d\r\n",
+    stats->exec.samples ? stats->exec.min_us : 0,
+    timing_histogram_mean(&stats->exec),
+    stats->exec.max_us);
+
+  // The orientation task owns the statistics, so ask it to clear them.
+  stats->reset_requested = true;
+  return RET_OK;
+#else
+  LOG("\rHeading lock needs the BNO055\r\n");
+  return RET_ERROR;
+#endif
+}
+
+int command_orientation_override(command_t *command, thread_args_t *targs) {
+  switch (targs->orientation_override) {
+    case ORIENTATION_AUTO:
+      targs->orientation_override = UPRIGHT;
+      break;
+    case UPRIGHT:
+      targs->orientation_override = INVERTED;
+      break;
+    default:
+      targs->orientation_override = ORIENTATION_AUTO;
+      break;
+  }
+  targs->orientation_changed_us = (uint32_t) clock_now_us();
+  LOG("\rOrientation override: %s (detected: %s)\r\n",
+    orientation_to_str(targs->orientation_override),
+    orientation_to_str(targs->orientation_detected));
+  return RET_OK;
+}
+
+int command_blackbox_dump(command_t *command, thread_args_t *targs) {
+  static const char hex[] = "0123456789abcdef";
+  blackbox_t *blackbox = &targs->blackbox;
+  char line[2 * sizeof(blackbox_record_t) + 1];
+  const uint8_t *bytes;
+  const channel_limits_t *limits;
+  uint32_t count, i, j;
+
+  blackbox->paused = true;
+  count = blackbox_count(blackbox);
+
+  // Everything else replay_init needs to reproduce the recorded cycles
+#ifdef CONTROL_FIXED_POINT
+  LOG("\rblackbox %d %d fixed %d %d %d\r\n", count, (int) sizeof(blackbox_record_t),
+#else
+  LOG("\rblackbox %d %d float %d %d %d\r\n", count, (int) sizeof(blackbox_record_t),
+#endif
+    targs->drive_mode->id, targs->weapon_mode->id, (int) targs->input_filter.stages);
+  for (i = 0; i < RC_NUMBER_CONTROLLERS; i++) {
+    limits = targs->channel_limits[i];
+    LOG("\rlimits %d", i);
+    for (j = 0; j < RC_NUMBER_CHANNELS; j++) {
+      LOG(" %.9g %.9g", limits[j].min, limits[j].max);
+    }
+    LOG("\r\n");
+  }
+  for (i = 0; i < count; i++) {
+    bytes = (const uint8_t *) blackbox_get(blackbox, i);
+    for (j = 0; j < sizeof(blackbox_record_t); j++) {
+      line[2 * j] = hex[bytes[j] >> 4];
+      line[2 * j + 1] = hex[bytes[j] & 0x0F];
+    }
+    line[2 * j] = '\0';
+    LOG("\rBB %s\r\n", line);
+  }
+  LOG("\rblackbox end\r\n");
+  blackbox->paused = false;
+
+  LOG("\r(record) min: %d, mean: %d, max: %d us\r\n",
+    blackbox->cost.samples ? blackbox->cost.min_us : 0,
+    timing_histogram_mean(&blackbox->cost),
+    blackbox->cost.max_us);
+  return RET_OK;
+}
+
+int command_blackbox_replay(command_t *command, thread_args_t *targs) {
+  // Too big for the executor's stack
+  static replay_t replay;
+  blackbox_t *blackbox = &targs->blackbox;
+  const blackbox_record_t *first, *last;
+  replay_stats_t *stats = &replay.stats;
+  uint32_t count, i, start_us, took_us;
+
+  blackbox->paused = true;
+  count = blackbox_count(blackbox);
+  if (count == 0) {
+    blackbox->paused = false;
+    LOG("\rNothing recorded\r\n");
+    return RET_ERROR;
+  }
+  replay_init(&replay, targs->channel_limits, targs->drive_mode, targs->weapon_mode,
+    targs->input_filter.stages);
+
+  start_us = (uint32_t) clock_now_us();
+  for (i = 0; i < count; i++) {
+    replay_cycle(&replay, blackbox_get(blackbox, i), NULL);
+  }
+  took_us = (uint32_t) clock_now_us() - start_us;
+
+  first = blackbox_get(blackbox, 0);
+  last = blackbox_get(blackbox, count - 1);
+  LOG("\rReplayed %d cycles (%d ms recorded) in %d us\r\n",
+    stats->cycles, (last->time_us - first->time_us) / 1000, took_us);
+  blackbox->paused = false;
+
+  LOG("\rcompared: %d, unverified: %d\r\n", stats->compared, stats->unverified);
+  LOG("\rmismatched controls: %d, outputs: %d, state: %d, first: %d\r\n",
+    stats->control_mismatches, stats->output_mismatches, stats->state_mismatches,
+    stats->first_mismatch);
+  return (stats->first_mismatch < 0) ? RET_OK : RET_ERROR;
+}
+
+int command_cpu_top(command_t *command, thread_args_t *targs) {
+  // Too big for the executor's stack. The last reading is kept so that each
+  // top shows the usage since the one before.
+  static cpu_usage_t usage, previous;
+  const cpu_task_usage_t *task, *before;
+  uint64_t elapsed;
+  unsigned i;
+
+  cpu_monitor_read(&usage);
+  elapsed = usage.elapsed - previous.elapsed;
+
+  LOG("\rCPU usage over the last %d ms\r\n", cpu_monitor_us(elapsed) / 1000);
+  LOG("\r%3s %-20s %6s %8s %9s %9s %7s\r\n",
+    "id", "task", "cpu %", "runs", "worst us", "period us", "misses");
+  for (i = 0; i < usage.num_tasks; i++) {
+    task = &usage.tasks[i];
+    before = &previous.tasks[i];
+    LOG("\r%3d %-20s %6.1f %8d %9d %9d %7d\r\n",
+      i, targs->tasks[i].name,
+      cpu_usage_percent(task->busy - before->busy, elapsed),
+      task->runs - before->runs,
+      cpu_monitor_us(task->worst_run),
+      targs->tasks[i].period_us,
+      task->misses - before->misses);
+  }
+  LOG("\r    %-20s %6.1f\r\n", "idle", cpu_usage_percent(usage.idle - previous.idle, elapsed));
+  LOG("\r    %-20s %6.1f\r\n", "other",
+    cpu_usage_percent(cpu_usage_other(&usage) - cpu_usage_other(&previous), elapsed));
+  LOG("\rWorst run times are since start up. Interrupts count towards the task\r\n");
+  LOG("\rthey interrupt, other is untracked threads and interrupts while idle.\r\n");
+
+  memcpy(&previous, &usage, sizeof(cpu_usage_t));
+  return RET_OK;
+}
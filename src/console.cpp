@@ -0,0 +1,62 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file console.cpp
+ * @author Cameron A. Craig
+ * @date 31 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Interrupt driven command line on the USB serial port.
+ */
+
+#include <string.h>
+#include "console.h"
+
+static void console_rx(console_t *console) {
+  char echo[LINE_BUFFER_ECHO_LEN];
+  uint32_t echo_len, i;
+  console_line_t complete;
+
+  while (console->serial->readable()) {
+    if (line_buffer_add(&console->line, console->serial->getc(), echo, &echo_len)) {
+      memcpy(complete.text, console->line.text, console->line.length + 1);
+      line_buffer_clear(&console->line);
+      // If the reader has fallen behind the line is dropped and counted
+      if (console->lines.push(complete) && console->notify != NULL) {
+        console->notify->signal_set(console->signal);
+      }
+    }
+    // Only the change is echoed, a few characters at most
+    for (i = 0; i < echo_len; i++) {
+      console->serial->putc(echo[i]);
+    }
+  }
+}
+
+void console_init(console_t *console, RawSerial *serial) {
+  console->serial = serial;
+  line_buffer_clear(&console->line);
+  serial->attach(callback(console_rx, console), SerialBase::RxIrq);
+}
+
+void console_notify(console_t *console, Thread *thread, int32_t signal) {
+  console->signal = signal;
+  console->notify = thread;
+}
+
+bool console_read_line(console_t *console, console_line_t *line) {
+  return console->lines.pop(line);
+}
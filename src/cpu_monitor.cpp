@@ -0,0 +1,96 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * @file cpu_monitor.cpp
+ * @author Cameron A. Craig
+ * @date 20 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Measures the processor time used by each task with the DWT cycle
+ *        counter, and the time spent idle from the RTOS idle thread.
+ */
+
+#include "mbed.h"
+#include "rtos.h"
+#include "cpu_monitor.h"
+
+static cpu_usage_t cpu_monitor_usage;
+static uint32_t cpu_monitor_cycles_per_us;
+
+/**
+* @brief Replaces the default idle hook, which just sleeps.
+*/
+static void cpu_monitor_idle(void) {
+  uint32_t start, end, start_us, counted, asleep;
+
+  // An interrupt still wakes the processor with interrupts masked, but isn't
+  // taken until they are unmasked again. That keeps the interrupt, and any
+  // thread it releases, out of the time measured as idle.
+  core_util_critical_section_enter();
+  start_us = us_ticker_read();
+  start = DWT->CYCCNT;
+  sleep();
+  end = DWT->CYCCNT;
+
+  // The cycle counter stops while the processor clock is gated in sleep,
+  // the microsecond ticker keeps running.
+  asleep = (us_ticker_read() - start_us) * cpu_monitor_cycles_per_us;
+  counted = end - start;
+  cpu_usage_idle(&cpu_monitor_usage, start, end, (asleep > counted) ? asleep - counted : 0);
+  core_util_critical_section_exit();
+}
+
+void cpu_monitor_init(const task_t *tasks, unsigned num_tasks) {
+  unsigned i;
+
+  cpu_monitor_cycles_per_us = SystemCoreClock / 1000000;
+
+  // Enable the trace block, which the DWT cycle counter belongs to
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+  core_util_critical_section_enter();
+  cpu_usage_init(&cpu_monitor_usage, num_tasks, DWT->CYCCNT);
+  for (i = 0; i < num_tasks; i++) {
+    cpu_usage_set_period(&cpu_monitor_usage, i, tasks[i].period_us * cpu_monitor_cycles_per_us);
+  }
+  core_util_critical_section_exit();
+
+  Thread::attach_idle_hook(cpu_monitor_idle);
+}
+
+void cpu_monitor_wake(unsigned task, bool release) {
+  core_util_critical_section_enter();
+  cpu_usage_wake(&cpu_monitor_usage, task, DWT->CYCCNT, release);
+  core_util_critical_section_exit();
+}
+
+void cpu_monitor_block(unsigned task) {
+  core_util_critical_section_enter();
+  cpu_usage_block(&cpu_monitor_usage, task, DWT->CYCCNT);
+  core_util_critical_section_exit();
+}
+
+void cpu_monitor_read(cpu_usage_t *usage) {
+  core_util_critical_section_enter();
+  cpu_usage_update(&cpu_monitor_usage, DWT->CYCCNT);
+  memcpy(usage, &cpu_monitor_usage, sizeof(cpu_usage_t));
+  core_util_critical_section_exit();
+}
+
+uint32_t cpu_monitor_us(uint64_t cycles) {
+  return (uint32_t) (cycles / cpu_monitor_cycles_per_us);
+}
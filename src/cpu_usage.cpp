@@ -0,0 +1,132 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * @file cpu_usage.cpp
+ * @author Cameron A. Craig
+ * @date 20 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Charges processor time to the task running between each wake,
+ *        block and idle event.
+ */
+
+#include <string.h>
+#include "cpu_usage.h"
+
+void cpu_usage_init(cpu_usage_t *cpu, unsigned num_tasks, uint32_t now) {
+  unsigned i;
+
+  memset(cpu, 0x00, sizeof(cpu_usage_t));
+  cpu->num_tasks = (num_tasks < CPU_USAGE_MAX_TASKS) ? num_tasks : CPU_USAGE_MAX_TASKS;
+  for (i = 0; i < CPU_USAGE_MAX_TASKS; i++) {
+    cpu->tasks[i].preempted = CPU_USAGE_NONE;
+  }
+  cpu->running = CPU_USAGE_NONE;
+  cpu->charged_at = now;
+}
+
+void cpu_usage_set_period(cpu_usage_t *cpu, unsigned task, uint32_t period) {
+  if (task < cpu->num_tasks) {
+    cpu->tasks[task].period = period;
+  }
+}
+
+void cpu_usage_update(cpu_usage_t *cpu, uint32_t now) {
+  // Unsigned subtraction is right across a wrap of the counter, as long as
+  // events are less than one wrap apart.
+  uint32_t delta = now - cpu->charged_at;
+
+  cpu->charged_at = now;
+  cpu->elapsed += delta;
+  if (cpu->running != CPU_USAGE_NONE) {
+    cpu->tasks[cpu->running].busy += delta;
+    cpu->tasks[cpu->running].run += delta;
+  }
+}
+
+void cpu_usage_wake(cpu_usage_t *cpu, unsigned task, uint32_t now, bool release) {
+  cpu_task_usage_t *t;
+
+  if (task >= cpu->num_tasks) {
+    return;
+  }
+  t = &cpu->tasks[task];
+  cpu_usage_update(cpu, now);
+
+  // Tasks only preempt lower priority ones, so the preempted tasks form a
+  // stack that unwinds as each blocks.
+  if (cpu->running != (int) task) {
+    t->preempted = cpu->running;
+    cpu->running = task;
+  }
+
+  if (release || t->period == 0) {
+    // The deadline of the previous run was one period after its release.
+    if (t->runs > 0) {
+      if (t->run > t->worst_run) {
+        t->worst_run = t->run;
+      }
+      if (t->period > 0 && t->blocked_at - t->released_at > t->period) {
+        t->misses++;
+      }
+    }
+    t->runs++;
+    t->run = 0;
+    t->released_at = now;
+  }
+}
+
+void cpu_usage_block(cpu_usage_t *cpu, unsigned task, uint32_t now) {
+  cpu_task_usage_t *t;
+
+  if (task >= cpu->num_tasks) {
+    return;
+  }
+  t = &cpu->tasks[task];
+  cpu_usage_update(cpu, now);
+
+  t->blocked_at = now;
+  cpu->running = (t->preempted != (int) task) ? t->preempted : CPU_USAGE_NONE;
+  t->preempted = CPU_USAGE_NONE;
+}
+
+void cpu_usage_idle(cpu_usage_t *cpu, uint32_t start, uint32_t end, uint32_t stopped) {
+  uint32_t slept = (end - start) + stopped;
+
+  cpu_usage_update(cpu, start);
+
+  // A task that blocked somewhere not reported stops being charged here.
+  cpu->running = CPU_USAGE_NONE;
+  cpu->idle += slept;
+  cpu->elapsed += slept;
+  cpu->charged_at = end;
+}
+
+uint64_t cpu_usage_other(const cpu_usage_t *cpu) {
+  uint64_t used = cpu->idle;
+  unsigned i;
+
+  for (i = 0; i < cpu->num_tasks; i++) {
+    used += cpu->tasks[i].busy;
+  }
+  return (cpu->elapsed > used) ? cpu->elapsed - used : 0;
+}
+
+float cpu_usage_percent(uint64_t part, uint64_t whole) {
+  if (whole == 0) {
+    return 0.0f;
+  }
+  return (float) part * 100.0f / (float) whole;
+}
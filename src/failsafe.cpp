@@ -0,0 +1,126 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file failsafe.cpp
+ * @author Cameron A. Craig
+ * @date 24 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Disarms the outputs of a receiver as soon as it stops sending frames.
+ */
+
+#include "mbed.h"
+#include "failsafe.h"
+#include "clock.h"
+#include "states.h"
+#include "utils.h"
+
+/**
+ * Deadline of one receiver.
+ */
+typedef struct {
+  thread_args_t *args;
+  int controller;
+  Timeout *deadline;
+} failsafe_receiver_t;
+
+static failsafe_receiver_t failsafe_receivers[RC_NUMBER_CONTROLLERS];
+static volatile uint32_t failsafe_worst_us;
+static volatile uint32_t failsafe_trip_count;
+
+static void failsafe_stop_drive(thread_args_t *args) {
+  int i;
+
+  args->state = state_failsafe(args->state, 1);
+  for (i = 0; i < NUM_DRIVE_ESCS; i++) {
+    args->comms_impl->stop(&args->escs.drive[i]);
+  }
+}
+
+static void failsafe_stop_weapon(thread_args_t *args) {
+  args->state = state_failsafe(args->state, 0);
+  args->comms_impl->stop(&args->escs.weapon[0]);
+  args->comms_impl->stop(&args->escs.weapon[1]);
+  args->comms_impl->stop(&args->escs.weapon[2]);
+}
+
+/* Called from the Timeout interrupt when a receiver misses its deadline */
+static void failsafe_expired(failsafe_receiver_t *rx) {
+  thread_args_t *args = rx->args;
+  uint64_t last_frame = clock_read_stamp(&args->receiver[rx->controller].frame_us);
+  uint32_t latency = (uint32_t) (clock_now_us() - last_frame);
+
+  // Controller 0 is the weapon, controller 1 the drive
+  if (rx->controller == 0) {
+    failsafe_stop_weapon(args);
+  } else {
+    failsafe_stop_drive(args);
+  }
+
+  if (latency > failsafe_worst_us) {
+    failsafe_worst_us = latency;
+  }
+  failsafe_trip_count++;
+}
+
+/* Called from the receiver interrupt each time it completes a frame */
+static void failsafe_frame(void *context) {
+  failsafe_receiver_t *rx = (failsafe_receiver_t *) context;
+
+  rx->deadline->attach_us(callback(failsafe_expired, rx), RC_STALL_TIMEOUT_US);
+}
+
+void failsafe_init(thread_args_t *args) {
+  int controller;
+  failsafe_receiver_t *rx;
+
+  for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
+    rx = &failsafe_receivers[controller];
+    rx->args = args;
+    rx->controller = controller;
+    rx->deadline = new Timeout();
+    // Deadlines are only armed once a receiver has sent a frame, until then
+    // it can't arm anything
+    rc_capture_on_frame(&args->receiver[controller], failsafe_frame, rx);
+  }
+}
+
+void failsafe_poll(thread_args_t *args) {
+  bool weapon_stalled = is_weapon_stalled(args);
+  bool drive_stalled = is_drive_stalled(args);
+
+  if (!weapon_stalled && !drive_stalled) {
+    return;
+  }
+
+  // The deadline interrupt may lower the state at the same time
+  core_util_critical_section_enter();
+  if (weapon_stalled) {
+    args->state = state_failsafe(args->state, 0);
+  }
+  if (drive_stalled) {
+    args->state = state_failsafe(args->state, 1);
+  }
+  core_util_critical_section_exit();
+}
+
+uint32_t failsafe_worst_latency_us(void) {
+  return failsafe_worst_us;
+}
+
+uint32_t failsafe_trips(void) {
+  return failsafe_trip_count;
+}
@@ -0,0 +1,51 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file fixed.cpp
+ * @author Cameron A. Craig
+ * @date 17 Feb 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Q16.16 fixed point arithmetic.
+ */
+
+#include "fixed.h"
+
+q16_t q16_map(q16_t in, q16_t inMin, q16_t inMax, q16_t outMin, q16_t outMax) {
+  // check it's within the range
+  if (inMin < inMax) {
+    if (in <= inMin)
+      return outMin;
+    if (in >= inMax)
+      return outMax;
+  } else {  // cope with input range being backwards.
+    if (in >= inMin)
+      return outMin;
+    if (in <= inMax)
+      return outMax;
+  }
+  // Scale in 64 bits so the product of the two ranges can't overflow
+  int64_t scaled = ((int64_t) in - inMin) * ((int64_t) outMax - outMin);
+  return q16_saturate((int64_t) outMin + scaled / ((int64_t) inMax - inMin));
+}
+
+q16_t q16_normalize(q16_t heading) {
+  while (heading > Q16(180))
+    heading -= Q16(360);
+  while (heading < Q16(-180))
+    heading += Q16(360);
+  return heading;
+}
@@ -0,0 +1,66 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * @file heading_lock.cpp
+ * @author Cameron A. Craig
+ * @date 16 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief PID controller that holds the robot on a heading.
+ */
+
+#include "heading_lock.h"
+#include "tmath.h"
+
+void heading_pid_reset(heading_pid_t *pid) {
+  pid->integral = 0;
+  pid->error = 0;
+  pid->output = 0;
+}
+
+float heading_error(float setpoint, float heading) {
+  return normalize(setpoint - heading);
+}
+
+float heading_pid_update(heading_pid_t *pid, const pid_gains_t *gains, float error, float rate,
+                         float dt, float deadband, float limit) {
+  float integral;
+
+  if (error < deadband && error > -deadband) {
+    error = 0;
+  }
+  pid->error = error;
+
+  integral = pid->integral + error * dt;
+  pid->output = gains->kp * error + gains->ki * integral - gains->kd * rate;
+
+  // Only keep integrating while the output is not saturated, or while the
+  // error is pulling it back, so the integral can not wind up while the
+  // robot is held against something.
+  if (pid->output > limit) {
+    pid->output = limit;
+    if (error < 0) {
+      pid->integral = integral;
+    }
+  } else if (pid->output < -limit) {
+    pid->output = -limit;
+    if (error > 0) {
+      pid->integral = integral;
+    }
+  } else {
+    pid->integral = integral;
+  }
+  return pid->output;
+}
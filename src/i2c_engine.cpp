@@ -0,0 +1,123 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file i2c_engine.cpp
+ * @author Cameron A. Craig
+ * @date 11 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Queues I2C transactions from any number of devices and threads and
+ *        runs them one at a time on a bus thread.
+ */
+
+#include "i2c_engine.h"
+#include "return_codes.h"
+
+/*
+  The LPC1768 HAL has no asynchronous I2C, a transfer polls the peripheral
+  until it completes. Running every transfer on a bus thread keeps that
+  polling out of the threads that use the bus: they queue a transaction and
+  sleep, or carry on, until they are called back or signalled.
+*/
+
+static void i2c_engine_run(i2c_engine_t *engine) {
+  osEvent event;
+  i2c_transaction_t *t;
+  i2c_callback_t callback;
+  Thread *notify;
+  int32_t signal;
+  int ret;
+
+  while (true) {
+    event = engine->queue->get();
+    if (event.status != osEventMessage) {
+      continue;
+    }
+    t = (i2c_transaction_t *) event.value.p;
+
+    ret = 0;
+    if (t->tx_len > 0) {
+      // Keep the bus for a read that follows, so no other master can
+      // change the register pointer in between.
+      ret = engine->bus->write(t->address, t->tx, t->tx_len, t->rx_len > 0);
+    }
+    if (ret == 0 && t->rx_len > 0) {
+      ret = engine->bus->read(t->address, t->rx, t->rx_len, false);
+    }
+
+    // The submitter may reuse the transaction as soon as it is called back
+    // or signalled, e.g. i2c_transfer() returns and its stack is gone, so
+    // nothing in it is read after that.
+    callback = t->callback;
+    notify = t->notify;
+    signal = t->signal;
+
+    if (ret == 0) {
+      engine->completed++;
+      t->result = I2C_DONE;
+    } else {
+      engine->nacked++;
+      t->result = I2C_NACK;
+    }
+
+    if (callback != NULL) {
+      callback(t);
+    }
+    if (notify != NULL) {
+      notify->signal_set(signal);
+    }
+  }
+}
+
+static void i2c_transfer_done(i2c_transaction_t *transaction) {
+  ((Semaphore *) transaction->context)->release();
+}
+
+void i2c_engine_init(i2c_engine_t *engine, PinName sda, PinName scl, int frequency_hz) {
+  engine->bus = new I2C(sda, scl);
+  engine->bus->frequency(frequency_hz);
+  engine->queue = new Queue<i2c_transaction_t, I2C_QUEUE_LEN>();
+  engine->completed = 0;
+  engine->nacked = 0;
+  engine->rejected = 0;
+
+  // Below the motor drive task, which must never wait while a transfer
+  // polls the bus.
+  engine->thread = new Thread(osPriorityBelowNormal, I2C_STACK_SIZE);
+  engine->thread->start(callback(i2c_engine_run, engine));
+}
+
+int i2c_submit(i2c_engine_t *engine, i2c_transaction_t *transaction) {
+  transaction->result = I2C_PENDING;
+  if (engine->queue->put(transaction) != osOK) {
+    engine->rejected++;
+    return RET_ERROR;
+  }
+  return RET_OK;
+}
+
+i2c_result_t i2c_transfer(i2c_engine_t *engine, i2c_transaction_t *transaction) {
+  Semaphore done(0);
+
+  transaction->callback = i2c_transfer_done;
+  transaction->context = &done;
+  transaction->notify = NULL;
+  if (i2c_submit(engine, transaction) != RET_OK) {
+    return I2C_PENDING;
+  }
+  done.wait();
+  return transaction->result;
+}
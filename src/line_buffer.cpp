@@ -0,0 +1,66 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file line_buffer.cpp
+ * @author Cameron A. Craig
+ * @date 31 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Assembles command lines from typed characters.
+ */
+
+#include "line_buffer.h"
+
+void line_buffer_clear(line_buffer_t *line) {
+  line->length = 0;
+  line->text[0] = '\0';
+}
+
+bool line_buffer_add(line_buffer_t *line, char c, char *echo, uint32_t *echo_len) {
+  *echo_len = 0;
+
+  switch (c) {
+    case '\r':
+    case '\n':
+      // Ignore the second half of CR LF, and empty lines
+      if (line->length == 0) {
+        return false;
+      }
+      line->text[line->length] = '\0';
+      echo[0] = '\r';
+      echo[1] = '\n';
+      *echo_len = 2;
+      return true;
+    case '\b':
+    case 0x7F:
+      if (line->length > 0) {
+        line->length--;
+        echo[0] = '\b';
+        echo[1] = ' ';
+        echo[2] = '\b';
+        *echo_len = 3;
+      }
+      return false;
+    default:
+      // Leave room for the NUL, ignore control characters
+      if (c >= ' ' && c <= '~' && line->length < LINE_BUFFER_LEN - 1) {
+        line->text[line->length++] = c;
+        echo[0] = c;
+        *echo_len = 1;
+      }
+      return false;
+  }
+}
@@ -0,0 +1,91 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file loop_stats.cpp
+ * @author Cameron A. Craig
+ * @date 10 Feb 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Records timing of a periodic loop as histograms.
+ */
+
+#include <string.h>
+#include "loop_stats.h"
+
+void loop_stats_init(loop_stats_t *stats, uint32_t period_us) {
+  memset(stats, 0x00, sizeof(loop_stats_t));
+  stats->period_us = period_us;
+  stats->jitter.min_us = 0xFFFFFFFF;
+  stats->exec.min_us = 0xFFFFFFFF;
+  stats->latency.min_us = 0xFFFFFFFF;
+}
+
+void loop_stats_cycle_start(loop_stats_t *stats, uint32_t now_us) {
+  uint32_t period, jitter;
+
+  if (stats->reset_requested) {
+    loop_stats_init(stats, stats->period_us);
+  }
+
+  /* The first cycle has nothing to measure the period against. Unsigned
+     subtraction keeps the period correct when the microsecond timer wraps. */
+  if (stats->cycles > 0) {
+    period = now_us - stats->last_start_us;
+    jitter = (period > stats->period_us) ?
+      period - stats->period_us : stats->period_us - period;
+    timing_histogram_add(&stats->jitter, jitter);
+  }
+  stats->last_start_us = now_us;
+}
+
+void loop_stats_cycle_end(loop_stats_t *stats, uint32_t start_us, uint32_t now_us) {
+  uint32_t exec = now_us - start_us;
+
+  timing_histogram_add(&stats->exec, exec);
+  if (exec > stats->period_us) {
+    stats->overruns++;
+  }
+  stats->cycles++;
+}
+
+void loop_stats_latency(loop_stats_t *stats, uint32_t event_us, uint32_t now_us) {
+  timing_histogram_add(&stats->latency, now_us - event_us);
+}
+
+void timing_histogram_add(timing_histogram_t *hist, uint32_t value_us) {
+  uint32_t bin = value_us / LOOP_STATS_BIN_WIDTH_US;
+
+  if (bin >= LOOP_STATS_NUM_BINS) {
+    bin = LOOP_STATS_NUM_BINS - 1;
+  }
+  hist->bins[bin]++;
+
+  if (value_us < hist->min_us) {
+    hist->min_us = value_us;
+  }
+  if (value_us > hist->max_us) {
+    hist->max_us = value_us;
+  }
+  hist->total_us += value_us;
+  hist->samples++;
+}
+
+uint32_t timing_histogram_mean(const timing_histogram_t *hist) {
+  if (hist->samples == 0) {
+    return 0;
+  }
+  return (uint32_t) (hist->total_us / hist->samples);
+}
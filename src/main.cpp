@@ -38,7 +38,6 @@
 #include "mbed.h"
 #include "rtos.h"
 #include "esc.h"
-#include "PwmIn.h"
 #include "assert.h"
 
 #include "bno055.h"
@@ -53,17 +52,27 @@
 #include "drive_modes.h"
 #include "comms_pwm.h"
 #include "comms_vesc_can.h"
+#include "receiver.h"
+#include "failsafe.h"
+#include "console.h"
+#include "command_parser.h"
+#include "cpu_monitor.h"
 
 /* Make available the ESC comms implementations */
 extern comms_impl_t comms_impl_pwm;
 extern comms_impl_t comms_impl_vesc_can;
 
+/* Make available the receiver implementations */
+extern receiver_impl_t receiver_impl_pwm;
+extern receiver_impl_t receiver_impl_ppm;
+extern receiver_impl_t receiver_impl_sbus;
+
 // For memory debugging
 // #include "mbed_memory_status.h"
 
 /* Set up logging */
 LocalFileSystem local("local");
-Serial *serial_ptr;
+RawSerial *serial_ptr;
 
 int esp8266_wait_until_ready(thread_args_t *args) {
   unsigned esp8266_init_attempts = 0;
@@ -83,7 +92,7 @@ int esp8266_wait_until_ready(thread_args_t *args) {
 
 int bno055_wait_until_ready(thread_args_t *args) {
   unsigned bno055_init_attempts = 0;
-  while (!bno055_init()) {
+  while (!bno055_init(&args->i2c, &args->imu_config)) {
     bno055_init_attempts++;
     if(bno055_init_attempts > 5) {
       // Disable tasks that require the BNO055
@@ -101,8 +110,9 @@ int bno055_wait_until_ready(thread_args_t *args) {
  * Main Loop
  */
 int main() {
-  // Configure serial connection to a PC (for debug)
-  Serial *serial = new Serial(USBTX, USBRX);
+  // Configure serial connection to a PC (for debug). RawSerial can be used
+  // from the receive interrupt, see console.h
+  RawSerial *serial = new RawSerial(USBTX, USBRX);
   serial->baud(115200);
 
   // Initialise thread arguments structure
@@ -139,6 +149,7 @@ int main() {
   //Set baud rate for USB serial
   targs->serial = serial;
   serial_ptr = serial;
+  console_init(&targs->console, serial);
 
   //For memory debugging
   // print_all_thread_info();
@@ -151,6 +162,7 @@ int main() {
 
 #ifdef DEVICE_BNO055
   targs->serial->printf("init(): BNO055\r\n");
+  i2c_engine_init(&targs->i2c, I2C_SDA_PIN, I2C_SCL_PIN, I2C_FREQUENCY_HZ);
   if (!bno055_wait_until_ready(targs)){
     targs->serial->printf("\tBNO055 not in use.\r\n");
   };
@@ -163,10 +175,10 @@ int main() {
   }
 #endif
 
-  targs->serial->puts("init(): PWM inputs\r\n");
+  targs->serial->puts("init(): receiver inputs\r\n");
 
   /* RC inputs from two reveiver units */
-  PwmIn rx_drive[RC_NUMBER_CHANNELS] = {
+  const PinName rx_drive[RC_NUMBER_CHANNELS] = {
     RECV_D_CHAN_1_PIN,
     RECV_D_CHAN_2_PIN,
     RECV_D_CHAN_3_PIN,
@@ -175,7 +187,7 @@ int main() {
     RECV_D_CHAN_6_PIN
   };
 
-  PwmIn rx_weapon[RC_NUMBER_CHANNELS] = {
+  const PinName rx_weapon[RC_NUMBER_CHANNELS] = {
     RECV_W_CHAN_1_PIN,
     RECV_W_CHAN_2_PIN,
     RECV_W_CHAN_3_PIN,
@@ -223,19 +235,24 @@ int main() {
   targs->channel_limits[1][5].min = RC_1_CHAN_6_MIN;
   targs->channel_limits[1][5].max = RC_1_CHAN_6_MAX;
 
+  targs->receiver_impl[0] = (receiver_impl_t *) &RC_0_RECEIVER;
+  targs->receiver_impl[1] = (receiver_impl_t *) &RC_1_RECEIVER;
+  targs->serial->printf("\tinit(): RX 0 is %s, RX 1 is %s\r\n",
+    targs->receiver_impl[0]->str, targs->receiver_impl[1]->str);
+  targs->receiver_impl[0]->init(&targs->receiver[0], rx_weapon, RECV_W_SIGNAL_PIN);
+  targs->receiver_impl[1]->init(&targs->receiver[1], rx_drive, RECV_D_SIGNAL_PIN);
+
   uint32_t chan;
   for (chan= 0; chan < RC_NUMBER_CHANNELS; chan++) {
-    targs->receiver[0].channel[chan] = &rx_weapon[chan];
-    targs->receiver[1].channel[chan] = &rx_drive[chan];
-    // A test read ensures PwmIn is configured correctly
+    // A test read ensures capture is configured correctly
     targs->serial->printf("\tinit(): RX %d channel %d: %d\r\n",
       0, chan,
       convert_pulsewidth(
-        targs->receiver[0].channel[chan]->pulsewidth()));
+        rc_capture_pulsewidth(&targs->receiver[0], chan)));
     targs->serial->printf("\tinit(): RX %d channel %d: %d\r\n",
       1, chan,
       convert_pulsewidth(
-        targs->receiver[1].channel[chan]->pulsewidth()));
+        rc_capture_pulsewidth(&targs->receiver[1], chan)));
   }
 
   targs->serial->puts("init(): onboard LEDS\r\n");
@@ -274,22 +291,33 @@ int main() {
   targs->comms_impl->init_esc(&targs->escs.weapon[1], COMMS_OUTPUT_WEAPON_2);
   targs->comms_impl->init_esc(&targs->escs.weapon[2], COMMS_OUTPUT_WEAPON_1);
 
+  targs->serial->puts("init(): Failsafe\r\n");
+  failsafe_init(targs);
+
   targs->serial->puts("init(): Command Queue\r\n");
+  if (command_parser_init() != RET_OK) {
+    targs->serial->puts("\tNo perfect hash for command names.\r\n");
+  }
 
   Mail<command_t, COMMAND_QUEUE_LEN> *command_queue = new Mail<command_t, COMMAND_QUEUE_LEN>();
   targs->command_queue = command_queue;
 
   targs->serial->puts("init(): Mutexes\r\n");
   targs->mutex.pc_serial = new Mutex();
-  targs->mutex.controls = new Mutex();
-  targs->mutex.outputs = new Mutex();
-  targs->mutex.telemetry = new Mutex();
 
   targs->serial->printf("init(): Starting %d Tasks\r\n", NUM_TASKS);
 
   // Allow access to tasks from threads
   targs->tasks = (task_t *) &tasks;
 
+#ifdef TASK_CALC_ORIENTATION
+  // The orientation task runs once per BNO055 sample
+  targs->tasks[TASK_CALC_ORIENTATION_ID].period_us = 1000000 / bno055_data_rate_hz(&targs->imu_config);
+#endif
+
+  // Measure how much of the processor each task uses
+  cpu_monitor_init(targs->tasks, NUM_TASKS);
+
   Thread threads[NUM_TASKS] = {
 #ifdef TASK_READ_SERIAL
     {tasks[TASK_READ_SERIAL_ID].priority, tasks[TASK_READ_SERIAL_ID].stack_size},
@@ -306,9 +334,6 @@ int main() {
 #ifdef TASK_ARMING
     {tasks[TASK_ARMING_ID].priority, tasks[TASK_ARMING_ID].stack_size},
 #endif
-#ifdef TASK_FAILSAFE
-    {tasks[TASK_FAILSAFE_ID].priority, tasks[TASK_FAILSAFE_ID].stack_size},
-#endif
 #if defined(TASK_CALC_ORIENTATION) && defined(DEVICE_BNO055)
     {tasks[TASK_CALC_ORIENTATION_ID].priority, tasks[TASK_CALC_ORIENTATION_ID].stack_size},
 #endif
@@ -358,9 +383,6 @@ int main() {
 
 
   delete(targs->mutex.pc_serial);
-  delete(targs->mutex.controls);
-  delete(targs->mutex.outputs);
-  delete(targs->mutex.telemetry);
 
   delete(targs->esp_ready_pin);
   delete(targs->wdt);
@@ -0,0 +1,159 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file mixer.cpp
+ * @author Cameron A. Craig
+ * @date 17 Feb 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Generic drive mixer. Works in float or Q16.16 depending on
+ *        CONTROL_FIXED_POINT, each mix is a few multiply-adds per wheel.
+ */
+
+#include "mixer.h"
+#include "config.h"
+#include "types.h"
+#include "fixed.h"
+#include "tmath.h"
+
+#ifdef CONTROL_FIXED_POINT
+
+static inline control_t control_mul(control_t a, control_t b) {
+  return q16_mul(a, b);
+}
+
+static inline control_t control_abs(control_t a) {
+  return q16_abs(a);
+}
+
+/* Map -1..1 onto 0..100 */
+static inline int control_to_output(control_t w) {
+  return q16_to_int(Q16(50) + w * 50);
+}
+
+#else
+
+static inline control_t control_mul(control_t a, control_t b) {
+  return a * b;
+}
+
+static inline control_t control_abs(control_t a) {
+  return a < 0 ? -a : a;
+}
+
+/* Map -1..1 onto 0..100 */
+static inline int control_to_output(control_t w) {
+  return (int)(50.0f + w * 50.0f + 0.5f);
+}
+
+#endif  // CONTROL_FIXED_POINT
+
+/* Centre a channel value and scale it to -1..1 */
+static control_t stick_value(rc_channel_t channel) {
+  control_t value = (channel - RC_CHANNEL(50)) / 50;
+
+  if (control_abs(value) < CONTROL(DRIVE_STICK_DEADBAND)) {
+    return 0;
+  }
+  return value;
+}
+
+void mixer_read_sticks(const drive_mode_t *mode, const rc_frame_t *frame, struct direction_vector_t *sticks) {
+  const rc_controls_t *drive_rc = &frame->controller[1];
+
+  sticks->y_translation = stick_value(drive_rc->channel[mode->channel[MIX_THROTTLE]]);
+  sticks->x_translation = stick_value(drive_rc->channel[mode->channel[MIX_STRAFE]]);
+  sticks->rotation = stick_value(drive_rc->channel[mode->channel[MIX_ROTATE]]);
+}
+
+void mixer_invert(const drive_mode_t *mode, struct direction_vector_t *sticks) {
+  sticks->y_translation = control_mul(mode->inverted[MIX_THROTTLE], sticks->y_translation);
+  sticks->x_translation = control_mul(mode->inverted[MIX_STRAFE], sticks->x_translation);
+  sticks->rotation = control_mul(mode->inverted[MIX_ROTATE], sticks->rotation);
+}
+
+void mixer_mix(const drive_mode_t *mode, const struct direction_vector_t *sticks, struct rc_outputs_t *outputs) {
+  control_t w[MAX_DRIVE_WHEELS];
+  control_t peak = CONTROL(1.0);
+  int i;
+
+  for (i = 0; i < mode->wheels; i++) {
+    w[i] = control_mul(mode->mix[i][MIX_THROTTLE], sticks->y_translation)
+         + control_mul(mode->mix[i][MIX_STRAFE], sticks->x_translation)
+         + control_mul(mode->mix[i][MIX_ROTATE], sticks->rotation);
+
+    if (control_abs(w[i]) > peak) {
+      peak = control_abs(w[i]);
+    }
+  }
+
+  /* Scale every wheel by the same amount so none saturates */
+  if (peak > CONTROL(1.0)) {
+#ifdef CONTROL_FIXED_POINT
+    control_t scale = q16_div(Q16_ONE, peak);
+#else
+    control_t scale = 1.0f / peak;
+#endif
+    for (i = 0; i < mode->wheels; i++) {
+      w[i] = control_mul(w[i], scale);
+    }
+  }
+
+  for (i = 0; i < mode->wheels; i++) {
+    outputs->wheel[i] = control_to_output(w[i]);
+  }
+  for (; i < MAX_DRIVE_WHEELS; i++) {
+    outputs->wheel[i] = 50;
+  }
+}
+
+void mixer_drive(const drive_mode_t *mode, const rc_frame_t *frame, struct rc_outputs_t *outputs) {
+  struct direction_vector_t sticks;
+
+  mixer_read_sticks(mode, frame, &sticks);
+  mixer_mix(mode, &sticks, outputs);
+}
+
+void mixer_clamp(struct rc_outputs_t *outputs) {
+  int i;
+
+  for (i = 0; i < MAX_DRIVE_WHEELS; i++) {
+    outputs->wheel[i] = clamp(outputs->wheel[i], 0, 100);
+  }
+  outputs->weapon_motor_1 = clamp(outputs->weapon_motor_1, 0, 100);
+  outputs->weapon_motor_2 = clamp(outputs->weapon_motor_2, 0, 100);
+  outputs->weapon_motor_3 = clamp(outputs->weapon_motor_3, 0, 100);
+}
+
+bool control_cycle(const drive_mode_t *drive_mode, const weapon_mode_t *weapon_mode,
+  const rc_frame_t *frame, bool heading_lock, control_t heading_rotation, bool inverted,
+  struct rc_outputs_t *outputs) {
+  struct direction_vector_t sticks;
+  bool turning;
+
+  mixer_read_sticks(drive_mode, frame, &sticks);
+  turning = (sticks.rotation != 0);
+  if (heading_lock && !turning) {
+    sticks.rotation = heading_rotation;
+  }
+  if (inverted) {
+    mixer_invert(drive_mode, &sticks);
+  }
+  mixer_mix(drive_mode, &sticks, outputs);
+  weapon_mode->weapon(frame, outputs);
+  mixer_clamp(outputs);
+  return turning;
+}
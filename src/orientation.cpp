@@ -0,0 +1,61 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * @file orientation.cpp
+ * @author Cameron A. Craig
+ * @date 17 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Decides whether the robot is upright or inverted from its roll.
+ */
+
+#include "orientation.h"
+#include "config.h"
+
+void orientation_detector_init(orientation_detector_t *detector) {
+  detector->orientation = UPRIGHT;
+  detector->disagree = 0;
+}
+
+bool orientation_detect(orientation_detector_t *detector, float roll) {
+  float offset = roll - ORIENTATION_INVERTED_ROLL;
+  bool disagree;
+
+  if (offset < 0) {
+    offset = -offset;
+  }
+  // The leave band is wider than the enter band, so a roll near either
+  // edge does not flip the controls back and forth.
+  if (detector->orientation == UPRIGHT) {
+    disagree = (offset < ORIENTATION_ENTER_DEG);
+  } else {
+    disagree = (offset > ORIENTATION_LEAVE_DEG);
+  }
+
+  if (!disagree) {
+    detector->disagree = 0;
+    return false;
+  }
+  if (++detector->disagree < ORIENTATION_SETTLE_SAMPLES) {
+    return false;
+  }
+  detector->orientation = (detector->orientation == UPRIGHT) ? INVERTED : UPRIGHT;
+  detector->disagree = 0;
+  return true;
+}
+
+orientation_t orientation_effective(orientation_t detected, orientation_t override) {
+  return (override == ORIENTATION_AUTO) ? detected : override;
+}
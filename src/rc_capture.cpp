@@ -0,0 +1,116 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file rc_capture.cpp
+ * @author Cameron A. Craig
+ * @date 24 Feb 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Buffers pulses captured from a receiver, and detects complete frames.
+ */
+
+#include <string.h>
+#include "rc_capture.h"
+#include "rc_input.h"
+
+/* Bit set in rc_capture_t::fresh once every channel has a new pulse */
+#define RC_CAPTURE_ALL_CHANNELS ((1U << RC_NUMBER_CHANNELS) - 1)
+
+void rc_capture_init(rc_capture_t *capture) {
+  int i;
+
+  for (i = 0; i < RC_NUMBER_CHANNELS; i++) {
+    capture->channel[i].capture = capture;
+    capture->channel[i].index = i;
+  }
+  memset(&capture->decoder, 0x00, sizeof(capture->decoder));
+}
+
+/* Receiver interrupts all run at the same priority, so they never preempt
+   each other and each ring has a single producer. */
+void rc_capture_pulse(rc_capture_t *capture, uint32_t channel, uint32_t width_us, uint64_t now_us) {
+  rc_pulse_t pulse;
+
+  // A falling edge without a matching rising edge, e.g. at start up
+  if (channel >= RC_NUMBER_CHANNELS || width_us > RC_PULSE_MAX_US) {
+    return;
+  }
+
+  capture->channel[channel].width_us = width_us;
+
+  pulse.timestamp_us = (uint32_t) now_us;
+  pulse.width_us = (uint16_t) width_us;
+  pulse.channel = (uint8_t) channel;
+  capture->pulses.push(pulse);
+
+  // The loop sees every width, but only one in range shows the receiver is
+  // still working. Otherwise its deadline and stall check run out.
+  if (!rc_input_pulse_valid(width_us)) {
+    return;
+  }
+  capture->channel[channel].valid_us = now_us;
+  capture->fresh |= (1U << channel);
+  if (capture->fresh == RC_CAPTURE_ALL_CHANNELS) {
+    capture->fresh = 0;
+    capture->frames++;
+    capture->frame_us = now_us;
+    if (capture->frame_hook != NULL) {
+      capture->frame_hook(capture->frame_context);
+    }
+    if (capture->notify != NULL) {
+      capture->notify->signal_set(capture->signal);
+    }
+  }
+}
+
+void rc_capture_notify(rc_capture_t *capture, Thread *thread, int32_t signal) {
+  capture->signal = signal;
+  capture->notify = thread;
+}
+
+void rc_capture_on_frame(rc_capture_t *capture, void (*hook)(void *context), void *context) {
+  capture->frame_hook = NULL;
+  capture->frame_context = context;
+  capture->frame_hook = hook;
+}
+
+float rc_capture_pulsewidth(const rc_capture_t *capture, int channel) {
+  return (float) capture->channel[channel].width_us;
+}
+
+uint32_t rc_capture_age_us(const rc_capture_t *capture, int channel) {
+  uint64_t valid = clock_read_stamp(&capture->channel[channel].valid_us);
+  uint64_t age;
+
+  if (valid == 0) {
+    return 0xFFFFFFFF;
+  }
+  age = clock_now_us() - valid;
+  return (age > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t) age;
+}
+
+uint32_t rc_capture_max_age_us(const rc_capture_t *capture) {
+  uint32_t age, max_age = 0;
+  int i;
+
+  for (i = 0; i < RC_NUMBER_CHANNELS; i++) {
+    age = rc_capture_age_us(capture, i);
+    if (age > max_age) {
+      max_age = age;
+    }
+  }
+  return max_age;
+}
@@ -0,0 +1,208 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file rc_input.cpp
+ * @author Cameron A. Craig
+ * @date 10 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Filters raw receiver pulse widths and converts them into channel
+ *        values.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "rc_input.h"
+#include "tmath.h"
+#include "fixed.h"
+
+#ifdef CONTROL_FIXED_POINT
+/**
+* @brief Convert a pulse width into a channel value between 0 and 100.
+* @param [in] pulsewidth Pulse width read from the receiver.
+* @param [in] limits Calibrated limits of the channel.
+* @details Uses only integer arithmetic; the M3 has a hardware divider.
+*/
+static rc_channel_t pulsewidth_to_channel(float pulsewidth, const channel_limits_t *limits) {
+  int32_t pw = (int32_t) pulsewidth;
+  int32_t min = (int32_t) limits->min;
+  int32_t max = (int32_t) limits->max;
+
+  // Limits are inverted while channels are being calibrated
+  if (max <= min) {
+    return 0;
+  }
+
+  // Make sure pw doesn't leave bounds due to imperfect calibration
+  pw = (pw < min) ? min : ((pw > max) ? max : pw);
+
+  // Fraction of the range in Q16.16, then scaled to 0 -> 100
+  return (((pw - min) << Q16_SHIFT) / (max - min)) * 100;
+}
+#else
+/**
+* @brief Convert a pulse width into a channel value between 0 and 100.
+* @param [in] pulsewidth Pulse width read from the receiver.
+* @param [in] limits Calibrated limits of the channel.
+*/
+static rc_channel_t pulsewidth_to_channel(float pulsewidth, const channel_limits_t *limits) {
+  float min = limits->min;
+  float max = limits->max;
+
+  // Make sure pw doesn't leave bounds due to imperfect calibration
+  float pw = clamp(pulsewidth, min, max);
+
+  // Convert into float value between 0 and 100, based on max and min
+  return ( (pw - min) / (max - min) ) * 100.0f;
+}
+#endif
+
+static uint16_t median_of_3(uint16_t a, uint16_t b, uint16_t c) {
+  uint16_t tmp;
+
+  // Order a and b, then the median is the larger of a and min(b, c)
+  if (a > b) {
+    tmp = a;
+    a = b;
+    b = tmp;
+  }
+  if (b > c) {
+    b = c;
+  }
+  return (a > b) ? a : b;
+}
+
+/**
+* @brief Check whether a step can skip the step filter. Arm switches jump
+*        by design, and a throttle closing is always safe to follow at once.
+* @param [in] controller Controller index.
+* @param [in] channel Channel index.
+* @param [in] from_us Last accepted width (microseconds).
+* @param [in] to_us New width (microseconds).
+* @return true if the step is passed on without waiting.
+*/
+static bool step_is_safe(int controller, int channel, int32_t from_us, int32_t to_us) {
+  static const int arm_switch[RC_NUMBER_CONTROLLERS] = {RC_0_ARM_SWITCH, RC_1_ARM_SWITCH};
+  static const int throttle[RC_NUMBER_CONTROLLERS] = {RC_0_THROTTLE, RC_1_THROTTLE};
+
+  if (channel == arm_switch[controller]) {
+    return true;
+  }
+  return channel == throttle[controller] && to_us < from_us;
+}
+
+bool rc_input_pulse_valid(uint32_t width_us) {
+  return BETWEEN(width_us, RC_FILTER_MIN_US, RC_FILTER_MAX_US);
+}
+
+void input_filter_init(input_filter_t *filter, uint32_t stages) {
+  memset(filter, 0x00, sizeof(input_filter_t));
+  filter->stages = stages;
+}
+
+/* Each stage is a few integer operations per channel, and only channels
+   with a new width are visited. */
+void input_filter_run(input_filter_t *filter, rc_raw_frame_t *raw) {
+  int controller, channel;
+  uint32_t bit;
+  int32_t width;
+  bool seed;
+  rc_filter_channel_t *f;
+
+  for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
+    for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
+      bit = 1U << channel;
+      if (!(raw->fresh[controller] & bit)) {
+        continue;
+      }
+      f = &filter->channel[controller][channel];
+      width = raw->width_us[controller][channel];
+
+      if ((filter->stages & RC_FILTER_RANGE) && !rc_input_pulse_valid(width)) {
+        f->rejected++;
+        raw->fresh[controller] &= ~bit;
+        continue;
+      }
+
+      // A glitch lasts one frame and a real step persists, so hold the first
+      // width of a step and pass it on once the next width confirms it
+      seed = false;
+      if ((filter->stages & RC_FILTER_STEP) && f->samples > 0 &&
+          abs(width - f->history[0]) > RC_FILTER_MAX_STEP_US) {
+        if (!step_is_safe(controller, channel, f->history[0], width) &&
+            (f->step_us == 0 || abs(width - f->step_us) > RC_FILTER_MAX_STEP_US)) {
+          f->step_us = (uint16_t) width;
+          f->rejected++;
+          raw->fresh[controller] &= ~bit;
+          continue;
+        }
+        // Start the median again at the new width, rather than holding it
+        // back for another frame
+        seed = true;
+      }
+      f->step_us = 0;
+
+      if (seed) {
+        f->history[0] = f->history[1] = f->history[2] = (uint16_t) width;
+        f->samples = 3;
+      } else {
+        f->history[2] = f->history[1];
+        f->history[1] = f->history[0];
+        f->history[0] = (uint16_t) width;
+        if (f->samples < 3) {
+          f->samples++;
+        }
+      }
+
+      if ((filter->stages & RC_FILTER_MEDIAN) && f->samples == 3) {
+        width = median_of_3(f->history[0], f->history[1], f->history[2]);
+      }
+
+      if (filter->stages & RC_FILTER_IIR) {
+        if (f->samples == 1) {
+          f->iir = width << 4;
+        } else {
+          f->iir += ((width << 4) - f->iir) >> RC_FILTER_IIR_SHIFT;
+        }
+        width = (f->iir + 8) >> 4;
+      }
+
+      raw->width_us[controller][channel] = (uint16_t) width;
+    }
+  }
+}
+
+void rc_input_to_controls(const rc_raw_frame_t *raw,
+  const channel_limits_t limits[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS], rc_frame_t *frame) {
+  int controller, channel;
+
+  for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
+    for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
+      if (raw->fresh[controller] & (1U << channel)) {
+        frame->controller[controller].channel[channel] =
+          pulsewidth_to_channel(raw->width_us[controller][channel], &limits[controller][channel]);
+      }
+    }
+  }
+}
+
+void rc_input_update(input_filter_t *filter, const rc_raw_frame_t *pulses,
+  const channel_limits_t limits[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS], rc_frame_t *frame) {
+  rc_raw_frame_t raw = *pulses;
+
+  input_filter_run(filter, &raw);
+  rc_input_to_controls(&raw, limits, frame);
+}
@@ -0,0 +1,91 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file receiver_decode.cpp
+ * @author Cameron A. Craig
+ * @date 3 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Decoders for single wire receiver protocols.
+ */
+
+#include "receiver_decode.h"
+
+int ppm_decode_edge(ppm_decoder_t *ppm, uint32_t now_us, uint32_t *width_us) {
+  uint32_t interval = now_us - ppm->edge_us;
+  ppm->edge_us = now_us;
+
+  if (!ppm->started) {
+    ppm->started = true;
+    return -1;
+  }
+
+  if (interval >= PPM_SYNC_MIN_US) {
+    ppm->next_channel = 0;
+    ppm->synced = true;
+    return -1;
+  }
+
+  // Channels seen before the first sync gap can't be numbered
+  if (!ppm->synced) {
+    return -1;
+  }
+
+  *width_us = interval;
+  return (int) ppm->next_channel++;
+}
+
+bool sbus_decode_byte(sbus_decoder_t *sbus, uint8_t byte, uint32_t now_us) {
+  if (now_us - sbus->byte_us > SBUS_BYTE_GAP_US) {
+    sbus->length = 0;
+  }
+  sbus->byte_us = now_us;
+
+  // Wait for the header of the next frame
+  if (sbus->length == 0 && byte != SBUS_HEADER) {
+    return false;
+  }
+
+  sbus->frame[sbus->length++] = byte;
+  if (sbus->length < SBUS_FRAME_LEN) {
+    return false;
+  }
+  sbus->length = 0;
+
+  // SBUS ends frames with 0x00, SBUS2 with 0x04, 0x14, 0x24 or 0x34
+  return (byte == 0x00) || ((byte & 0x0F) == 0x04);
+}
+
+bool sbus_frame_channels(const uint8_t *frame, uint16_t *width_us, int channels) {
+  int i;
+  uint32_t bit, byte, value;
+
+  if (frame[SBUS_FRAME_LEN - 2] & SBUS_FLAG_FAILSAFE) {
+    return false;
+  }
+
+  // Channels are packed least significant bit first after the header
+  for (i = 0; i < channels && i < SBUS_NUM_CHANNELS; i++) {
+    bit = 11 * i;
+    byte = 1 + (bit / 8);
+    value = frame[byte] | (frame[byte + 1] << 8) | (frame[byte + 2] << 16);
+    value = (value >> (bit % 8)) & 0x7FF;
+
+    // 172 -> 1811 maps onto 988us -> 2012us
+    width_us[i] = (uint16_t) (880 + ((value * 5) / 8));
+  }
+  return true;
+}
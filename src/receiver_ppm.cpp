@@ -0,0 +1,54 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file receiver_ppm.cpp
+ * @author Cameron A. Craig
+ * @date 3 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Receiver with a PPM sum signal, one edge interrupt per channel.
+ */
+
+#include "mbed.h"
+#include "receiver.h"
+#include "receiver_ppm.h"
+#include "receiver_decode.h"
+#include "config.h"
+
+volatile receiver_impl_t receiver_impl_ppm = {
+  .impl_id = RECEIVER_IMPL_PPM,
+  .str = "PPM",
+  .init = receiver_impl_ppm_init
+};
+
+static void receiver_impl_ppm_edge(rc_capture_t *capture) {
+  uint64_t now = clock_now_us();
+  uint32_t width;
+  int channel = ppm_decode_edge(&capture->decoder.ppm, (uint32_t) now, &width);
+
+  // Receivers may send more channels than we use, rc_capture_pulse drops them
+  if (channel >= 0) {
+    rc_capture_pulse(capture, channel, width, now);
+  }
+}
+
+void receiver_impl_ppm_init(rc_capture_t *capture, const PinName *channel_pins, PinName signal_pin) {
+  InterruptIn *pin = new InterruptIn(signal_pin);
+
+  rc_capture_init(capture);
+  capture->device = pin;
+  pin->rise(callback(receiver_impl_ppm_edge, capture));
+}
@@ -0,0 +1,55 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file receiver_pwm.cpp
+ * @author Cameron A. Craig
+ * @date 3 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Receiver with a PWM signal per channel, each pulse costs two edge
+ *        interrupts.
+ */
+
+#include "mbed.h"
+#include "receiver.h"
+#include "receiver_pwm.h"
+#include "config.h"
+
+volatile receiver_impl_t receiver_impl_pwm = {
+  .impl_id = RECEIVER_IMPL_PWM,
+  .str = "PWM",
+  .init = receiver_impl_pwm_init
+};
+
+static void receiver_impl_pwm_rise(rc_capture_channel_t *channel) {
+  channel->rise_us = (uint32_t) clock_now_us();
+}
+
+static void receiver_impl_pwm_fall(rc_capture_channel_t *channel) {
+  uint64_t now = clock_now_us();
+  rc_capture_pulse(channel->capture, channel->index, (uint32_t) now - channel->rise_us, now);
+}
+
+void receiver_impl_pwm_init(rc_capture_t *capture, const PinName *channel_pins, PinName signal_pin) {
+  int i;
+
+  rc_capture_init(capture);
+  for (i = 0; i < RC_NUMBER_CHANNELS; i++) {
+    capture->channel[i].pin = new InterruptIn(channel_pins[i]);
+    capture->channel[i].pin->rise(callback(receiver_impl_pwm_rise, &capture->channel[i]));
+    capture->channel[i].pin->fall(callback(receiver_impl_pwm_fall, &capture->channel[i]));
+  }
+}
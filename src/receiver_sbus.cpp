@@ -0,0 +1,66 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file receiver_sbus.cpp
+ * @author Cameron A. Craig
+ * @date 3 Mar 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Receiver with an SBUS serial output, 100000 baud 8E2.
+ */
+
+#include "mbed.h"
+#include "receiver.h"
+#include "receiver_sbus.h"
+#include "receiver_decode.h"
+#include "config.h"
+
+#define SBUS_BAUD 100000
+
+volatile receiver_impl_t receiver_impl_sbus = {
+  .impl_id = RECEIVER_IMPL_SBUS,
+  .str = "SBUS",
+  .init = receiver_impl_sbus_init
+};
+
+static void receiver_impl_sbus_rx(rc_capture_t *capture) {
+  RawSerial *serial = (RawSerial *) capture->device;
+  uint16_t width_us[RC_NUMBER_CHANNELS];
+  uint64_t now;
+  int i;
+
+  while (serial->readable()) {
+    now = clock_now_us();
+    if (!sbus_decode_byte(&capture->decoder.sbus, (uint8_t) serial->getc(), (uint32_t) now)) {
+      continue;
+    }
+    // Leave channels stale during failsafe, so the stall checks see it
+    if (sbus_frame_channels(capture->decoder.sbus.frame, width_us, RC_NUMBER_CHANNELS)) {
+      for (i = 0; i < RC_NUMBER_CHANNELS; i++) {
+        rc_capture_pulse(capture, i, width_us[i], now);
+      }
+    }
+  }
+}
+
+void receiver_impl_sbus_init(rc_capture_t *capture, const PinName *channel_pins, PinName signal_pin) {
+  RawSerial *serial = new RawSerial(NC, signal_pin, SBUS_BAUD);
+
+  rc_capture_init(capture);
+  capture->device = serial;
+  serial->format(8, SerialBase::Even, 2);
+  serial->attach(callback(receiver_impl_sbus_rx, capture), SerialBase::RxIrq);
+}
@@ -0,0 +1,191 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ * @file replay.cpp
+ * @author Cameron A. Craig
+ * @date 19 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Runs recorded receiver input back through the control pipeline in
+ *        virtual time. Each step calls the same functions as the tasks it
+ *        stands in for.
+ */
+
+#include <string.h>
+#include "replay.h"
+#include "mixer.h"
+
+#define ALL_CHANNELS ((1U << RC_NUMBER_CHANNELS) - 1)
+
+void replay_init(replay_t *replay,
+  const channel_limits_t limits[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS],
+  const drive_mode_t *drive_mode, const weapon_mode_t *weapon_mode, uint32_t filter_stages) {
+  memset(replay, 0x00, sizeof(replay_t));
+  replay->limits = limits;
+  replay->drive_mode = drive_mode;
+  replay->weapon_mode = weapon_mode;
+  input_filter_init(&replay->filter, filter_stages);
+  replay->stats.first_mismatch = -1;
+}
+
+/* Start from what the robot had at the first record of the trace */
+static void replay_start(replay_t *replay, const blackbox_record_t *record) {
+  int controller, channel;
+
+  replay->state = (state_t) record->state;
+  replay->recorded_state = replay->state;
+  memcpy(replay->frame.controller, record->controls, sizeof(replay->frame.controller));
+  for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
+    for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
+      replay->pulse_us[controller][channel] = record->time_us;
+    }
+    replay->frame_us[controller] = record->time_us;
+    replay->deadline[controller] = true;
+  }
+}
+
+/* Stands in for the receiver interrupts and failsafe.cpp */
+static void replay_receivers(replay_t *replay, const blackbox_record_t *record, rc_raw_frame_t *pulses) {
+  uint32_t now = record->time_us;
+  uint32_t valid;
+  int controller, channel;
+
+  for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
+    // A deadline that expired since the last cycle lowered the state first.
+    // Records are stamped after the frame that released the cycle, so one
+    // exactly RC_STALL_TIMEOUT_US after a frame comes after its deadline.
+    if (replay->deadline[controller] && now - replay->frame_us[controller] >= RC_STALL_TIMEOUT_US) {
+      replay->state = state_failsafe(replay->state, controller);
+      replay->deadline[controller] = false;
+    }
+
+    // As in rc_capture_pulse(), only widths in range complete a frame
+    pulses->fresh[controller] = (record->fresh >> (controller * RC_NUMBER_CHANNELS)) & ALL_CHANNELS;
+    valid = 0;
+    for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
+      pulses->width_us[controller][channel] = record->width_us[controller][channel];
+      if ((pulses->fresh[controller] & (1U << channel)) &&
+          rc_input_pulse_valid(pulses->width_us[controller][channel])) {
+        replay->pulse_us[controller][channel] = now;
+        valid |= (1U << channel);
+      }
+    }
+
+    replay->frame_fresh[controller] |= valid;
+    if (replay->frame_fresh[controller] == ALL_CHANNELS) {
+      replay->frame_fresh[controller] = 0;
+      replay->frame_us[controller] = now;
+      replay->deadline[controller] = true;
+    }
+  }
+}
+
+static bool replay_stalled(const replay_t *replay, int controller, uint32_t now) {
+  int channel;
+
+  for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
+    if (now - replay->pulse_us[controller][channel] > RC_STALL_TIMEOUT_US) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/* Stands in for task_arming */
+static void replay_arming(replay_t *replay, const blackbox_record_t *record) {
+  uint32_t now = record->time_us;
+
+  // The arming task runs on its own, so its phase is only known once it is
+  // seen to change the state. Until then the recorded state is kept.
+  if (!replay->arm_synced && record->state != replay->recorded_state &&
+      record->state != replay->state) {
+    replay->arm_us = now;
+    replay->arm_synced = true;
+  }
+  if (replay->arm_synced && (int32_t) (now - replay->arm_us) >= 0) {
+    // It sees the channel values published by the previous cycle
+    replay->state = state_arm(replay->state, &replay->frame,
+      replay_stalled(replay, 1, now), replay_stalled(replay, 0, now));
+    replay->arm_us += ARMING_PERIOD_MS * 1000;
+  }
+}
+
+bool replay_cycle(replay_t *replay, const blackbox_record_t *record, blackbox_record_t *result) {
+  replay_stats_t *stats = &replay->stats;
+  blackbox_record_t out;
+  rc_raw_frame_t pulses;
+  struct rc_outputs_t outputs;
+  bool heading_lock = (record->flags & BLACKBOX_FLAG_HEADING_LOCK) != 0;
+  bool controls_match, outputs_match, state_match;
+  int i;
+
+  if (stats->cycles == 0) {
+    replay_start(replay, record);
+  }
+
+  replay_receivers(replay, record, &pulses);
+  replay_arming(replay, record);
+
+  // The motor drive loop, as in task_motor_drive, starting with failsafe_poll
+  for (i = 0; i < RC_NUMBER_CONTROLLERS; i++) {
+    if (replay_stalled(replay, i, record->time_us)) {
+      replay->state = state_failsafe(replay->state, i);
+    }
+  }
+  rc_input_update(&replay->filter, &pulses, replay->limits, &replay->frame);
+  // The heading correction is not recorded, so it is taken as zero and the
+  // wheels of cycles with the lock on are not compared
+  control_cycle(replay->drive_mode, replay->weapon_mode, &replay->frame, heading_lock, 0,
+    (record->flags & BLACKBOX_FLAG_INVERTED) != 0, &outputs);
+
+  out = *record;
+  memcpy(out.controls, replay->frame.controller, sizeof(out.controls));
+  for (i = 0; i < MAX_DRIVE_WHEELS; i++) {
+    out.wheel[i] = (uint8_t) outputs.wheel[i];
+  }
+  out.weapon[0] = (uint8_t) outputs.weapon_motor_1;
+  out.weapon[1] = (uint8_t) outputs.weapon_motor_2;
+  out.weapon[2] = (uint8_t) outputs.weapon_motor_3;
+  out.state = (uint8_t) replay->state;
+  if (result != NULL) {
+    *result = out;
+  }
+
+  replay->recorded_state = (state_t) record->state;
+  if (stats->cycles++ < REPLAY_SETTLE_CYCLES) {
+    return true;
+  }
+  stats->compared++;
+
+  // The heading lock replaces the rotate axis with a correction from the
+  // orientation task, which is not recorded
+  controls_match = (memcmp(out.controls, record->controls, sizeof(out.controls)) == 0);
+  outputs_match = (memcmp(out.weapon, record->weapon, sizeof(out.weapon)) == 0) &&
+    (heading_lock || memcmp(out.wheel, record->wheel, sizeof(out.wheel)) == 0);
+  state_match = (out.state == record->state);
+
+  stats->control_mismatches += controls_match ? 0 : 1;
+  stats->output_mismatches += outputs_match ? 0 : 1;
+  stats->state_mismatches += state_match ? 0 : 1;
+  stats->unverified += heading_lock ? 1 : 0;
+
+  if (controls_match && outputs_match && state_match) {
+    return true;
+  }
+  if (stats->first_mismatch < 0) {
+    stats->first_mismatch = stats->cycles - 1;
+  }
+  return false;
+}
@@ -23,6 +23,8 @@
  */
 
 #include "states.h"
+#include "config.h"
+#include "tmath.h"
 
 const char * state_to_str(state_t state) {
   switch (state) {
@@ -38,3 +40,79 @@ const char * state_to_str(state_t state) {
       return "INVALID_STATE";
   }
 }
+
+state_t state_arm(state_t state, const rc_frame_t *frame, bool drive_stalled, bool weapon_stalled) {
+  const rc_controls_t *weapon_rc = &frame->controller[0];
+  const rc_controls_t *drive_rc = &frame->controller[1];
+  bool drive_switch, weapon_switch, drive_arm, weapon_arm;
+
+  // A stalled receiver's channels are stale, so its switch counts as off
+  weapon_switch = !weapon_stalled &&
+    (weapon_rc->channel[RC_0_ARM_SWITCH] > RC_CHANNEL(RC_SWITCH_MIDPOINT));
+  drive_switch = !drive_stalled &&
+    (drive_rc->channel[RC_1_ARM_SWITCH] > RC_CHANNEL(RC_SWITCH_MIDPOINT));
+
+  weapon_arm = weapon_switch &&
+    BETWEEN(weapon_rc->channel[RC_0_THROTTLE], RC_CHANNEL(0), RC_CHANNEL(2)) &&
+    BETWEEN(weapon_rc->channel[RC_0_ELEVATION], RC_CHANNEL(45), RC_CHANNEL(55)) &&
+    BETWEEN(weapon_rc->channel[RC_0_RUDDER], RC_CHANNEL(45), RC_CHANNEL(55)) &&
+    BETWEEN(weapon_rc->channel[RC_0_AILERON], RC_CHANNEL(45), RC_CHANNEL(55));
+
+  drive_arm = drive_switch &&
+    BETWEEN(drive_rc->channel[RC_1_THROTTLE], RC_CHANNEL(0), RC_CHANNEL(2)) &&
+    BETWEEN(drive_rc->channel[RC_1_ELEVATION], RC_CHANNEL(45), RC_CHANNEL(55)) &&
+    BETWEEN(drive_rc->channel[RC_1_RUDDER], RC_CHANNEL(45), RC_CHANNEL(55)) &&
+    BETWEEN(drive_rc->channel[RC_1_AILERON], RC_CHANNEL(45), RC_CHANNEL(55));
+
+  switch (state) {
+    /* From the fully armed state we can only decrease the arm state,
+    so we don't need to be concerned with the stick positions. */
+    case STATE_FULLY_ARMED:
+      if (!drive_switch && !weapon_switch) {
+        return STATE_DISARMED;
+      } else if (drive_switch && !weapon_switch) {
+        return STATE_DRIVE_ONLY;
+      } else if (!drive_switch && weapon_switch) {
+        return STATE_WEAPON_ONLY;
+      }
+      break;
+    case STATE_DRIVE_ONLY:
+      if (!drive_switch) {
+        return STATE_DISARMED;
+      } else if (weapon_arm) {
+        return STATE_FULLY_ARMED;
+      }
+      break;
+    case STATE_WEAPON_ONLY:
+      if (!weapon_switch) {
+        return STATE_DISARMED;
+      } else if (drive_arm) {
+        return STATE_FULLY_ARMED;
+      }
+      break;
+    case STATE_DISARMED:
+      if (drive_arm && weapon_arm) {
+        return STATE_FULLY_ARMED;
+      } else if (drive_arm) {
+        return STATE_DRIVE_ONLY;
+      } else if (weapon_arm) {
+        return STATE_WEAPON_ONLY;
+      }
+      break;
+  }
+  return state;
+}
+
+state_t state_failsafe(state_t state, int controller) {
+  // Controller 0 is the weapon, controller 1 the drive
+  switch (state) {
+    case STATE_FULLY_ARMED:
+      return (controller == 0) ? STATE_DRIVE_ONLY : STATE_WEAPON_ONLY;
+    case STATE_DRIVE_ONLY:
+      return (controller == 0) ? state : STATE_DISARMED;
+    case STATE_WEAPON_ONLY:
+      return (controller == 0) ? STATE_DISARMED : state;
+    default:
+      return state;
+  }
+}
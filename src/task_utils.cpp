@@ -25,83 +25,92 @@
 #include "thread_args.h"
 #include "tmath.h"
 #include "comms.h"
+#include "rc_input.h"
+#include "mixer.h"
+#include "cpu_monitor.h"
 
-void read_recv_pw(thread_args_t *args) {
-  int controller, channel;
-  float pw, v, min, max;
+void read_recv_pw(thread_args_t *args, rc_frame_t *frame) {
+  int controller;
+  rc_pulse_t pulse;
 
   for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
-    for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
-      // Read raw pulse width
-      pw = args->receiver[controller].channel[channel]->pulsewidth();
+    // Only channels with new pulses since the last cycle need converting,
+    // if a channel has several only the newest is used
+    args->raw_pulses.fresh[controller] = 0;
+    while (args->receiver[controller].pulses.pop(&pulse)) {
+      args->raw_pulses.width_us[controller][pulse.channel] = pulse.width_us;
+      args->raw_pulses.fresh[controller] |= (1U << pulse.channel);
+    }
+  }
 
-      // Get min and max pulsewidths fot this channel
-      min = args->channel_limits[controller][channel].min;
-      max = args->channel_limits[controller][channel].max;
+  // The widths are kept as received for the flight recorder
+  rc_input_update(&args->input_filter, &args->raw_pulses, args->channel_limits, frame);
+
+  // Make the whole frame available to other threads in one step
+  args->controls.publish(*frame);
+}
 
-      // Make sure pw doesn't leave bounds due to imperfect calibration
-      pw = clamp(pw, min, max);
+void set_output_escs(thread_args_t *args, struct rc_outputs_t *outputs) {
+  /* No matter what drive mode we use, ensure outputs
+     are within the valid range. */
+  mixer_clamp(outputs);
+  args->outputs.publish(*outputs);
 
-      // Convert into float value between 0 and 100, based on max and min
-      v = ( (pw - min) / (max - min) ) * 100.0f;
+  /* Now that we have valid output parameters, we can set the ESCs. */
+  switch (args->state) {
+    case STATE_FULLY_ARMED:
+      args->comms_impl->set_speed(&args->escs.weapon[0], outputs->weapon_motor_1);
+      args->comms_impl->set_speed(&args->escs.weapon[1], outputs->weapon_motor_2);
+      args->comms_impl->set_speed(&args->escs.weapon[2], outputs->weapon_motor_3);
+      args->comms_impl->set_speed(&args->escs.drive[0], outputs->wheel[0]);
+      args->comms_impl->set_speed(&args->escs.drive[1], outputs->wheel[1]);
+      args->comms_impl->set_speed(&args->escs.drive[2], outputs->wheel[2]);
+      break;
+    case STATE_DRIVE_ONLY:
+      args->comms_impl->set_speed(&args->escs.drive[0], outputs->wheel[0]);
+      args->comms_impl->set_speed(&args->escs.drive[1], outputs->wheel[1]);
+      args->comms_impl->set_speed(&args->escs.drive[2], outputs->wheel[2]);
+      args->comms_impl->stop(&args->escs.weapon[0]);
+      args->comms_impl->stop(&args->escs.weapon[1]);
+      args->comms_impl->stop(&args->escs.weapon[2]);
+      break;
+    case STATE_WEAPON_ONLY:
+      args->comms_impl->set_speed(&args->escs.weapon[0], outputs->weapon_motor_1);
+      args->comms_impl->set_speed(&args->escs.weapon[1], outputs->weapon_motor_2);
+      args->comms_impl->set_speed(&args->escs.weapon[2], outputs->weapon_motor_3);
+      args->comms_impl->stop(&args->escs.drive[0]);
+      args->comms_impl->stop(&args->escs.drive[1]);
+      args->comms_impl->stop(&args->escs.drive[2]);
+      break;
+    case STATE_DISARMED:
+      args->comms_impl->stop(&args->escs.drive[0]);
+      args->comms_impl->stop(&args->escs.drive[1]);
+      args->comms_impl->stop(&args->escs.drive[2]);
+      args->comms_impl->stop(&args->escs.weapon[0]);
+      args->comms_impl->stop(&args->escs.weapon[1]);
+      args->comms_impl->stop(&args->escs.weapon[2]);
+  }
+}
 
-      // Set the control value for other threads to use
-      args->mutex.controls->lock();
-      args->controls[controller].channel[channel] = v;
-      args->mutex.controls->unlock();
+void esp_serial_write(thread_args_t *args, const uint8_t *data, uint32_t length) {
+  uint32_t i;
 
-      // For debugging purposes
-      // args->serial->printf("con %d chan %d: [pw: %.0f, min: %.0f, max: %.0f, v: %.0f]\r\n", controller, channel, pw, min, max, v);
-    }
+  for (i = 0; i < length; i++) {
+    args->esp_serial->putc(data[i]);
   }
 }
 
-void set_output_escs(thread_args_t *args) {
-  /* No matter what drive mode we use, ensure outputs
-     are within the valid range. */
-  args->mutex.outputs->lock();
-  args->outputs.wheel_1 = clamp(args->outputs.wheel_1, 0, 100);
-  args->outputs.wheel_2 = clamp(args->outputs.wheel_2, 0, 100);
-  args->outputs.wheel_3 = clamp(args->outputs.wheel_3, 0, 100);
-  args->outputs.weapon_motor_1 = clamp(args->outputs.weapon_motor_1, 0, 100);
-  args->outputs.weapon_motor_2 = clamp(args->outputs.weapon_motor_2, 0, 100);
-  args->outputs.weapon_motor_3 = clamp(args->outputs.weapon_motor_3, 0, 100);
-  args->mutex.outputs->unlock();
+void task_wait(unsigned task_id, uint32_t ms) {
+  cpu_monitor_block(task_id);
+  Thread::wait(ms);
+  cpu_monitor_wake(task_id, true);
+}
 
-  /* Now that we have valid output parameters, we can set the ESCs. */
-  args->mutex.outputs->lock();
-    switch (args->state) {
-      case STATE_FULLY_ARMED:
-        args->comms_impl->set_speed(&args->escs.weapon[0], args->outputs.weapon_motor_1);
-        args->comms_impl->set_speed(&args->escs.weapon[1], args->outputs.weapon_motor_2);
-        args->comms_impl->set_speed(&args->escs.weapon[2], args->outputs.weapon_motor_3);
-        args->comms_impl->set_speed(&args->escs.drive[0], args->outputs.wheel_1);
-        args->comms_impl->set_speed(&args->escs.drive[1], args->outputs.wheel_2);
-        args->comms_impl->set_speed(&args->escs.drive[2], args->outputs.wheel_3);
-        break;
-      case STATE_DRIVE_ONLY:
-        args->comms_impl->set_speed(&args->escs.drive[0], args->outputs.wheel_1);
-        args->comms_impl->set_speed(&args->escs.drive[1], args->outputs.wheel_2);
-        args->comms_impl->set_speed(&args->escs.drive[2], args->outputs.wheel_3);
-        args->comms_impl->stop(&args->escs.weapon[0]);
-        args->comms_impl->stop(&args->escs.weapon[1]);
-        args->comms_impl->stop(&args->escs.weapon[2]);
-        break;
-      case STATE_WEAPON_ONLY:
-        args->comms_impl->set_speed(&args->escs.weapon[0], args->outputs.weapon_motor_1);
-        args->comms_impl->set_speed(&args->escs.weapon[1], args->outputs.weapon_motor_2);
-        args->comms_impl->set_speed(&args->escs.weapon[2], args->outputs.weapon_motor_3);
-        args->comms_impl->stop(&args->escs.drive[0]);
-        args->comms_impl->stop(&args->escs.drive[1]);
-        args->comms_impl->stop(&args->escs.drive[2]);
-        break;
-      case STATE_DISARMED:
-        args->comms_impl->stop(&args->escs.drive[0]);
-        args->comms_impl->stop(&args->escs.drive[1]);
-        args->comms_impl->stop(&args->escs.drive[2]);
-        args->comms_impl->stop(&args->escs.weapon[0]);
-        args->comms_impl->stop(&args->escs.weapon[1]);
-        args->comms_impl->stop(&args->escs.weapon[2]);
-    }
-  args->mutex.outputs->unlock();
+osEvent task_signal_wait(unsigned task_id, int32_t signals, uint32_t ms) {
+  osEvent event;
+
+  cpu_monitor_block(task_id);
+  event = Thread::signal_wait(signals, ms);
+  cpu_monitor_wake(task_id, true);
+  return event;
 }
@@ -36,8 +36,19 @@
 #include "utils.h"
 #include "task_utils.h"
 #include "watchdog.h"
+#include "loop_stats.h"
+#include "mixer.h"
+#include "orientation.h"
+#include "clock.h"
+#include "failsafe.h"
+#include "tele_codec.h"
+#include "tele_store.h"
+#include "tele_collectors.h"
+#include "cpu_monitor.h"
 
 void task_start(thread_args_t *targs, unsigned task_id) {
+  // The task is running, from here on it reports each time it blocks
+  cpu_monitor_wake(task_id, true);
   targs->serial->printf("started task %d (%s)\tstack [alloc: %d, used: %d, free: %d]\r\n", task_id, tasks[task_id].name, targs->threads[task_id].stack_size(), targs->threads[task_id].used_stack(), targs->threads[task_id].free_stack());
 
   // targs->serial->printf("Using %d bytes of stack.\r\n", task_id, tasks[task_id].name);
@@ -51,20 +62,37 @@ void task_start(thread_args_t *targs, unsigned task_id) {
 void task_process_commands(const void *targs) {
   thread_args_t * args = (thread_args_t *) targs;
   task_start(args, TASK_PROCESS_COMMANDS_ID);
+
+  command_stats_t *stats = &args->command_stats;
+  osEvent evt;
+  command_t *command_q;
+  int err;
+
   while (args->active) {
+    // Sleep until a command is queued rather than polling the queue
+    cpu_monitor_block(TASK_PROCESS_COMMANDS_ID);
+    evt = args->command_queue->get();
+    cpu_monitor_wake(TASK_PROCESS_COMMANDS_ID, true);
+    if (evt.status != osEventMail) {
+      continue;
+    }
+    command_q = (command_t*) evt.value.p;
+    core_util_atomic_decr_u32(&stats->depth, 1);
+
     if (args->tasks[TASK_PROCESS_COMMANDS_ID].active) {
-      osEvent evt;
-      while ((evt = args->command_queue->get(1)).status == osEventMail) {
-          command_t *command_q = (command_t*) evt.value.p;
-          int err;
-          if ((err = command_execute(command_q, args)) != RET_OK) {
-            LOG("\rError: %s\r\n", err_to_str(err));
-          } else {
-            LOG("\rCommand succesful\r\n");
-          }
-          args->command_queue->free(command_q);
+      command_q->executed_us = (uint32_t) clock_now_us();
+      timing_histogram_add(&stats->wait,
+        command_q->executed_us - command_q->enqueued_us);
+
+      if ((err = command_execute(command_q, args)) != RET_OK) {
+        LOG("\rError: %s\r\n", err_to_str(err));
+      } else {
+        LOG("\rCommand succesful\r\n");
       }
+      timing_histogram_add(&stats->latency,
+        (uint32_t) clock_now_us() - command_q->enqueued_us);
     }
+    args->command_queue->free(command_q);
   }
 }
 #endif
@@ -78,46 +106,30 @@ void task_read_serial(const void *targs){
   thread_args_t * args = (thread_args_t *) targs;
   task_start(args, TASK_READ_SERIAL_ID);
 
-  char buffer[100];
-  int pos = 0;
-  LOG( "$");
-  bool readable;
+  console_line_t line;
+  command_t command;
+
+  console_notify(&args->console, &args->threads[TASK_READ_SERIAL_ID], CONSOLE_LINE_SIGNAL);
+  LOG("$ ");
   while (args->active) {
-    if (args->tasks[TASK_READ_SERIAL_ID].active) {
-      bool readable = args->serial->readable();
-      // LOG("test\r\n");
-      if (readable) {
-        buffer[pos] = args->serial->getc();
-
-        // If ENTER key is pressed, execute command
-        if (buffer[pos] == '\r') {
-          buffer[pos+1] = NULL;
-          LOG("\r\n");
-          command_t command;
-          // Generate a command structure for the command given
-          if (!command_generate(&command, buffer)) {
-            LOG("\rCommand not recognised!\r\n");
-          } else {
-            command_t *command_q = args->command_queue->alloc();
-            memcpy(command_q, &command, sizeof(command_t));
-            args->command_queue->put(command_q);
-          }
+    // Characters are assembled and echoed by the serial interrupt, so only
+    // wake once a whole line has been typed
+    task_signal_wait(TASK_READ_SERIAL_ID, CONSOLE_LINE_SIGNAL, osWaitForever);
 
-          pos = -1;
-        }
-        //TODO: This function needs looking at.
-        if(pos > 0 ) {
-          if (buffer[pos] == '\b') {
-            buffer[pos] = NULL;
-            pos--;
-          }
-        }
-        buffer[pos+1] = NULL;
-        LOG("\r$ %s", buffer);
-        pos++;
+    while (console_read_line(&args->console, &line)) {
+      if (!args->tasks[TASK_READ_SERIAL_ID].active) {
+        continue;
+      }
+      // Generate a command structure for the command given
+      if (!command_generate(&command, line.text)) {
+        LOG("\rCommand not recognised!\r\n");
+      } else if (command_enqueue(&command, args) != RET_OK) {
+        LOG("\rCommand queue full!\r\n");
       }
+      LOG("$ ");
     }
   }
+  console_notify(&args->console, NULL, 0);
 }
 #endif
 
@@ -182,16 +194,29 @@ void task_state_leds(const void *targs){
 
       previous_state = args->state;
       first_time = false;
-      Thread::wait(100);
+      task_wait(TASK_LED_STATE_ID, 100);
     }
   }
 }
 #endif
 
+/**
+* @brief Release the motor drive task, called from a Ticker interrupt.
+* @param [in] args Thread arguments.
+*/
+#if defined (TASK_MOTOR_DRIVE) && !defined (CONTROL_LOOP_FRAME_SYNC)
+static void task_motor_drive_tick(thread_args_t *args) {
+  args->threads[TASK_MOTOR_DRIVE_ID].signal_set(CONTROL_LOOP_SIGNAL);
+}
+#endif
+
 /**
 * @brief Convert receiver PWM inputs into PWM outputs to ESCs.
 * @note We want this thread to be super fast, to minimise the lag
-*       between controller and ESC signals.
+*       between controller and ESC signals. It is released either when the
+*       drive receiver completes a frame (CONTROL_LOOP_FRAME_SYNC) or once
+*       every CONTROL_LOOP_PERIOD_US by a hardware ticker, so that it
+*       doesn't hog the CPU.
 * @param [in/out] targs Thread arguments.
 */
 #ifdef TASK_MOTOR_DRIVE
@@ -199,23 +224,80 @@ void task_motor_drive(const void *targs) {
   thread_args_t * args = (thread_args_t *) targs;
   task_start(args, TASK_MOTOR_DRIVE_ID);
 
+  uint32_t start_us, record_us;
+  rc_frame_t frame;
+  struct rc_outputs_t outputs;
+  bool inverted;
+  memset(&frame, 0x00, sizeof(rc_frame_t));
+
+#ifdef CONTROL_LOOP_FRAME_SYNC
+  rc_capture_t *sync = &args->receiver[RC_FRAME_SYNC_CONTROLLER];
+  osEvent event;
+  rc_capture_notify(sync, &args->threads[TASK_MOTOR_DRIVE_ID], CONTROL_LOOP_SIGNAL);
+#else
+  Ticker ticker;
+  ticker.attach_us(callback(task_motor_drive_tick, args), CONTROL_LOOP_PERIOD_US);
+#endif
+
   while (args->active) {
+#ifdef CONTROL_LOOP_FRAME_SYNC
+    // Sleep until the next frame arrives, or run anyway to keep outputs
+    // and the watchdog serviced if the receiver has gone quiet
+    event = task_signal_wait(TASK_MOTOR_DRIVE_ID, CONTROL_LOOP_SIGNAL, RC_FRAME_TIMEOUT_MS);
+#else
+    // Sleep until the next period begins
+    task_signal_wait(TASK_MOTOR_DRIVE_ID, CONTROL_LOOP_SIGNAL, osWaitForever);
+#endif
+
     if (args->tasks[TASK_MOTOR_DRIVE_ID].active) {
+      // Reading the clock every cycle also keeps it from missing a wrap
+      start_us = (uint32_t) clock_now_us();
+      loop_stats_cycle_start(&args->motor_loop, start_us);
+
       // Read pusle width from receiver
-      read_recv_pw(args);
+      read_recv_pw(args, &frame);
 
-      // Calculate drive motor output pulse widths
-      args->drive_mode->drive(args);
+      // Back up the failsafe deadlines before the outputs are set
+      failsafe_poll(args);
 
-      // Calculate weapon motor output pulse widths
-      args->weapon_mode->weapon(args);
+      // Remap the controls from the first cycle after the robot flips.
+      inverted = (orientation_effective(args->orientation_detected, args->orientation_override) == INVERTED);
+      if (inverted != args->inverted) {
+        args->inverted = inverted;
+        args->flip_latency_us = (uint32_t) clock_now_us() - args->orientation_changed_us;
+      }
+
+      // Calculate drive and weapon motor output pulse widths. While the
+      // driver is not rotating, the heading lock holds the robot's heading.
+      args->heading_lock_turning = control_cycle(args->drive_mode, args->weapon_mode, &frame,
+        args->heading_lock_enabled, args->heading_rotation, inverted, &outputs);
 
       // Set PWM outputs to ESCs
-      set_output_escs(args);
+      set_output_escs(args, &outputs);
+
+      // Record the cycle, timing the recorder itself
+      record_us = (uint32_t) clock_now_us();
+      blackbox_record(&args->blackbox, start_us, &args->raw_pulses, &frame, &outputs, args->state,
+        &args->orientation, (args->inverted ? BLACKBOX_FLAG_INVERTED : 0) |
+        (args->heading_lock_enabled ? BLACKBOX_FLAG_HEADING_LOCK : 0));
+      timing_histogram_add(&args->blackbox.cost, (uint32_t) clock_now_us() - record_us);
+
+      loop_stats_cycle_end(&args->motor_loop, start_us, (uint32_t) clock_now_us());
+#ifdef CONTROL_LOOP_FRAME_SYNC
+      if (event.status == osEventSignal) {
+        loop_stats_latency(&args->motor_loop,
+          (uint32_t) clock_read_stamp(&sync->frame_us), (uint32_t) clock_now_us());
+      }
+#endif
     }
     // Kick watchdog
     args->wdt->kick();
   }
+#ifdef CONTROL_LOOP_FRAME_SYNC
+  rc_capture_notify(sync, NULL, 0);
+#else
+  ticker.detach();
+#endif
 }
 #endif
 
@@ -228,163 +310,198 @@ void task_arming(const void *targs) {
   thread_args_t * args = (thread_args_t *) targs;
   task_start(args, TASK_ARMING_ID);
 
-  bool drive_switch, weapon_switch, drive_arm, weapon_arm, drive_stalled, weapon_stalled;
+  rc_frame_t frame;
+  state_t state, next;
 
   while (args->active) {
     if (args->tasks[TASK_ARMING_ID].active) {
-      args->mutex.controls->lock();
-      weapon_switch = (args->controls[0].channel[RC_0_ARM_SWITCH] > RC_SWITCH_MIDPOINT);
-      drive_switch = (args->controls[1].channel[RC_1_ARM_SWITCH] > RC_SWITCH_MIDPOINT);
-      args->mutex.controls->unlock();
+      // Take a consistent copy of every channel
+      args->controls.read(&frame);
 
       /* If a transmitter is lost (turned off/out of range),
          disable arming for that TX.
       */
-      drive_stalled = is_drive_stalled(args);
-      weapon_stalled = is_weapon_stalled(args);
-
-      args->mutex.controls->lock();
-      weapon_arm = weapon_switch && !weapon_stalled &&
-        BETWEEN(args->controls[0].channel[RC_0_THROTTLE], 0, 2) &&
-        BETWEEN(args->controls[0].channel[RC_0_ELEVATION], 45, 55) &&
-        BETWEEN(args->controls[0].channel[RC_0_RUDDER], 45, 55) &&
-        BETWEEN(args->controls[0].channel[RC_0_AILERON], 45, 55);
-      args->mutex.controls->unlock();
-
-      args->mutex.controls->lock();
-      drive_arm = drive_switch && !drive_stalled &&
-        BETWEEN(args->controls[1].channel[RC_1_THROTTLE], 0, 2) &&
-        BETWEEN(args->controls[1].channel[RC_1_ELEVATION], 45, 55) &&
-        BETWEEN(args->controls[1].channel[RC_1_RUDDER], 45, 55) &&
-        BETWEEN(args->controls[1].channel[RC_1_AILERON], 45, 55);
-      args->mutex.controls->unlock();
-
-      //Debug: Print RX values
-      // args->serial->printf("drive_switch : %.0f (%s)\r\n", args->controls[0].channel[RC_0_ARM_SWITCH], drive_switch ? "On" : "Off");
-      // args->serial->printf("weapon_switch: %.0f (%s)\r\n", args->controls[1].channel[RC_1_ARM_SWITCH], weapon_switch ? "On" : "Off");
-
-      switch (args->state) {
-        /* From the fully armed state we can only decrease the arm state,
-        so we don't need to be concerned with the stick positions. */
-        case STATE_FULLY_ARMED:
-          if (!drive_switch && !weapon_switch) {
-            args->state = STATE_DISARMED;
-          } else if (drive_switch && !weapon_switch) {
-            args->state = STATE_DRIVE_ONLY;
-          } else if (!drive_switch && weapon_switch) {
-            args->state = STATE_WEAPON_ONLY;
-          }
-          break;
-        case STATE_DRIVE_ONLY:
-          if (!drive_switch) {
-            args->state = STATE_DISARMED;
-          } else if (weapon_arm) {
-            args->state = STATE_FULLY_ARMED;
-          }
-          break;
-        case STATE_WEAPON_ONLY:
-          if (!weapon_switch) {
-            args->state = STATE_DISARMED;
-          } else if (drive_arm) {
-            args->state = STATE_FULLY_ARMED;
-          }
-          break;
-        case STATE_DISARMED:
-          if (drive_arm && weapon_arm) {
-            args->state = STATE_FULLY_ARMED;
-          } else if (drive_arm) {
-            args->state = STATE_DRIVE_ONLY;
-          } else if (weapon_arm) {
-            args->state = STATE_WEAPON_ONLY;
-          }
+      state = args->state;
+      next = state_arm(state, &frame, is_drive_stalled(args), is_weapon_stalled(args));
+
+      // The failsafe interrupt may have lowered the state since it was read,
+      // in which case its decision stands and is looked at again next period
+      if (next != state) {
+        core_util_critical_section_enter();
+        if (args->state == state) {
+          args->state = next;
+        }
+        core_util_critical_section_exit();
       }
     }
-    Thread::wait(1000);
+    task_wait(TASK_ARMING_ID, ARMING_PERIOD_MS);
   }
 }
 #endif
 
-#ifdef TASK_FAILSAFE
-void task_failsafe(const void *targs) {
-  thread_args_t * args = (thread_args_t *) targs;
-  task_start(args, TASK_FAILSAFE_ID);
+#if defined (TASK_CALC_ORIENTATION) && defined(DEVICE_BNO055)
+#ifdef BNO055_INT_PIN
+static void bno055_data_ready(Thread *thread) {
+  thread->signal_set(BNO055_DATA_READY_SIGNAL);
+}
+#endif
 
-  bool drive_inactive, weapon_inactive;
+/**
+* @brief Run the heading controller on a new orientation sample.
+* @param [in/out] args Thread arguments.
+* @param [in] sample New orientation sample.
+* @param [in] dt Time since the previous sample (seconds).
+*/
+static void heading_lock_sample(thread_args_t *args, const bno055_sample_t *sample, float dt) {
+  pid_gains_t gains;
+  float output;
+
+  // Follow the heading while the lock is off, the driver is turning or the
+  // drive is disarmed, so that the lock holds wherever it is released. The
+  // raw modes have no heading to hold.
+  if (!args->heading_lock_enabled || args->heading_lock_turning ||
+      args->state == STATE_DISARMED || args->state == STATE_WEAPON_ONLY ||
+      !bno055_fusion_mode(&args->imu_config)) {
+    args->heading_lock = sample->euler.heading;
+    heading_pid_reset(&args->heading_pid);
+    args->heading_rotation = 0;
+    return;
+  }
 
-  while (args->active) {
-    if (args->tasks[TASK_FAILSAFE_ID].active) {
-      weapon_inactive = is_weapon_stalled(args);
-      drive_inactive = is_drive_stalled(args);
-
-      switch (args->state) {
-        case STATE_FULLY_ARMED:
-          if (drive_inactive && weapon_inactive) {
-            args->state = STATE_DISARMED;
-          } else if (drive_inactive && !weapon_inactive) {
-            args->state = STATE_WEAPON_ONLY;
-          } else if (!drive_inactive && weapon_inactive) {
-            args->state = STATE_DRIVE_ONLY;
-          }
-          break;
-        case STATE_DRIVE_ONLY:
-          if (drive_inactive) {
-            args->state = STATE_DISARMED;
-          }
-          break;
-        case STATE_WEAPON_ONLY:
-          if (weapon_inactive){
-            args->state = STATE_DISARMED;
-          }
-          break;
-        default:
-          break;
-      }
-    }
-    // For debugging purposes
-    // Thread::wait(1000);
-    // args->serial->printf("drive stall timer: %d ms\r\n", args->receiver[1].channel[0]->stallTimer.read_ms());
-    // args->serial->printf("drive stall timer: %d ms\r\n", args->receiver[1].channel[1]->stallTimer.read_ms());
-    // args->serial->printf("drive stall timer: %d ms\r\n", args->receiver[1].channel[2]->stallTimer.read_ms());
-    // args->serial->printf("drive stall timer: %d ms\r\n", args->receiver[1].channel[3]->stallTimer.read_ms());
-    // args->serial->printf("drive stall timer: %d ms\r\n", args->receiver[1].channel[4]->stallTimer.read_ms());
-    // args->serial->printf("drive stall timer: %d ms\r\n", args->receiver[1].channel[5]->stallTimer.read_ms());
-    // args->serial->printf("weapon stall timer: %d ms\r\n", args->receiver[0].channel[0]->stallTimer.read_ms());
-    // args->serial->printf("weapon stall timer: %d ms\r\n", args->receiver[0].channel[1]->stallTimer.read_ms());
-    // args->serial->printf("weapon stall timer: %d ms\r\n", args->receiver[0].channel[2]->stallTimer.read_ms());
-    // args->serial->printf("weapon stall timer: %d ms\r\n", args->receiver[0].channel[3]->stallTimer.read_ms());
-    // args->serial->printf("weapon stall timer: %d ms\r\n", args->receiver[0].channel[4]->stallTimer.read_ms());
-    // args->serial->printf("weapon stall timer: %d ms\r\n", args->receiver[0].channel[5]->stallTimer.read_ms());
+  gains.kp = tele_store_get_f(CID_HEADING_KP);
+  gains.ki = tele_store_get_f(CID_HEADING_KI);
+  gains.kd = tele_store_get_f(CID_HEADING_KD);
+
+  // Heading increases clockwise looking down on the sensor, while the gyro
+  // Z rate is positive anticlockwise.
+  output = heading_pid_update(&args->heading_pid, &gains,
+    heading_error(args->heading_lock, sample->euler.heading), -sample->gyro.z, dt,
+    args->heading_lock_deadband, args->heading_lock_speed / 100.0f);
+  // Upside down, the sensor sees the heading and yaw rate mirrored while the
+  // rotate axis is left as it is, so the correction has to be reversed.
+  if (args->inverted) {
+    output = -output;
   }
+  args->heading_rotation = CONTROL(output);
 }
-#endif
 
-
-#if defined (TASK_CALC_ORIENTATION) && defined(DEVICE_BNO055)
 void task_calc_orientation(const void *targs) {
   thread_args_t * args = (thread_args_t *) targs;
   task_start(args, TASK_CALC_ORIENTATION_ID);
 
+  bno055_stats_t *stats = &args->imu_stats;
+  orientation_detector_t detector;
+  bno055_read_t read;
+  bno055_sample_t sample;
+  char last[BNO055_DATA_LEN] = {0};
+  uint64_t health_due_us = 0;
+  uint64_t now_us, next_us, window_us;
+  uint32_t period_us = 1000000 / bno055_data_rate_hz(&args->imu_config);
+  uint32_t window_samples = 0;
+  uint32_t sample_us, last_sample_us = 0;
+  float dt;
+  bool healthy = false;
+
+#ifdef BNO055_INT_PIN
+  InterruptIn data_ready(BNO055_INT_PIN);
+  data_ready.rise(callback(bno055_data_ready, &args->threads[TASK_CALC_ORIENTATION_ID]));
+#endif
+
+  orientation_detector_init(&detector);
+
+  next_us = window_us = clock_now_us();
   while (args->active) {
     if (args->tasks[TASK_CALC_ORIENTATION_ID].active) {
+      // Sensor faults are rare, so only check for them now and then rather
+      // than doubling the bus traffic of every read.
+      if (clock_now_us() >= health_due_us) {
+        healthy = bno055_healthy();
+        health_due_us = clock_now_us() + BNO055_HEALTH_CHECK_MS * 1000;
+      }
+
       /* If there is an error then we maintain the same
        * orientation to stop random control flipping */
-      if (!bno055_healthy()) {
+      if (!healthy) {
           LOG("ERROR: BNO055 has an error/status problem!!!\r\n");
+          // Stop steering on a heading that is no longer being measured.
+          args->heading_rotation = 0;
+          task_wait(TASK_CALC_ORIENTATION_ID, BNO055_HEALTH_CHECK_MS);
+          continue;
+      }
+
+      // Only read once the sensor has new data. Reading faster just
+      // returns the same sample again and loads the bus.
+#ifdef BNO055_INT_PIN
+      // Time out after two periods in case an edge was missed.
+      task_signal_wait(TASK_CALC_ORIENTATION_ID, BNO055_DATA_READY_SIGNAL,
+        MAX(2 * period_us / 1000, (uint32_t) 1));
+#else
+      now_us = clock_now_us();
+      next_us += period_us;
+      if (next_us <= now_us) {
+        next_us = now_us + period_us;
+      }
+      task_wait(TASK_CALC_ORIENTATION_ID, (uint32_t) ((next_us - now_us + 999) / 1000));
+#endif
+
+      if (bno055_request_sample(&read, &args->threads[TASK_CALC_ORIENTATION_ID],
+            BNO055_SAMPLE_SIGNAL) != RET_OK) {
+        // The bus queue is full, try again next sample.
+        continue;
+      }
+      // The bus thread runs the read, sleep until it is done. The read is
+      // part of this sample's run.
+      cpu_monitor_block(TASK_CALC_ORIENTATION_ID);
+      Thread::signal_wait(BNO055_SAMPLE_SIGNAL);
+      cpu_monitor_wake(TASK_CALC_ORIENTATION_ID, false);
+#ifdef BNO055_INT_PIN
+      bno055_clear_interrupt();
+#endif
+
+      sample_us = (uint32_t) clock_now_us();
+      if (!bno055_sample_result(&read, &sample)) {
+        continue;
+      }
+      if (memcmp(read.data, last, BNO055_DATA_LEN) == 0) {
+        stats->duplicates++;
       } else {
-          /* Read in the Euler angles */
-          args->orientation = bno055_read_euler_angles();
-
-          /* We are upside down in range -30 -> -90
-           * the sensor will report -60 when inverted */
-          if (args->orientation.roll < -30 && args->orientation.roll > -90){
-              args->inverted = true;
-          } else {
-              args->inverted = false;
-          }
-          #if defined (PC_DEBUGGING) && defined (DEBUG_ORIENTATION)
-          args->serial->printf("Inverted= %s \t (%7.2f) \r\n", args->inverted ? "true" : "false", orientation.roll);
-          #endif
+        memcpy(last, read.data, BNO055_DATA_LEN);
+        stats->samples++;
+        window_samples++;
+        args->orientation = sample.euler;
+        args->imu_sample.publish(sample);
+
+        // The motor drive task remaps the controls on its next cycle, and
+        // measures how long that took from here.
+        if (orientation_detect(&detector, sample.euler.roll)) {
+          args->orientation_changed_us = sample_us;
+          args->orientation_detected = detector.orientation;
+          // The heading reads differently upside down, so lock it again.
+          args->heading_lock = sample.euler.heading;
+          heading_pid_reset(&args->heading_pid);
+        }
+        #if defined (PC_DEBUGGING) && defined (DEBUG_ORIENTATION)
+        args->serial->printf("Inverted= %s \t (%7.2f) \r\n",
+          detector.orientation == INVERTED ? "true" : "false", sample.euler.roll);
+        #endif
+
+        // Close the heading loop on every new sample. Time between samples
+        // is capped so a stall does not throw the integral.
+        loop_stats_cycle_start(&args->heading_loop, sample_us);
+        dt = MIN(sample_us - last_sample_us, 2 * period_us) / 1000000.0f;
+        last_sample_us = sample_us;
+        heading_lock_sample(args, &sample, dt);
+        loop_stats_cycle_end(&args->heading_loop, sample_us, (uint32_t) clock_now_us());
+      }
+
+      now_us = clock_now_us();
+      if (now_us - window_us >= 1000000) {
+        stats->samples_per_sec = window_samples;
+        window_samples = 0;
+        window_us = now_us;
       }
+    } else {
+      task_wait(TASK_CALC_ORIENTATION_ID, 100);
     }
   }
 }
@@ -395,106 +512,42 @@ void task_collect_telemetry(const void *targs) {
   thread_args_t * args = (thread_args_t *) targs;
   task_start(args, TASK_COLLECT_TELEMETRY_ID);
 
-  uint32_t tmp_int;
-  euler_t e;
+  /* When each group is next due to be collected (microseconds). */
+  uint64_t due_us[TG_NUM_GROUPS] = {0};
+  uint64_t now_us, next_us;
+  tele_group_id_t group;
   unsigned i;
+
   while (args->active) {
+    now_us = clock_now_us();
+    next_us = now_us + TELEMETRY_COLLECT_IDLE_MS * 1000;
+
     if (args->tasks[TASK_COLLECT_TELEMETRY_ID].active) {
       for (i = 0; i < NUM_TELE_COMMANDS; i++) {
-        switch (tele_commands[i].id) {
-          case CID_DRIVE_RPM_1:
-            // TODO(camieac): Add support for RPM sensing
-            args->mutex.telemetry->lock();
-            tele_commands[i].param.f = 0.00f;
-            args->mutex.telemetry->unlock();
-            break;
-          case CID_DRIVE_RPM_2:
-            // TODO(camieac): Add support for RPM sensing
-            args->mutex.telemetry->lock();
-            tele_commands[i].param.f = 0.00f;
-            args->mutex.telemetry->unlock();
-            break;
-          case CID_DRIVE_RPM_3:
-            // TODO(camieac): Add support for RPM sensing
-            args->mutex.telemetry->lock();
-            tele_commands[i].param.f = 0.00f;
-            args->mutex.telemetry->unlock();
-            break;
-          case CID_WEAPON_RPM_1:
-            // TODO(camieac): Add support for RPM sensing
-            args->mutex.telemetry->lock();
-            tele_commands[i].param.f = 0.00f;
-            args->mutex.telemetry->unlock();
-            break;
-          case CID_WEAPON_RPM_2:
-            // TODO(camieac): Add support for RPM sensing
-            args->mutex.telemetry->lock();
-            tele_commands[i].param.f = 0.00f;
-            args->mutex.telemetry->unlock();
-            break;
-          case CID_WEAPON_RPM_3:
-            // TODO(camieac): Add support for RPM sensing
-            args->mutex.telemetry->lock();
-            tele_commands[i].param.f = 0.00f;
-            args->mutex.telemetry->unlock();
-            break;
-#ifdef DEVICE_BNO055
-          /* Accelerations are captured in one function */
-          case CID_ACCEL_X:
-          case CID_ACCEL_Y:
-          case CID_ACCEL_Z:
-            e = bno055_read_accel();
-            args->mutex.telemetry->lock();
-            tele_commands[CID_ACCEL_X].param.f = e.x;
-            tele_commands[CID_ACCEL_Y].param.f = e.y;
-            tele_commands[CID_ACCEL_Z].param.f = e.z;
-            args->mutex.telemetry->unlock();
-            // We do x, y and z in one op, so skip 2 once done
-            if (i == CID_ACCEL_X) {
-              i+=2;
-            }
-            break;
-
-          /* Pitch, roll and yaw are captured in one function. */
-          case CID_PITCH:
-          case CID_ROLL:
-          case CID_YAW:
-            e = bno055_read_euler_angles();
-            args->mutex.telemetry->lock();
-            tele_commands[CID_PITCH].param.f = e.pitch;
-            tele_commands[CID_ROLL].param.f = e.roll;
-            tele_commands[CID_YAW].param.f = e.heading;
-            args->mutex.telemetry->unlock();
-            // We do x, y and z in one op, so skip 2 once done
-            if (i == CID_PITCH) {
-              i+=2;
-            }
-            break;
-          case CID_AMBIENT_TEMP:
-            args->mutex.telemetry->lock();
-            tmp_int = bno055_read_temp();
-            args->mutex.telemetry->unlock();
-            tele_commands[i].param.i = tmp_int;
-            break;
-#endif
-          case CID_WEAPON_VOLTAGE_1:
-          case CID_WEAPON_VOLTAGE_2:
-          case CID_WEAPON_VOLTAGE_3:
-          case CID_DRIVE_VOLTAGE_1:
-          case CID_DRIVE_VOLTAGE_2:
-          case CID_DRIVE_VOLTAGE_3:
-            break;
-          case CID_ARM_STATUS:
-            args->mutex.telemetry->lock();
-            tele_commands[i].param.i = args->state;
-            args->mutex.telemetry->unlock();
-            break;
-          default:
-            args->serial->puts("UNSUPPORTED TELE COMMAND\r\n");
+        if (tele_commands[i].collect == NULL) {
+          continue;
+        }
+        group = tele_commands[i].group;
+        // The first parameter of a due group collects the whole group and
+        // moves its deadline on, so the rest of the group is skipped.
+        if (due_us[group] <= now_us) {
+          tele_commands[i].collect(args);
+          due_us[group] += (uint64_t) tele_commands[i].period_ms * 1000;
+          // Don't try to catch up on collections missed while inactive or
+          // overrun, start a new period from now.
+          if (due_us[group] <= now_us) {
+            due_us[group] = now_us + (uint64_t) tele_commands[i].period_ms * 1000;
+          }
+        }
+        if (due_us[group] < next_us) {
+          next_us = due_us[group];
         }
       }
-      wait(1);
     }
+
+    now_us = clock_now_us();
+    task_wait(TASK_COLLECT_TELEMETRY_ID,
+      (next_us > now_us) ? (uint32_t) ((next_us - now_us + 999) / 1000) : 1);
   }
 }
 #endif
@@ -504,64 +557,61 @@ void task_stream_telemetry(const void *targs) {
   thread_args_t * args = (thread_args_t *) targs;
   task_start(args, TASK_STREAM_TELEMETRY_ID);
 
-  /* Temp values */
-  float tmp_f;
-  uint32_t tmp_i;
-  bool tmp_b;
+  // Kept off the stack, which already holds a frame in both forms.
+  static tele_command_t params[NUM_TELE_COMMANDS];
+  tele_frame_t frame;
+  uint8_t encoded[TELE_ENCODED_MAX_LEN];
+  uint32_t length;
+  tele_header_t header;
+  bool esp_ready = false;
+  int values;
+
+  tele_delta_init(&args->telemetry_delta, TELEMETRY_KEYFRAME_INTERVAL);
+  header.schema = tele_schema_id(tele_commands, NUM_TELE_COMMANDS);
+  header.sequence = 0;
+
+  // Describe every parameter once on start up.
+  args->telemetry_meta_requested = true;
 
   unsigned i = 0;
   while (args->active) {
-    /* The ESP looks for a carriage return character to delimit a command. */
     if (args->tasks[TASK_STREAM_TELEMETRY_ID].active) {
-      for (i = 0; i < NUM_TELE_COMMANDS; i++) {
-        switch (tele_commands[i].type) {
-          case CT_FLOAT:
-            args->mutex.telemetry->lock();
-            tmp_f = tele_commands[i].param.f;
-            args->mutex.telemetry->unlock();
-
-            args->esp_serial->printf(
-              "{\"id\": \"%d\", \"name\": \"%s\", \"type\": \"%s\", \"unit\": \"%s\", \"value\": \"%.2f\"}\r",
-              tele_commands[i].id,
-              tele_commands[i].name,
-              tele_command_type_to_string(tele_commands[i].type),
-              tele_command_unit_to_string(tele_commands[i].unit),
-              tmp_f);
-          break;
-          case CT_INT:
-            args->mutex.telemetry->lock();
-            tmp_i = tele_commands[i].param.i;
-            args->mutex.telemetry->unlock();
-
-            args->esp_serial->printf(
-              "{\"id\": \"%d\", \"name\": \"%s\", \"type\": \"%s\", \"unit\": \"%s\", \"value\": \"%d\"}\r",
-              tele_commands[i].id,
-              tele_commands[i].name,
-              tele_command_type_to_string(tele_commands[i].type),
-              tele_command_unit_to_string(tele_commands[i].unit),
-              tmp_i);
-            break;
-          case CT_BOOLEAN:
-            args->mutex.telemetry->lock();
-            tmp_b = tele_commands[i].param.b;
-            args->mutex.telemetry->unlock();
-
-            args->esp_serial->printf(
-              "{\"id\": \"%d\", \"name\": \"%s\", \"type\": \"%s\", \"unit\": \"%s\", \"value\": \"%s\"}\r",
-              tele_commands[i].id,
-              tele_commands[i].name,
-              tele_command_type_to_string(tele_commands[i].type),
-              tele_command_unit_to_string(tele_commands[i].unit),
-              tmp_b ? "ON" : "OFF");
-            break;
-          case CT_NONE:
-          default:
-            args->serial->printf("Type not yet supported for streaming.\r\n");
-            break;
+      // The ESP8266 has (re)connected, it needs the metadata again.
+      if (args->esp_ready_pin->read() && !esp_ready) {
+        args->telemetry_meta_requested = true;
+      }
+      esp_ready = args->esp_ready_pin->read();
+
+      if (args->telemetry_meta_requested) {
+        args->telemetry_meta_requested = false;
+        for (i = 0; i < NUM_TELE_COMMANDS; i++) {
+          if (tele_encode_meta(&frame, header, i, &tele_commands[i])) {
+            length = tele_frame_encode(&frame, encoded);
+            esp_serial_write(args, encoded, length);
+          }
         }
+        // Values from before the metadata may have been missed, start over.
+        args->telemetry_delta.keyframe_requested = true;
+      }
+
+      // Encode from a copy so the frame is consistent without holding up
+      // the tasks collecting values.
+      tele_store_snapshot(params);
+      values = tele_encode_delta(&frame, header, &args->telemetry_delta,
+        params, NUM_TELE_COMMANDS);
+
+      if (values > 0) {
+        length = tele_frame_encode(&frame, encoded);
+        esp_serial_write(args, encoded, length);
+        tele_delta_sent(&args->telemetry_delta, &frame, length, NUM_TELE_COMMANDS);
+        header.sequence++;
+      } else if (values == 0) {
+        tele_delta_sent(&args->telemetry_delta, &frame, 0, NUM_TELE_COMMANDS);
+      } else {
+        LOG("Telemetry does not fit in a frame.\r\n");
       }
-      wait(1);
     }
+    task_wait(TASK_STREAM_TELEMETRY_ID, TELEMETRY_STREAM_PERIOD_MS);
   }
 }
 #endif
@@ -575,7 +625,7 @@ void task_print_channels(const void *targs) {
     for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
       args->serial->printf("Controller %d\r\n", controller+1);
       for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
-        args->serial->printf("Channel %d: %d\r\n", channel+1, convert_pulsewidth(args->receiver[controller].channel[channel]->pulsewidth()));
+        args->serial->printf("Channel %d: %d\r\n", channel+1, convert_pulsewidth(rc_capture_pulsewidth(&args->receiver[controller], channel)));
       }
     }
     Thread::wait(1000);
@@ -620,7 +670,7 @@ void task_calibrate_channels(const void *targs) {
 
         for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
           for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
-            tmp = args->receiver[controller].channel[channel]->pulsewidth();
+            tmp = rc_capture_pulsewidth(&args->receiver[controller], channel);
             // Find min
             if (tmp < args->channel_limits[controller][channel].min) {
               args->channel_limits[controller][channel].min = tmp;
@@ -632,7 +682,7 @@ void task_calibrate_channels(const void *targs) {
             }
           }
         }
-        Thread::wait(calibration_tick);
+        task_wait(TASK_CALIBRATE_CHANNELS_ID, calibration_tick);
         calibration_time -= calibration_tick;
       }
 
@@ -659,7 +709,7 @@ void task_calibrate_channels(const void *targs) {
     }
 
     // No need to poll continuously
-    Thread::wait(500);
+    task_wait(TASK_CALIBRATE_CHANNELS_ID, 500);
   }
 }
 #endif
@@ -678,14 +728,14 @@ void task_debug(const void *targs) {
     if (args->tasks[TASK_DEBUG_ID].active == true) {
       for (controller = 0; controller < RC_NUMBER_CONTROLLERS; controller++) {
         for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
-          tmp = args->receiver[controller].channel[channel]->pulsewidth();
+          tmp = rc_capture_pulsewidth(&args->receiver[controller], channel);
           printf("ctrl'r: %d, chan: %d, pulse: %.0f\r\n", controller, channel, tmp);
         }
       }
     }
 
     // No need to poll continuously
-    Thread::wait(1000);
+    task_wait(TASK_DEBUG_ID, 1000);
   }
 }
 #endif
@@ -0,0 +1,494 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file tele_codec.cpp
+ * @author Cameron A. Craig
+ * @date 7 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Binary telemetry frames: varint packed values, a CRC and COBS
+ *        framing.
+ */
+
+#include <string.h>
+#include "tele_codec.h"
+
+/* Bytes taken by the CRC at the end of a frame. */
+#define TELE_CRC_LEN 2
+
+/* Most bytes a 32 bit varint can take. */
+#define TELE_VARINT_MAX_LEN 5
+
+/* Encoded frame length that marks a decoder as dropping an over long frame. */
+#define TELE_DECODER_OVERFLOW (TELE_ENCODED_MAX_LEN + 1)
+
+/* Map signed values onto unsigned ones so that small negative values stay
+   small once varint encoded: 0, -1, 1, -2 ... become 0, 1, 2, 3 ... */
+static uint32_t zigzag_encode(int32_t n) {
+  return ((uint32_t) n << 1) ^ (uint32_t) (n >> 31);
+}
+
+static int32_t zigzag_decode(uint32_t n) {
+  return (int32_t) (n >> 1) ^ -(int32_t) (n & 1);
+}
+
+static int32_t float_to_fixed(float f) {
+  float scaled = f * TELE_FLOAT_SCALE;
+
+  if (scaled >= 2147483647.0f) {
+    return 0x7FFFFFFF;
+  } else if (scaled <= -2147483648.0f) {
+    return -0x7FFFFFFF - 1;
+  }
+  return (int32_t) (scaled + ((scaled < 0.0f) ? -0.5f : 0.5f));
+}
+
+/* Space is always left for the CRC, so that tele_frame_encode() can not
+   overrun a frame. */
+static bool put_byte(tele_frame_t *frame, uint8_t b) {
+  if (frame->length >= TELE_FRAME_MAX_LEN - TELE_CRC_LEN) {
+    return false;
+  }
+  frame->data[frame->length++] = b;
+  return true;
+}
+
+static bool put_varint(tele_frame_t *frame, uint32_t value) {
+  while (value >= 0x80) {
+    if (!put_byte(frame, (uint8_t) (value | 0x80))) {
+      return false;
+    }
+    value >>= 7;
+  }
+  return put_byte(frame, (uint8_t) value);
+}
+
+static bool put_header(tele_frame_t *frame, tele_header_t header) {
+  frame->length = 0;
+  return put_byte(frame, (uint8_t) header.type) &&
+    put_byte(frame, (uint8_t) (header.schema & 0xFF)) &&
+    put_byte(frame, (uint8_t) (header.schema >> 8)) &&
+    put_byte(frame, header.sequence);
+}
+
+static bool get_varint(const tele_frame_t *frame, uint32_t *pos, uint32_t *value) {
+  uint32_t shift = 0;
+  uint8_t b;
+
+  *value = 0;
+  do {
+    if (*pos >= frame->length || shift >= 7 * TELE_VARINT_MAX_LEN) {
+      return false;
+    }
+    b = frame->data[(*pos)++];
+    *value |= (uint32_t) (b & 0x7F) << shift;
+    shift += 7;
+  } while (b & 0x80);
+  return true;
+}
+
+static bool put_value(tele_frame_t *frame, const tele_command_t *param) {
+  switch (param->type) {
+    case CT_FLOAT:
+      return put_varint(frame, zigzag_encode(float_to_fixed(param->param.f)));
+    case CT_INT:
+      return put_varint(frame, zigzag_encode(param->param.i));
+    case CT_BOOLEAN:
+      return put_byte(frame, param->param.b ? 1 : 0);
+    case CT_STRING:
+    case CT_NONE:
+    default:
+      // Not streamed, but keep a place so later values stay in order.
+      return put_byte(frame, 0);
+  }
+}
+
+static void get_value(uint32_t value, tele_command_type_t type, tele_value_t *out) {
+  switch (type) {
+    case CT_FLOAT:
+      out->f = (float) zigzag_decode(value) / TELE_FLOAT_SCALE;
+      break;
+    case CT_INT:
+      out->i = zigzag_decode(value);
+      break;
+    case CT_BOOLEAN:
+      out->b = (value != 0);
+      break;
+    default:
+      out->i = 0;
+      break;
+  }
+}
+
+/* Copy the value of a parameter into the form a decoder will see. */
+static void take_value(const tele_command_t *param, tele_value_t *out) {
+  switch (param->type) {
+    case CT_FLOAT:
+      out->f = param->param.f;
+      break;
+    case CT_INT:
+      out->i = param->param.i;
+      break;
+    case CT_BOOLEAN:
+      out->b = param->param.b;
+      break;
+    default:
+      out->i = 0;
+      break;
+  }
+}
+
+/* Whether a parameter has moved further than its deadband from the value
+   last sent. */
+static bool value_changed(const tele_command_t *param, const tele_value_t *last) {
+  float diff;
+
+  switch (param->type) {
+    case CT_FLOAT:
+      diff = param->param.f - last->f;
+      break;
+    case CT_INT:
+      diff = (float) param->param.i - (float) last->i;
+      break;
+    case CT_BOOLEAN:
+      return param->param.b != last->b;
+    default:
+      return false;
+  }
+  if (diff < 0.0f) {
+    diff = -diff;
+  }
+  return diff > param->deadband;
+}
+
+uint16_t tele_crc16(uint16_t crc, const uint8_t *data, uint32_t length) {
+  uint32_t i;
+  int bit;
+
+  for (i = 0; i < length; i++) {
+    crc ^= (uint16_t) data[i] << 8;
+    for (bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ 0x1021) : (uint16_t) (crc << 1);
+    }
+  }
+  return crc;
+}
+
+uint16_t tele_schema_id(const tele_command_t *params, uint32_t count) {
+  uint16_t crc = 0xFFFF;
+  uint8_t type_unit[2];
+  uint32_t i;
+
+  for (i = 0; i < count; i++) {
+    // Include the NUL so that the boundary between names is part of the id.
+    crc = tele_crc16(crc, (const uint8_t *) params[i].name, strlen(params[i].name) + 1);
+    type_unit[0] = (uint8_t) params[i].type;
+    type_unit[1] = (uint8_t) params[i].unit;
+    crc = tele_crc16(crc, type_unit, sizeof(type_unit));
+  }
+  return crc;
+}
+
+bool tele_encode_values(tele_frame_t *frame, tele_header_t header,
+  const tele_command_t *params, uint32_t count) {
+  uint32_t i;
+
+  header.type = TELE_FRAME_VALUES;
+  if (!put_header(frame, header) || !put_varint(frame, count)) {
+    return false;
+  }
+  for (i = 0; i < count; i++) {
+    if (!put_value(frame, &params[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool tele_encode_meta(tele_frame_t *frame, tele_header_t header,
+  uint32_t index, const tele_command_t *param) {
+  uint32_t name_len = strlen(param->name);
+  uint32_t i;
+
+  if (name_len > TELE_NAME_MAX_LEN) {
+    name_len = TELE_NAME_MAX_LEN;
+  }
+  header.type = TELE_FRAME_META;
+  if (!put_header(frame, header) ||
+      !put_varint(frame, index) ||
+      !put_byte(frame, (uint8_t) param->type) ||
+      !put_byte(frame, (uint8_t) param->unit) ||
+      !put_byte(frame, (uint8_t) name_len)) {
+    return false;
+  }
+  for (i = 0; i < name_len; i++) {
+    if (!put_byte(frame, (uint8_t) param->name[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void tele_delta_init(tele_delta_t *delta, uint32_t keyframe_interval) {
+  memset(delta, 0x00, sizeof(tele_delta_t));
+  delta->keyframe_interval = keyframe_interval;
+  delta->keyframe_requested = true;
+}
+
+int tele_encode_delta(tele_frame_t *frame, tele_header_t header,
+  tele_delta_t *delta, const tele_command_t *params, uint32_t count) {
+  uint32_t changed_mask = 0;
+  uint32_t changed = 0;
+  uint32_t count_pos;
+  uint32_t i;
+  bool fits = true;
+
+  if (count > TELE_DELTA_MAX_PARAMS) {
+    return -1;
+  }
+
+  if (!delta->keyframe_requested &&
+      delta->frames_since_keyframe + 1 < delta->keyframe_interval) {
+    header.type = TELE_FRAME_DELTA;
+    if (!put_header(frame, header)) {
+      return -1;
+    }
+    // The number of changed values is filled in once known. It always fits
+    // in one varint byte as count is at most TELE_DELTA_MAX_PARAMS.
+    count_pos = frame->length;
+    fits = put_byte(frame, 0);
+    for (i = 0; fits && i < count; i++) {
+      if (value_changed(&params[i], &delta->last[i])) {
+        fits = put_varint(frame, i) && put_value(frame, &params[i]);
+        changed_mask |= (uint32_t) 1 << i;
+        changed++;
+      }
+    }
+    // Too many changes for a delta frame, send everything instead.
+    if (fits) {
+      frame->data[count_pos] = (uint8_t) changed;
+      for (i = 0; i < count; i++) {
+        if (changed_mask & ((uint32_t) 1 << i)) {
+          take_value(&params[i], &delta->last[i]);
+        }
+      }
+      delta->frames_since_keyframe++;
+      return (int) changed;
+    }
+  }
+
+  if (!tele_encode_values(frame, header, params, count)) {
+    return -1;
+  }
+  for (i = 0; i < count; i++) {
+    take_value(&params[i], &delta->last[i]);
+  }
+  delta->keyframe_requested = false;
+  delta->frames_since_keyframe = 0;
+  return (int) count;
+}
+
+void tele_delta_sent(tele_delta_t *delta, const tele_frame_t *frame,
+  uint32_t length, uint32_t count) {
+  uint32_t values;
+  uint32_t pos = TELE_HEADER_LEN;
+
+  if (!get_varint(frame, &pos, &values)) {
+    return;
+  }
+  if (frame->data[0] == TELE_FRAME_VALUES) {
+    delta->keyframes++;
+    delta->keyframe_len = length;
+  } else {
+    delta->deltas++;
+    if (delta->keyframe_len > length) {
+      delta->bytes_saved += delta->keyframe_len - length;
+    }
+  }
+  delta->values_sent += values;
+  delta->values_skipped += count - values;
+  delta->bytes_sent += length;
+}
+
+uint32_t tele_frame_encode(const tele_frame_t *frame, uint8_t *out) {
+  uint16_t crc = tele_crc16(0xFFFF, frame->data, frame->length);
+  uint8_t crc_bytes[TELE_CRC_LEN] = {(uint8_t) (crc & 0xFF), (uint8_t) (crc >> 8)};
+  uint32_t total = frame->length + TELE_CRC_LEN;
+  uint32_t code_pos = 0;
+  uint32_t out_len = 1;
+  uint8_t code = 1;
+  uint32_t i;
+  uint8_t c;
+
+  /* Each code byte holds the distance to the next zero, so that the only
+     zero left in the output is the delimiter. */
+  for (i = 0; i < total; i++) {
+    c = (i < frame->length) ? frame->data[i] : crc_bytes[i - frame->length];
+    if (c != 0) {
+      out[out_len++] = c;
+      code++;
+    }
+    if (c == 0 || code == 0xFF) {
+      out[code_pos] = code;
+      code_pos = out_len++;
+      code = 1;
+    }
+  }
+  out[code_pos] = code;
+  out[out_len++] = 0;
+  return out_len;
+}
+
+static bool cobs_decode(const uint8_t *in, uint32_t length, tele_frame_t *frame) {
+  uint32_t i = 0;
+  uint8_t code, j;
+
+  frame->length = 0;
+  while (i < length) {
+    code = in[i++];
+    if (code == 0) {
+      return false;
+    }
+    for (j = 1; j < code; j++) {
+      if (i >= length || frame->length >= TELE_FRAME_MAX_LEN) {
+        return false;
+      }
+      frame->data[frame->length++] = in[i++];
+    }
+    // A full block of 254 bytes is not followed by a zero.
+    if (code < 0xFF && i < length) {
+      if (frame->length >= TELE_FRAME_MAX_LEN) {
+        return false;
+      }
+      frame->data[frame->length++] = 0;
+    }
+  }
+  return true;
+}
+
+void tele_decoder_init(tele_decoder_t *decoder) {
+  memset(decoder, 0x00, sizeof(tele_decoder_t));
+}
+
+bool tele_decode_byte(tele_decoder_t *decoder, uint8_t c, tele_frame_t *frame) {
+  uint32_t length;
+  uint16_t crc;
+
+  if (c != 0) {
+    if (decoder->length < TELE_ENCODED_MAX_LEN) {
+      decoder->buffer[decoder->length++] = c;
+    } else {
+      decoder->length = TELE_DECODER_OVERFLOW;
+    }
+    return false;
+  }
+
+  // Delimiter, decode whatever has arrived since the last one.
+  length = decoder->length;
+  decoder->length = 0;
+  if (length == 0) {
+    return false;
+  }
+  if (length == TELE_DECODER_OVERFLOW ||
+      !cobs_decode(decoder->buffer, length, frame) ||
+      frame->length < TELE_HEADER_LEN + TELE_CRC_LEN) {
+    decoder->errors++;
+    return false;
+  }
+
+  frame->length -= TELE_CRC_LEN;
+  crc = (uint16_t) (frame->data[frame->length] | (frame->data[frame->length + 1] << 8));
+  if (crc != tele_crc16(0xFFFF, frame->data, frame->length)) {
+    decoder->errors++;
+    return false;
+  }
+  return true;
+}
+
+bool tele_decode_header(const tele_frame_t *frame, tele_header_t *header) {
+  if (frame->length < TELE_HEADER_LEN) {
+    return false;
+  }
+  header->type = (tele_frame_type_t) frame->data[0];
+  header->schema = (uint16_t) (frame->data[1] | (frame->data[2] << 8));
+  header->sequence = frame->data[3];
+  return true;
+}
+
+int tele_decode_values(const tele_frame_t *frame,
+  const tele_command_type_t *types, tele_value_t *values, uint32_t count) {
+  uint32_t pos = TELE_HEADER_LEN;
+  uint32_t value;
+  uint32_t i;
+
+  if (frame->length < TELE_HEADER_LEN || frame->data[0] != TELE_FRAME_VALUES) {
+    return -1;
+  }
+  if (!get_varint(frame, &pos, &value) || value != count) {
+    return -1;
+  }
+  for (i = 0; i < count; i++) {
+    if (!get_varint(frame, &pos, &value)) {
+      return -1;
+    }
+    get_value(value, types[i], &values[i]);
+  }
+  return (pos == frame->length) ? (int) count : -1;
+}
+
+int tele_decode_delta(const tele_frame_t *frame,
+  const tele_command_type_t *types, tele_value_t *values, uint32_t count) {
+  uint32_t pos = TELE_HEADER_LEN;
+  uint32_t changed, index, value;
+  uint32_t i;
+
+  if (frame->length < TELE_HEADER_LEN || frame->data[0] != TELE_FRAME_DELTA) {
+    return -1;
+  }
+  if (!get_varint(frame, &pos, &changed) || changed > count) {
+    return -1;
+  }
+  for (i = 0; i < changed; i++) {
+    if (!get_varint(frame, &pos, &index) || index >= count ||
+        !get_varint(frame, &pos, &value)) {
+      return -1;
+    }
+    get_value(value, types[index], &values[index]);
+  }
+  return (pos == frame->length) ? (int) changed : -1;
+}
+
+bool tele_decode_meta(const tele_frame_t *frame, uint32_t *index,
+  tele_command_type_t *type, tele_command_unit_t *unit, char *name) {
+  uint32_t pos = TELE_HEADER_LEN;
+  uint32_t name_len;
+
+  if (frame->length < TELE_HEADER_LEN || frame->data[0] != TELE_FRAME_META) {
+    return false;
+  }
+  if (!get_varint(frame, &pos, index) || pos + 3 > frame->length) {
+    return false;
+  }
+  *type = (tele_command_type_t) frame->data[pos++];
+  *unit = (tele_command_unit_t) frame->data[pos++];
+  name_len = frame->data[pos++];
+  if (name_len > TELE_NAME_MAX_LEN || pos + name_len != frame->length) {
+    return false;
+  }
+  memcpy(name, &frame->data[pos], name_len);
+  name[name_len] = '\0';
+  return true;
+}
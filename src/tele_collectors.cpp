@@ -0,0 +1,135 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file tele_collectors.cpp
+ * @author Cameron A. Craig
+ * @date 9 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Functions that read each group of telemetry parameters.
+ */
+
+#include "tele_collectors.h"
+#include "tele_store.h"
+#include "thread_args.h"
+#include "bno055.h"
+#include "failsafe.h"
+#include "cpu_monitor.h"
+#include "tasks.h"
+
+void tele_collect_drive_rpm(const void *targs) {
+  // TODO(camieac): Add support for RPM sensing
+  tele_store_begin();
+  tele_store_set_f(CID_DRIVE_RPM_1, 0.00f);
+  tele_store_set_f(CID_DRIVE_RPM_2, 0.00f);
+  tele_store_set_f(CID_DRIVE_RPM_3, 0.00f);
+  tele_store_end();
+}
+
+void tele_collect_weapon_rpm(const void *targs) {
+  // TODO(camieac): Add support for RPM sensing
+  tele_store_begin();
+  tele_store_set_f(CID_WEAPON_RPM_1, 0.00f);
+  tele_store_set_f(CID_WEAPON_RPM_2, 0.00f);
+  tele_store_set_f(CID_WEAPON_RPM_3, 0.00f);
+  tele_store_end();
+}
+
+#ifdef DEVICE_BNO055
+void tele_collect_imu(const void *targs) {
+  thread_args_t * args = (thread_args_t *) targs;
+  bno055_sample_t sample;
+
+  // Nothing to publish until the orientation task has read the sensor
+  if (args->imu_sample.sequence() == 0) {
+    return;
+  }
+  args->imu_sample.read(&sample);
+  tele_store_begin();
+  tele_store_set_f(CID_ACCEL_X, sample.accel.x);
+  tele_store_set_f(CID_ACCEL_Y, sample.accel.y);
+  tele_store_set_f(CID_ACCEL_Z, sample.accel.z);
+  tele_store_set_f(CID_PITCH, sample.euler.pitch);
+  tele_store_set_f(CID_ROLL, sample.euler.roll);
+  tele_store_set_f(CID_YAW, sample.euler.heading);
+  tele_store_end();
+}
+
+void tele_collect_temp(const void *targs) {
+  thread_args_t * args = (thread_args_t *) targs;
+  bno055_sample_t sample;
+
+  if (args->imu_sample.sequence() == 0) {
+    return;
+  }
+  args->imu_sample.read(&sample);
+  tele_store_set_i(CID_AMBIENT_TEMP, sample.temp);
+}
+#endif
+
+void tele_collect_arm_status(const void *targs) {
+  thread_args_t * args = (thread_args_t *) targs;
+
+  tele_store_set_i(CID_ARM_STATUS, args->state);
+}
+
+void tele_collect_rx_age(const void *targs) {
+  thread_args_t * args = (thread_args_t *) targs;
+
+  tele_store_begin();
+  tele_store_set_i(CID_WEAPON_RX_AGE, rc_capture_max_age_us(&args->receiver[0]));
+  tele_store_set_i(CID_DRIVE_RX_AGE, rc_capture_max_age_us(&args->receiver[1]));
+  tele_store_end();
+}
+
+void tele_collect_failsafe(const void *targs) {
+  tele_store_set_i(CID_FAILSAFE_LATENCY, failsafe_worst_latency_us());
+}
+
+void tele_collect_orientation(const void *targs) {
+  thread_args_t * args = (thread_args_t *) targs;
+
+  tele_store_begin();
+  tele_store_set_b(CID_INVERTED, args->inverted);
+  tele_store_set_i(CID_FLIP_LATENCY, args->flip_latency_us);
+  tele_store_end();
+}
+
+void tele_collect_cpu(const void *targs) {
+  // Kept off the stack. Usage is sent over the time since the last collection.
+  static cpu_usage_t usage, previous;
+  uint64_t elapsed;
+  uint32_t misses = 0;
+  unsigned i;
+
+  cpu_monitor_read(&usage);
+  elapsed = usage.elapsed - previous.elapsed;
+  for (i = 0; i < usage.num_tasks; i++) {
+    misses += usage.tasks[i].misses;
+  }
+
+  tele_store_begin();
+  tele_store_set_f(CID_CPU_IDLE, cpu_usage_percent(usage.idle - previous.idle, elapsed));
+#ifdef TASK_MOTOR_DRIVE
+  tele_store_set_f(CID_CPU_MOTOR_DRIVE, cpu_usage_percent(
+    usage.tasks[TASK_MOTOR_DRIVE_ID].busy - previous.tasks[TASK_MOTOR_DRIVE_ID].busy, elapsed));
+  tele_store_set_i(CID_MOTOR_DRIVE_WORST_RUN, cpu_monitor_us(usage.tasks[TASK_MOTOR_DRIVE_ID].worst_run));
+#endif
+  tele_store_set_i(CID_DEADLINE_MISSES, misses);
+  tele_store_end();
+
+  memcpy(&previous, &usage, sizeof(cpu_usage_t));
+}
@@ -0,0 +1,97 @@
+/* Copyright (c) 2017 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file tele_params.cpp
+ * @author Cameron A. Craig
+ * @date 30 May 2017
+ * @copyright 2017 Cameron A. Craig
+ * @brief Defines the telemetry parameters.
+ */
+
+#include <stddef.h>
+#include "tele_params.h"
+#include "tele_collectors.h"
+
+tele_command_t tele_commands[NUM_TELE_COMMANDS] = {
+  {.id = CID_DRIVE_RPM_1, .name = "drive_rpm_1", .unit = CU_RPM, .type = CT_FLOAT, .deadband = 10.0f,
+    .group = TG_DRIVE_RPM, .period_ms = 100, .collect = tele_collect_drive_rpm},
+  {.id = CID_DRIVE_RPM_2, .name = "drive_rpm_2", .unit = CU_RPM, .type = CT_FLOAT, .deadband = 10.0f,
+    .group = TG_DRIVE_RPM, .period_ms = 100, .collect = tele_collect_drive_rpm},
+  {.id = CID_DRIVE_RPM_3, .name = "drive_rpm_3", .unit = CU_RPM, .type = CT_FLOAT, .deadband = 10.0f,
+    .group = TG_DRIVE_RPM, .period_ms = 100, .collect = tele_collect_drive_rpm},
+  {.id = CID_WEAPON_RPM_1, .name = "weapon_rpm_1", .unit = CU_RPM, .type = CT_FLOAT, .deadband = 10.0f,
+    .group = TG_WEAPON_RPM, .period_ms = 100, .collect = tele_collect_weapon_rpm},
+  {.id = CID_WEAPON_RPM_2, .name = "weapon_rpm_2", .unit = CU_RPM, .type = CT_FLOAT, .deadband = 10.0f,
+    .group = TG_WEAPON_RPM, .period_ms = 100, .collect = tele_collect_weapon_rpm},
+  {.id = CID_WEAPON_RPM_3, .name = "weapon_rpm_3", .unit = CU_RPM, .type = CT_FLOAT, .deadband = 10.0f,
+    .group = TG_WEAPON_RPM, .period_ms = 100, .collect = tele_collect_weapon_rpm},
+#ifdef DEVICE_BNO055
+  {.id = CID_ACCEL_X, .name = "accel_x", .unit = CU_MPSPS, .type = CT_FLOAT, .deadband = 0.1f,
+    .group = TG_IMU, .period_ms = 20, .collect = tele_collect_imu},
+  {.id = CID_ACCEL_Y, .name = "accel_y", .unit = CU_MPSPS, .type = CT_FLOAT, .deadband = 0.1f,
+    .group = TG_IMU, .period_ms = 20, .collect = tele_collect_imu},
+  {.id = CID_ACCEL_Z, .name = "accel_z", .unit = CU_MPSPS, .type = CT_FLOAT, .deadband = 0.1f,
+    .group = TG_IMU, .period_ms = 20, .collect = tele_collect_imu},
+  {.id = CID_PITCH, .name = "pitch", .unit = CU_DEGREES, .type = CT_FLOAT, .deadband = 0.5f,
+    .group = TG_IMU, .period_ms = 20, .collect = tele_collect_imu},
+  {.id = CID_ROLL, .name = "roll", .unit = CU_DEGREES, .type = CT_FLOAT, .deadband = 0.5f,
+    .group = TG_IMU, .period_ms = 20, .collect = tele_collect_imu},
+  {.id = CID_YAW, .name = "yaw", .unit = CU_DEGREES, .type = CT_FLOAT, .deadband = 0.5f,
+    .group = TG_IMU, .period_ms = 20, .collect = tele_collect_imu},
+  {.id = CID_AMBIENT_TEMP, .name = "temp", .unit = CU_CELCIUS, .type = CT_INT, .deadband = 1.0f,
+    .group = TG_TEMP, .period_ms = 5000, .collect = tele_collect_temp},
+  /* Heading lock gains, set by the user rather than collected */
+  {.id = CID_HEADING_KP, .name = "heading_kp", .unit = CU_NONE, .type = CT_FLOAT, .deadband = 0.0f,
+    .group = TG_HEADING_LOCK, .period_ms = 1000, .collect = NULL, .param = {.f = HEADING_LOCK_KP}},
+  {.id = CID_HEADING_KI, .name = "heading_ki", .unit = CU_NONE, .type = CT_FLOAT, .deadband = 0.0f,
+    .group = TG_HEADING_LOCK, .period_ms = 1000, .collect = NULL, .param = {.f = HEADING_LOCK_KI}},
+  {.id = CID_HEADING_KD, .name = "heading_kd", .unit = CU_NONE, .type = CT_FLOAT, .deadband = 0.0f,
+    .group = TG_HEADING_LOCK, .period_ms = 1000, .collect = NULL, .param = {.f = HEADING_LOCK_KD}},
+#endif
+  {.id = CID_WEAPON_VOLTAGE_1, .name = "weapon_voltage_1", .unit = CU_VOLTS, .type = CT_FLOAT, .deadband = 0.05f,
+    .group = TG_VOLTAGE, .period_ms = 1000, .collect = NULL},
+  {.id = CID_WEAPON_VOLTAGE_2, .name = "weapon_voltage_2", .unit = CU_VOLTS, .type = CT_FLOAT, .deadband = 0.05f,
+    .group = TG_VOLTAGE, .period_ms = 1000, .collect = NULL},
+  {.id = CID_WEAPON_VOLTAGE_3, .name = "weapon_voltage_3", .unit = CU_VOLTS, .type = CT_FLOAT, .deadband = 0.05f,
+    .group = TG_VOLTAGE, .period_ms = 1000, .collect = NULL},
+  {.id = CID_DRIVE_VOLTAGE_1, .name = "drive_voltage_1", .unit = CU_VOLTS, .type = CT_FLOAT, .deadband = 0.05f,
+    .group = TG_VOLTAGE, .period_ms = 1000, .collect = NULL},
+  {.id = CID_DRIVE_VOLTAGE_2, .name = "drive_voltage_2", .unit = CU_VOLTS, .type = CT_FLOAT, .deadband = 0.05f,
+    .group = TG_VOLTAGE, .period_ms = 1000, .collect = NULL},
+  {.id = CID_DRIVE_VOLTAGE_3, .name = "drive_voltage_3", .unit = CU_VOLTS, .type = CT_FLOAT, .deadband = 0.05f,
+    .group = TG_VOLTAGE, .period_ms = 1000, .collect = NULL},
+  {.id = CID_ARM_STATUS, .name = "arm_status", .unit = CU_NONE, .type = CT_INT, .deadband = 0.0f,
+    .group = TG_ARM_STATUS, .period_ms = 100, .collect = tele_collect_arm_status},
+  {.id = CID_WEAPON_RX_AGE, .name = "weapon_rx_age", .unit = CU_MICROSECONDS, .type = CT_INT, .deadband = 1000.0f,
+    .group = TG_RX_AGE, .period_ms = 100, .collect = tele_collect_rx_age},
+  {.id = CID_DRIVE_RX_AGE, .name = "drive_rx_age", .unit = CU_MICROSECONDS, .type = CT_INT, .deadband = 1000.0f,
+    .group = TG_RX_AGE, .period_ms = 100, .collect = tele_collect_rx_age},
+  {.id = CID_FAILSAFE_LATENCY, .name = "failsafe_latency", .unit = CU_MICROSECONDS, .type = CT_INT, .deadband = 100.0f,
+    .group = TG_FAILSAFE, .period_ms = 1000, .collect = tele_collect_failsafe},
+  {.id = CID_INVERTED, .name = "inverted", .unit = CU_NONE, .type = CT_BOOLEAN, .deadband = 0.0f,
+    .group = TG_ORIENTATION, .period_ms = 100, .collect = tele_collect_orientation},
+  {.id = CID_FLIP_LATENCY, .name = "flip_latency", .unit = CU_MICROSECONDS, .type = CT_INT, .deadband = 100.0f,
+    .group = TG_ORIENTATION, .period_ms = 100, .collect = tele_collect_orientation},
+  {.id = CID_CPU_IDLE, .name = "cpu_idle", .unit = CU_PERCENT, .type = CT_FLOAT, .deadband = 1.0f,
+    .group = TG_CPU, .period_ms = 1000, .collect = tele_collect_cpu},
+  {.id = CID_CPU_MOTOR_DRIVE, .name = "cpu_motor_drive", .unit = CU_PERCENT, .type = CT_FLOAT, .deadband = 1.0f,
+    .group = TG_CPU, .period_ms = 1000, .collect = tele_collect_cpu},
+  {.id = CID_MOTOR_DRIVE_WORST_RUN, .name = "motor_drive_worst_run", .unit = CU_MICROSECONDS, .type = CT_INT, .deadband = 10.0f,
+    .group = TG_CPU, .period_ms = 1000, .collect = tele_collect_cpu},
+  {.id = CID_DEADLINE_MISSES, .name = "deadline_misses", .unit = CU_NONE, .type = CT_INT, .deadband = 0.0f,
+    .group = TG_CPU, .period_ms = 1000, .collect = tele_collect_cpu},
+};
@@ -0,0 +1,100 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file tele_store.cpp
+ * @author Cameron A. Craig
+ * @date 8 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Lock-free publication of telemetry values into tele_commands.
+ */
+
+#include <string.h>
+#include "mbed.h"
+#include "rtos.h"
+#include "tele_store.h"
+
+/* Snapshot attempts made back to back before sleeping, to let a preempted
+   lower priority writer finish. */
+#define TELE_STORE_SPIN_RETRIES 3
+
+static volatile uint32_t writes_started;
+static volatile uint32_t writes_finished;
+
+void tele_store_begin(void) {
+  core_util_atomic_incr_u32(&writes_started, 1);
+  // Readers must see the write start before any of its values.
+  __DMB();
+}
+
+void tele_store_end(void) {
+  __DMB();
+  core_util_atomic_incr_u32(&writes_finished, 1);
+}
+
+void tele_store_set_f(tele_command_id_t id, float value) {
+  tele_store_begin();
+  *(volatile float *) &tele_commands[id].param.f = value;
+  tele_store_end();
+}
+
+void tele_store_set_i(tele_command_id_t id, int value) {
+  tele_store_begin();
+  *(volatile int *) &tele_commands[id].param.i = value;
+  tele_store_end();
+}
+
+void tele_store_set_b(tele_command_id_t id, bool value) {
+  tele_store_begin();
+  *(volatile bool *) &tele_commands[id].param.b = value;
+  tele_store_end();
+}
+
+float tele_store_get_f(tele_command_id_t id) {
+  return *(volatile float *) &tele_commands[id].param.f;
+}
+
+int tele_store_get_i(tele_command_id_t id) {
+  return *(volatile int *) &tele_commands[id].param.i;
+}
+
+bool tele_store_get_b(tele_command_id_t id) {
+  return *(volatile bool *) &tele_commands[id].param.b;
+}
+
+uint32_t tele_store_version(void) {
+  return writes_finished;
+}
+
+uint32_t tele_store_snapshot(tele_command_t *params) {
+  uint32_t version;
+  unsigned attempts = 0;
+
+  while (true) {
+    version = writes_finished;
+    __DMB();
+    memcpy(params, tele_commands, sizeof(tele_command_t) * NUM_TELE_COMMANDS);
+    __DMB();
+    // Every write that had started by the end of the copy had also
+    // finished before it began, so nothing changed part way through.
+    if (writes_started == version) {
+      return version;
+    }
+    if (++attempts >= TELE_STORE_SPIN_RETRIES) {
+      Thread::wait(1);
+    }
+  }
+}
@@ -22,8 +22,41 @@
  * @brief Implements thread_args_t initialisation function.
  */
 
+#include <string.h>
 #include "thread_args.h"
 
 void thread_args_init(thread_args_t *args){
   args->active = true;
+#ifdef CONTROL_LOOP_FRAME_SYNC
+  loop_stats_init(&args->motor_loop, RC_FRAME_PERIOD_US);
+#else
+  loop_stats_init(&args->motor_loop, CONTROL_LOOP_PERIOD_US);
+#endif
+  input_filter_init(&args->input_filter, RC_FILTER_STAGES);
+  memset(&args->raw_pulses, 0x00, sizeof(rc_raw_frame_t));
+  blackbox_init(&args->blackbox);
+  memset(&args->command_stats, 0x00, sizeof(command_stats_t));
+  memset(&args->imu_stats, 0x00, sizeof(bno055_stats_t));
+  args->imu_config.mode = BNO055_MODE;
+  args->imu_config.raw_rate_hz = BNO055_RAW_RATE_HZ;
+#ifdef BNO055_INT_PIN
+  args->imu_config.data_ready_int = true;
+#else
+  args->imu_config.data_ready_int = false;
+#endif
+  args->orientation_detected = UPRIGHT;
+  args->orientation_override = ORIENTATION_AUTO;
+  args->inverted = false;
+  args->orientation_changed_us = 0;
+  args->flip_latency_us = 0;
+  args->heading_lock_enabled = false;
+  args->heading_lock = 0;
+  args->heading_lock_speed = HEADING_LOCK_SPEED;
+  args->heading_lock_deadband = HEADING_LOCK_DEADBAND;
+  args->heading_rotation = 0;
+  args->heading_lock_turning = false;
+  heading_pid_reset(&args->heading_pid);
+  loop_stats_init(&args->heading_loop, 1000000 / bno055_data_rate_hz(&args->imu_config));
+  args->command_stats.wait.min_us = 0xFFFFFFFF;
+  args->command_stats.latency.min_us = 0xFFFFFFFF;
 }
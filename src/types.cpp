@@ -30,6 +30,8 @@ const char * orientation_to_str(orientation_t orientation){
       return "upright";
     case INVERTED:
       return "inverted";
+    case ORIENTATION_AUTO:
+      return "auto";
     default:
       return "unknown";
   }
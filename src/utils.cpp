@@ -25,25 +25,12 @@
 #include "utils.h"
 
 bool is_drive_stalled(thread_args_t *args){
-  /* We have averted an extremely dangerous situation by also checking if (stall_time < 0).
-    Confused?  What happens if stallTimer overflows? It becomes negative.
-    If the last known controller positions were in the arming positions,
-    the arming criteria would be met as soon as the stall time overflows.
-    Disaster averted :)
-    */
-
-  int stall_time = args->receiver[1].channel[RC_1_AILERON]->stallTimer.read_ms();
-  return  (stall_time > 200) || (stall_time < 0);
+  /* Every channel must be fresh, the age is measured from a 64 bit clock
+    so it can't wrap and meet the arming criteria. */
+  return rc_capture_max_age_us(&args->receiver[1]) > RC_STALL_TIMEOUT_US;
 }
 
 bool is_weapon_stalled(thread_args_t *args){
-  /* We have averted an extremely dangerous situation by also checking if (stall_time < 0).
-    Confused?  What happens if stallTimer overflows? It becomes negative.
-    If the last known controller positions were in the arming positions,
-    the arming criteria would be met as soon as the stall time overflows.
-    Disaster averted :)
-    */
-
-  int stall_time = args->receiver[0].channel[RC_0_THROTTLE]->stallTimer.read_ms();
-  return  (stall_time > 200) || (stall_time < 0);
+  /* See is_drive_stalled() */
+  return rc_capture_max_age_us(&args->receiver[0]) > RC_STALL_TIMEOUT_US;
 }
@@ -0,0 +1,88 @@
+#!/usr/bin/env python
+# Copyright (c) 2018 Cameron A. Craig, MIT License
+#
+# Converts the output of the "dump" command, captured from the serial
+# console, into CSV. The record layout must match blackbox_record_t in
+# include/blackbox.h.
+#
+# Usage: blackbox_csv.py console.log > match.csv
+
+import struct
+import sys
+
+CONTROLLERS = 2
+CHANNELS = 6
+WHEELS = 4
+WEAPONS = 3
+STATES = ["disarmed", "drive_only", "weapon_only", "fully_armed"]
+FLAG_INVERTED = 0x01
+FLAG_HEADING_LOCK = 0x02
+
+
+def record_format(fixed):
+    pulses = CONTROLLERS * CHANNELS
+    controls = "%d%s" % (pulses, "i" if fixed else "f")
+    return "<I%dHHBB%s3f%dB%dBx" % (pulses, controls, WHEELS, WEAPONS)
+
+
+def header():
+    pulses = CONTROLLERS * CHANNELS
+    columns = ["time_us"]
+    columns += ["width_us_%d_%d" % (c, i) for c in range(CONTROLLERS) for i in range(CHANNELS)]
+    columns += ["fresh_%d_%d" % (c, i) for c in range(CONTROLLERS) for i in range(CHANNELS)]
+    columns += ["channel_%d_%d" % (c, i) for c in range(CONTROLLERS) for i in range(CHANNELS)]
+    columns += ["heading", "pitch", "roll"]
+    columns += ["wheel_%d" % i for i in range(WHEELS)]
+    columns += ["weapon_%d" % i for i in range(WEAPONS)]
+    columns += ["state", "inverted", "heading_lock"]
+    assert len(columns) == 1 + 3 * pulses + 3 + WHEELS + WEAPONS + 3
+    return columns
+
+
+def convert(record, fixed):
+    pulses = CONTROLLERS * CHANNELS
+    time_us = record[0]
+    widths = record[1:1 + pulses]
+    fresh, state, flags = record[1 + pulses:4 + pulses]
+    controls = record[4 + pulses:4 + 2 * pulses]
+    if fixed:
+        controls = [c / 65536.0 for c in controls]
+    rest = record[4 + 2 * pulses:]
+    orientation = rest[0:3]
+    outputs = rest[3:3 + WHEELS + WEAPONS]
+
+    row = [time_us]
+    row += list(widths)
+    row += [(fresh >> i) & 1 for i in range(pulses)]
+    row += ["%.2f" % c for c in controls]
+    row += ["%.2f" % o for o in orientation]
+    row += list(outputs)
+    row += [STATES[state] if state < len(STATES) else state,
+            int(bool(flags & FLAG_INVERTED)), int(bool(flags & FLAG_HEADING_LOCK))]
+    return row
+
+
+def main():
+    source = open(sys.argv[1]) if len(sys.argv) > 1 else sys.stdin
+    layout = None
+    fixed = False
+    out = sys.stdout
+
+    for line in source:
+        words = line.strip().split()
+        # The header is "blackbox <count> <size> <fixed|float>", followed by
+        # the setup in newer captures
+        if len(words) >= 4 and words[0] == "blackbox":
+            fixed = (words[3] == "fixed")
+            layout = struct.Struct(record_format(fixed))
+            if layout.size != int(words[2]):
+                sys.exit("record is %s bytes, expected %d: layout has changed"
+                         % (words[2], layout.size))
+            out.write(",".join(header()) + "\n")
+        elif len(words) == 2 and words[0] == "BB" and layout is not None:
+            record = layout.unpack(bytearray.fromhex(words[1]))
+            out.write(",".join(str(v) for v in convert(record, fixed)) + "\n")
+
+
+if __name__ == "__main__":
+    main()
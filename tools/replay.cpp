@@ -0,0 +1,270 @@
+/* Copyright (c) 2018 Cameron A. Craig, MIT License
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this software
+ * and associated documentation files (the "Software"), to deal in the Software without restriction,
+ * including without limitation the rights to use, copy, modify, merge, publish, distribute,
+ * sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all copies or
+ * substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING
+ * BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM,
+ * DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ *
+ * @file replay.cpp
+ * @author Cameron A. Craig
+ * @date 19 Apr 2018
+ * @copyright 2018 Cameron A. Craig
+ * @brief Host side replay of a trace captured with the "dump" command.
+ *        Runs it through the control pipeline built from src/ and checks
+ *        the result against the trace, or against a golden trace written
+ *        by an earlier run. Exits with 1 if anything differs.
+ *
+ * Built for the host by host/Makefile ("make -C host replay", tools/ is not
+ * part of the firmware), once with float controls into
+ * host/build/float/replay and once with CONTROL_FIXED_POINT into
+ * host/build/fixed/replay. A capture is only replayed by the one matching
+ * the firmware that recorded it.
+ *
+ * The drive and weapon modes, input filter stages and channel limits are
+ * taken from the dump header, or the firmware defaults for a capture
+ * without them. -m overrides the drive mode.
+ *
+ * Usage: replay [-m drive_mode] [-g golden.log] [-o out.log] trace.log
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "replay.h"
+#include "drive_modes.h"
+
+/* Controls of this build, as written in the dump header */
+#ifdef CONTROL_FIXED_POINT
+#define REPLAY_CONTROLS "fixed"
+#else
+#define REPLAY_CONTROLS "float"
+#endif
+
+/* Calibrated limits the robot starts with, see main.cpp */
+static const channel_limits_t default_limits[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS] = {
+  {
+    {RC_0_CHAN_1_MIN, RC_0_CHAN_1_MAX}, {RC_0_CHAN_2_MIN, RC_0_CHAN_2_MAX},
+    {RC_0_CHAN_3_MIN, RC_0_CHAN_3_MAX}, {RC_0_CHAN_4_MIN, RC_0_CHAN_4_MAX},
+    {RC_0_CHAN_5_MIN, RC_0_CHAN_5_MAX}, {RC_0_CHAN_6_MIN, RC_0_CHAN_6_MAX}
+  },
+  {
+    {RC_1_CHAN_1_MIN, RC_1_CHAN_1_MAX}, {RC_1_CHAN_2_MIN, RC_1_CHAN_2_MAX},
+    {RC_1_CHAN_3_MIN, RC_1_CHAN_3_MAX}, {RC_1_CHAN_4_MIN, RC_1_CHAN_4_MAX},
+    {RC_1_CHAN_5_MIN, RC_1_CHAN_5_MAX}, {RC_1_CHAN_6_MIN, RC_1_CHAN_6_MAX}
+  }
+};
+
+/* How the robot was set up when the trace was recorded */
+typedef struct {
+  /*! "fixed" or "float", empty for a capture without a header. */
+  char controls[8];
+  int drive_mode;
+  int weapon_mode;
+  uint32_t stages;
+  channel_limits_t limits[RC_NUMBER_CONTROLLERS][RC_NUMBER_CHANNELS];
+} trace_setup_t;
+
+/* Read a "blackbox <count> <size> <fixed|float> <drive> <weapon> <stages>"
+   header or a "limits <controller> <min> <max>..." line into setup */
+static void parse_setup(const char *line, trace_setup_t *setup) {
+  const char *words;
+  char controls[8];
+  int drive, weapon, controller, channel, used;
+  unsigned stages;
+  float min, max;
+
+  if ((words = strstr(line, "blackbox ")) != NULL) {
+    if (sscanf(words, "blackbox %*d %*d %7s %d %d %u", controls, &drive, &weapon, &stages) == 4) {
+      strcpy(setup->controls, controls);
+      setup->drive_mode = drive;
+      setup->weapon_mode = weapon;
+      setup->stages = stages;
+    }
+  } else if ((words = strstr(line, "limits ")) != NULL) {
+    if (sscanf(words, "limits %d%n", &controller, &used) != 1 ||
+        controller < 0 || controller >= RC_NUMBER_CONTROLLERS) {
+      return;
+    }
+    words += used;
+    for (channel = 0; channel < RC_NUMBER_CHANNELS; channel++) {
+      if (sscanf(words, "%f %f%n", &min, &max, &used) != 2) {
+        break;
+      }
+      setup->limits[controller][channel].min = min;
+      setup->limits[controller][channel].max = max;
+      words += used;
+    }
+  }
+}
+
+static int hex_value(char c) {
+  if (c >= '0' && c <= '9') {
+    return c - '0';
+  }
+  if (c >= 'a' && c <= 'f') {
+    return c - 'a' + 10;
+  }
+  return -1;
+}
+
+/* Read every "BB <hex>" line of a console capture, and the setup from its
+   header if setup is not NULL */
+static bool load_trace(const char *path, std::vector<blackbox_record_t> *records,
+    trace_setup_t *setup) {
+  char line[512];
+  blackbox_record_t record;
+  uint8_t *bytes = (uint8_t *) &record;
+  const char *hex;
+  unsigned j;
+  FILE *file;
+
+  if ((file = fopen(path, "r")) == NULL) {
+    fprintf(stderr, "Can't open %s\n", path);
+    return false;
+  }
+  while (fgets(line, sizeof(line), file) != NULL) {
+    if ((hex = strstr(line, "BB ")) == NULL) {
+      if (setup) {
+        parse_setup(line, setup);
+      }
+      continue;
+    }
+    hex += 3;
+    for (j = 0; j < sizeof(blackbox_record_t); j++) {
+      if (hex_value(hex[2 * j]) < 0 || hex_value(hex[2 * j + 1]) < 0) {
+        break;
+      }
+      bytes[j] = (uint8_t) ((hex_value(hex[2 * j]) << 4) | hex_value(hex[2 * j + 1]));
+    }
+    if (j != sizeof(blackbox_record_t)) {
+      fprintf(stderr, "%s: record is not %u bytes, the layout has changed\n",
+        path, (unsigned) sizeof(blackbox_record_t));
+      fclose(file);
+      return false;
+    }
+    records->push_back(record);
+  }
+  fclose(file);
+  return true;
+}
+
+static void write_record(FILE *file, const blackbox_record_t *record) {
+  const uint8_t *bytes = (const uint8_t *) record;
+  unsigned j;
+
+  fprintf(file, "BB ");
+  for (j = 0; j < sizeof(blackbox_record_t); j++) {
+    fprintf(file, "%02x", bytes[j]);
+  }
+  fprintf(file, "\n");
+}
+
+static bool same_result(const blackbox_record_t *a, const blackbox_record_t *b) {
+  return memcmp(a->controls, b->controls, sizeof(a->controls)) == 0 &&
+    memcmp(a->wheel, b->wheel, sizeof(a->wheel)) == 0 &&
+    memcmp(a->weapon, b->weapon, sizeof(a->weapon)) == 0 &&
+    a->state == b->state;
+}
+
+int main(int argc, char *argv[]) {
+  static replay_t replay;
+  std::vector<blackbox_record_t> trace, golden;
+  blackbox_record_t result;
+  const char *golden_path = NULL, *out_path = NULL, *trace_path = NULL;
+  trace_setup_t setup;
+  int mode = -1;
+  int golden_mismatches = 0;
+  FILE *out = NULL;
+  size_t i;
+  int arg;
+
+  for (arg = 1; arg < argc; arg++) {
+    if (strcmp(argv[arg], "-m") == 0 && arg + 1 < argc) {
+      mode = atoi(argv[++arg]);
+    } else if (strcmp(argv[arg], "-g") == 0 && arg + 1 < argc) {
+      golden_path = argv[++arg];
+    } else if (strcmp(argv[arg], "-o") == 0 && arg + 1 < argc) {
+      out_path = argv[++arg];
+    } else {
+      trace_path = argv[arg];
+    }
+  }
+  if (trace_path == NULL) {
+    fprintf(stderr, "Usage: %s [-m drive_mode] [-g golden.log] [-o out.log] trace.log\n", argv[0]);
+    return 2;
+  }
+
+  setup.controls[0] = '\0';
+  setup.drive_mode = DM_2_WHEEL_DIFFERENTIAL;
+  setup.weapon_mode = WM_MANUAL_THROTTLE;
+  setup.stages = RC_FILTER_STAGES;
+  memcpy(setup.limits, default_limits, sizeof(setup.limits));
+  if (!load_trace(trace_path, &trace, &setup) ||
+      (golden_path && !load_trace(golden_path, &golden, NULL))) {
+    return 2;
+  }
+  if (setup.controls[0] != '\0' && strcmp(setup.controls, REPLAY_CONTROLS) != 0) {
+    fprintf(stderr, "%s was recorded with %s controls, replay it with build/%s/replay\n",
+      trace_path, setup.controls, setup.controls);
+    return 2;
+  }
+  if (mode >= 0) {
+    setup.drive_mode = mode;
+  }
+  if (setup.drive_mode < 0 ||
+      setup.drive_mode >= (int) (sizeof(drive_modes) / sizeof(drive_mode_t)) ||
+      setup.weapon_mode < 0 ||
+      setup.weapon_mode >= (int) (sizeof(weapon_modes) / sizeof(weapon_mode_t))) {
+    fprintf(stderr, "No drive mode %d or weapon mode %d\n", setup.drive_mode, setup.weapon_mode);
+    return 2;
+  }
+  if (golden_path && golden.size() != trace.size()) {
+    fprintf(stderr, "%s has %u records, the trace has %u\n", golden_path,
+      (unsigned) golden.size(), (unsigned) trace.size());
+    return 2;
+  }
+  if (out_path && (out = fopen(out_path, "w")) == NULL) {
+    fprintf(stderr, "Can't open %s\n", out_path);
+    return 2;
+  }
+
+  replay_init(&replay, setup.limits, (const drive_mode_t *) &drive_modes[setup.drive_mode],
+    (const weapon_mode_t *) &weapon_modes[setup.weapon_mode], setup.stages);
+  for (i = 0; i < trace.size(); i++) {
+    replay_cycle(&replay, &trace[i], &result);
+    if (golden_path && !same_result(&result, &golden[i])) {
+      if (golden_mismatches++ == 0) {
+        printf("first difference from golden at record %u\n", (unsigned) i);
+      }
+    }
+    if (out) {
+      write_record(out, &result);
+    }
+  }
+  if (out) {
+    fclose(out);
+  }
+
+  printf("replayed %u cycles (%u ms recorded)\n", replay.stats.cycles,
+    trace.empty() ? 0 : (unsigned) ((trace.back().time_us - trace.front().time_us) / 1000));
+  if (golden_path) {
+    printf("differences from golden: %d\n", golden_mismatches);
+    return golden_mismatches ? 1 : 0;
+  }
+  printf("compared: %u, unverified: %u\n", replay.stats.compared, replay.stats.unverified);
+  printf("mismatched controls: %u, outputs: %u, state: %u, first: %d\n",
+    replay.stats.control_mismatches, replay.stats.output_mismatches,
+    replay.stats.state_mismatches, replay.stats.first_mismatch);
+  return (replay.stats.first_mismatch < 0) ? 0 : 1;
+}
@@ -3,7 +3,8 @@
 # Author: Cameron A. Craig
 # Copyright: 2017 Cameron A. Craig
 # Description:
-#    Make targets for code style checking and static analysis.
+#    Make targets for code style checking, static analysis and the host
+#    tests (see host/Makefile).
 #    Designed for use on continuous integration servers.
 
 STYLE_CHECK_PATH=../nsiqcppstyle/nsiqcppstyle
@@ -16,7 +17,9 @@ STATIC_CHECK_INC_DIR=include/
 STATIC_CHECK_SRC_DIR=src/
 STATIC_CHECK_REPORT_DIR=static.txt
 
-ci: check_style check_static
+HOST_DIR=host
+
+ci: check_style check_static check_host
 
 check_style:
 	@echo "Starting style checker...\r\n"
@@ -25,3 +28,10 @@ check_style:
 check_static:
 	@echo "Starting static analysis...\r\n"
 	$(STATIC_CHECK_PATH) $(STATIC_CHECK_SRC_DIR) -I $(STATIC_CHECK_INC_DIR) 2> $(STATIC_CHECK_REPORT_DIR) --error-exitcode=1
+
+check_host:
+	@echo "Starting host tests...\r\n"
+	$(MAKE) -C $(HOST_DIR) test
+
+bench_host:
+	$(MAKE) -C $(HOST_DIR) bench